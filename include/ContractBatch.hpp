@@ -0,0 +1,204 @@
+#ifndef __BTAS_CONTRACT_BATCH_HPP
+#define __BTAS_CONTRACT_BATCH_HPP
+
+#include <vector>
+#include <map>
+#include <utility> // std::make_pair
+#include <algorithm> // std::equal
+
+#include <BTAS_assert.h>
+#include <blas.h>
+#include <parallel.h>
+#include <Tensor.hpp>
+#include <ContractPlan.hpp>
+#include <Workspace.hpp>
+
+namespace btas {
+
+/// Item of contract_batch, c = alpha * a * b + beta * c
+/// NOTE: tensors are referred by pointers, which must be valid until contract_batch returns
+template<typename T, size_t L, size_t M, size_t N, CBLAS_LAYOUT Layout = CblasRowMajor>
+struct contract_batch_item {
+
+  T alpha;
+
+  const TensorBase<T,L,Layout>* a;
+
+  const TensorBase<T,M,Layout>* b;
+
+  T beta;
+
+  Tensor<T,N,Layout>* c;
+
+  contract_batch_item (
+    const T& alpha_,
+    const TensorBase<T,L,Layout>& a_,
+    const TensorBase<T,M,Layout>& b_,
+    const T& beta_,
+          Tensor<T,N,Layout>& c_)
+  : alpha(alpha_), a(&a_), b(&b_), beta(beta_), c(&c_)
+  { }
+
+};
+
+namespace detail {
+
+/// group of GEMMs passed to gemm_batch, which share a plan, alpha and beta
+template<typename T>
+struct __contract_batch_group {
+  size_t plan;
+  T alpha;
+  T beta;
+  std::vector<size_t> items;
+};
+
+} // namespace detail
+
+/// contract a list of tensors with the same index symbols, c[i] = alpha[i] * a[i] * b[i] + beta[i] * c[i]
+/// this is aimed at many small contractions (e.g. blocks of block-sparse tensors), for which overheads of each call dominate:
+/// 1) items are grouped by extents of a and b, and each group is analyzed only once by ContractPlan,
+/// 2) a and b are permuted if needed, in parallel over items,
+/// 3) GEMMs of all items are carried out by a single call of gemm_batch (cblas_?gemm_batch w/ Intel MKL),
+///    which has one group for each of (extents, alpha, beta), or by a GEMM loop split over OpenMP threads otherwise,
+/// 4) a*b is permuted into c if needed, in parallel over items.
+/// Items for which the plan chooses a strided batch of GEMMs are contracted by the plan in parallel over items.
+/// c is initialized if empty, as in contract().
+template<typename T, size_t L, size_t M, size_t N, CBLAS_LAYOUT Layout, class SymbolA, class SymbolB, class SymbolC>
+void contract_batch (
+  const std::vector<contract_batch_item<T,L,M,N,Layout>>& items,
+  const SymbolA& symba, const SymbolB& symbb, const SymbolC& symbc)
+{
+  typedef ContractPlan<T,L,M,N,Layout> plan_type;
+  typedef std::pair<typename plan_type::extent_type_a,typename plan_type::extent_type_b> key_type;
+
+  const size_t nitems = items.size();
+  if(nitems == 0) return;
+
+  // analyze each shape once
+  std::map<key_type,size_t> plan_map;
+  std::vector<plan_type> plans;
+  std::vector<size_t> item_plan(nitems);
+  std::vector<size_t> item_work(nitems+1,0);
+  size_t total = 0;
+
+  for(size_t i = 0; i < nitems; ++i) {
+    const contract_batch_item<T,L,M,N,Layout>& item = items[i];
+    key_type key(item.a->extent(),item.b->extent());
+    typename std::map<key_type,size_t>::iterator it = plan_map.find(key);
+    if(it == plan_map.end()) {
+      it = plan_map.insert(std::make_pair(key,plans.size())).first;
+      plans.push_back(plan_type(key.first,symba,key.second,symbb,symbc));
+    }
+    const plan_type& plan = plans[it->second];
+    item_plan[i] = it->second;
+
+    if(item.c->empty())
+      item.c->resize(plan.extent_c(),static_cast<T>(0));
+    else
+      BTAS_assert(std::equal(plan.extent_c().begin(),plan.extent_c().end(),item.c->extent().begin()),"contract_batch, detected inconsistent extents (a*b vs c).");
+
+    item_work[i+1] = item_work[i]+plan.workspace_size();
+    total += item.a->size()+item.b->size()+item.c->size();
+  }
+
+  // temporaries of all items are taken from the workspace of the calling thread
+  Workspace::Scope scope;
+  T* work = scope.allocate<T>(item_work[nitems]);
+
+  // group GEMMs by (plan, alpha, beta), beta is 0 if a*b is written to workspace
+  std::vector<detail::__contract_batch_group<T>> groups;
+  std::vector<std::vector<size_t>> plan_groups(plans.size());
+  for(size_t i = 0; i < nitems; ++i) {
+    const plan_type& plan = plans[item_plan[i]];
+    if(plan.is_batched()) continue;
+
+    const T betac = plan.is_c_permuted() ? static_cast<T>(0) : items[i].beta;
+    std::vector<size_t>& pg = plan_groups[item_plan[i]];
+    size_t g = 0;
+    for(; g < pg.size(); ++g)
+      if(groups[pg[g]].alpha == items[i].alpha && groups[pg[g]].beta == betac) break;
+    if(g == pg.size()) {
+      pg.push_back(groups.size());
+      groups.push_back(detail::__contract_batch_group<T>());
+      groups.back().plan = item_plan[i];
+      groups.back().alpha = items[i].alpha;
+      groups.back().beta = betac;
+    }
+    groups[pg[g]].items.push_back(i);
+  }
+
+  const bool is_parallel = (nitems > 1 && total >= _BTAS_PERMUTE_PARALLEL_THRESHOLD && detail::__max_threads() > 1);
+
+  // permute a and b, and contract items of strided batch
+  std::vector<const T*> pa(nitems);
+  std::vector<const T*> pb(nitems);
+  std::vector<T*> pc(nitems);
+
+#ifdef _OPENMP
+#pragma omp parallel if(is_parallel)
+#endif
+  {
+    size_t first = 0;
+    size_t last  = nitems;
+    if(is_parallel) detail::__thread_range(nitems,first,last);
+
+    for(size_t i = first; i < last; ++i) {
+      const contract_batch_item<T,L,M,N,Layout>& item = items[i];
+      const plan_type& plan = plans[item_plan[i]];
+      if(plan.is_batched())
+        plan.execute(item.alpha,*item.a,*item.b,item.beta,*item.c,work+item_work[i]);
+      else
+        plan.prepare(item.a->data(),item.b->data(),item.c->data(),work+item_work[i],pa[i],pb[i],pc[i]);
+    }
+  }
+
+  // GEMMs of all groups
+  const size_t ngroups = groups.size();
+  if(ngroups > 0) {
+    std::vector<CBLAS_TRANSPOSE> transx(ngroups);
+    std::vector<CBLAS_TRANSPOSE> transy(ngroups);
+    std::vector<size_t> m(ngroups), n(ngroups), k(ngroups);
+    std::vector<size_t> ldx(ngroups), ldy(ngroups), ldc(ngroups);
+    std::vector<T> alpha(ngroups), beta(ngroups);
+    std::vector<size_t> gsize(ngroups);
+    std::vector<const T*> px;
+    std::vector<const T*> py;
+    std::vector<T*> pz;
+    for(size_t g = 0; g < ngroups; ++g) {
+      const contract_gemm args = plans[groups[g].plan].gemm_args();
+      transx[g] = args.transx; transy[g] = args.transy;
+      m[g] = args.m; n[g] = args.n; k[g] = args.k;
+      ldx[g] = args.ldx; ldy[g] = args.ldy; ldc[g] = args.ldc;
+      alpha[g] = groups[g].alpha;
+      beta[g] = groups[g].beta;
+      gsize[g] = groups[g].items.size();
+      for(size_t j = 0; j < gsize[g]; ++j) {
+        const size_t i = groups[g].items[j];
+        px.push_back(args.is_swapped ? pb[i] : pa[i]);
+        py.push_back(args.is_swapped ? pa[i] : pb[i]);
+        pz.push_back(pc[i]);
+      }
+    }
+    gemm_batch(Layout,transx.data(),transy.data(),m.data(),n.data(),k.data(),alpha.data(),px.data(),ldx.data(),py.data(),ldy.data(),
+               beta.data(),pz.data(),ldc.data(),ngroups,gsize.data());
+  }
+
+  // permute a*b into c
+#ifdef _OPENMP
+#pragma omp parallel if(is_parallel)
+#endif
+  {
+    size_t first = 0;
+    size_t last  = nitems;
+    if(is_parallel) detail::__thread_range(nitems,first,last);
+
+    for(size_t i = first; i < last; ++i) {
+      const plan_type& plan = plans[item_plan[i]];
+      if(!plan.is_batched()) plan.finalize(pc[i],items[i].beta,items[i].c->data());
+    }
+  }
+}
+
+} // namespace btas
+
+#endif // __BTAS_CONTRACT_BATCH_HPP
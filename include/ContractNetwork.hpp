@@ -0,0 +1,594 @@
+#ifndef __BTAS_CONTRACT_NETWORK_HPP
+#define __BTAS_CONTRACT_NETWORK_HPP
+
+#include <vector>
+#include <map>
+#include <limits>
+#include <utility> // std::pair, std::swap
+#include <ostream>
+#include <algorithm> // std::find, std::equal
+
+#include <BTAS_assert.h>
+#include <blas.h>
+#include <make_array.hpp>
+#include <Tensor.hpp>
+#include <PermutePlan.hpp>
+#include <contract_helper.hpp>
+
+// networks up to this number of tensors are contracted in the optimal order found by exhaustive search,
+// the order is determined by greedy search for larger networks
+#ifndef _BTAS_NETWORK_EXHAUSTIVE_MAX
+#define _BTAS_NETWORK_EXHAUSTIVE_MAX 6
+#endif
+
+namespace btas {
+
+/// Order of pairwise contractions of a tensor network
+/// Each step takes the i-th and the j-th tensors from the working list, and appends the result to the end,
+/// i.e. the working list starts with the input tensors and ends up with the output tensor.
+/// Memory estimates count elements of intermediates (and the output), but not of the input tensors.
+struct contract_path {
+
+  std::vector<std::pair<size_t,size_t>> steps; ///< pairs of positions in the working list
+
+  double flops; ///< estimated number of floating-point operations
+
+  size_t peak_size; ///< estimated peak number of elements held by intermediates
+
+  size_t max_size; ///< number of elements of the largest intermediate
+
+  bool is_optimal; ///< true if found by exhaustive search
+
+  contract_path () : flops(0.0), peak_size(0), max_size(0), is_optimal(true) { }
+
+};
+
+/// print the contraction path
+inline std::ostream& operator<< (std::ostream& ost, const contract_path& path)
+{
+  for(size_t i = 0; i < path.steps.size(); ++i)
+    ost << "(" << path.steps[i].first << "," << path.steps[i].second << ") ";
+  ost << "flops " << path.flops << ", peak " << path.peak_size << " elements"
+      << (path.is_optimal ? " [exhaustive]" : " [greedy]");
+  return ost;
+}
+
+/// Tensor operand of contract_network, which is implicitly converted from any rank of tensor
+template<typename T, CBLAS_LAYOUT Layout = CblasRowMajor>
+class network_operand {
+
+public:
+
+  /// wrap a tensor (shallow)
+  template<size_t N>
+  network_operand (const TensorBase<T,N,Layout>& x)
+  : data_(x.data()), ext_(x.extent().begin(),x.extent().end())
+  { }
+
+  const T* data () const { return data_; }
+
+  const std::vector<size_t>& extent () const { return ext_; }
+
+private:
+
+  const T* data_;
+
+  std::vector<size_t> ext_;
+
+}; // class network_operand<T,Layout>
+
+namespace detail {
+
+/// Symbols of a tensor network encoded as integers
+struct __network_info {
+
+  std::vector<std::vector<size_t>> symbs; ///< encoded symbols of each input
+
+  std::vector<size_t> symbc; ///< encoded symbols of output
+
+  std::vector<size_t> ext; ///< extent of each symbol
+
+  std::vector<size_t> count; ///< number of tensors having each symbol (incl. output)
+
+};
+
+/// encode symbols and check consistency of the network
+template<class Symbol, class SymbolC>
+void __make_network_info (
+  const std::vector<std::vector<size_t>>& exts,
+  const std::vector<std::vector<Symbol>>& symbs,
+  const SymbolC& symbc, __network_info& info)
+{
+  BTAS_assert(exts.size() == symbs.size() && !exts.empty(),"contract_network, detected inconsistent number of tensors and symbols.");
+
+  std::map<Symbol,size_t> code;
+
+  info.symbs.resize(symbs.size());
+  info.ext.clear();
+  info.count.clear();
+
+  for(size_t t = 0; t < symbs.size(); ++t) {
+    BTAS_assert(exts[t].size() == symbs[t].size(),"contract_network, detected inconsistent rank of tensor and symbols.");
+    info.symbs[t].resize(symbs[t].size());
+    for(size_t i = 0; i < symbs[t].size(); ++i) {
+      typename std::map<Symbol,size_t>::iterator it = code.find(symbs[t][i]);
+      if(it == code.end()) {
+        it = code.insert(std::make_pair(symbs[t][i],info.ext.size())).first;
+        info.ext.push_back(exts[t][i]);
+        info.count.push_back(0);
+      }
+      BTAS_assert(info.ext[it->second] == exts[t][i],"contract_network, detected inconsistent extents of the same symbol.");
+      BTAS_assert(std::find(info.symbs[t].begin(),info.symbs[t].begin()+i,it->second) == info.symbs[t].begin()+i,"contract_network, detected duplicate symbols in a tensor (trace is not supported).");
+      info.symbs[t][i] = it->second;
+      ++info.count[it->second];
+    }
+  }
+
+  info.symbc.clear();
+  for(typename SymbolC::const_iterator ic = symbc.begin(); ic != symbc.end(); ++ic) {
+    typename std::map<Symbol,size_t>::iterator it = code.find(*ic);
+    BTAS_assert(it != code.end(),"contract_network, detected output symbol not found in input tensors.");
+    BTAS_assert(std::find(info.symbc.begin(),info.symbc.end(),it->second) == info.symbc.end(),"contract_network, detected duplicate symbols in output.");
+    info.symbc.push_back(it->second);
+    ++info.count[it->second];
+  }
+
+  // each symbol must be shared by exactly two tensors (incl. output), i.e. no Hadamard product nor trace
+  for(size_t s = 0; s < info.count.size(); ++s)
+    BTAS_assert(info.count[s] == 2,"contract_network, every symbol must appear exactly twice in inputs and output.");
+}
+
+/// symbols of a contracted pair: free indices of x followed by free indices of y
+inline void __network_pair_symbols (
+  const std::vector<size_t>& x,
+  const std::vector<size_t>& y,
+        std::vector<size_t>& z)
+{
+  z.clear();
+  for(size_t i = 0; i < x.size(); ++i)
+    if(std::find(y.begin(),y.end(),x[i]) == y.end()) z.push_back(x[i]);
+  for(size_t i = 0; i < y.size(); ++i)
+    if(std::find(x.begin(),x.end(),y[i]) == x.end()) z.push_back(y[i]);
+}
+
+/// number of elements of a tensor having symbols s
+inline double __network_size (const std::vector<size_t>& s, const std::vector<size_t>& ext)
+{
+  double size = 1.0;
+  for(size_t i = 0; i < s.size(); ++i) size *= ext[s[i]];
+  return size;
+}
+
+/// FLOPs to contract x and y, i.e. 2 * product of all extents involved
+inline double __network_flops (const std::vector<size_t>& x, const std::vector<size_t>& y, const std::vector<size_t>& ext)
+{
+  double flops = 2.0*__network_size(x,ext);
+  for(size_t i = 0; i < y.size(); ++i)
+    if(std::find(x.begin(),x.end(),y[i]) == x.end()) flops *= ext[y[i]];
+  return flops;
+}
+
+/// simulate the path to compute FLOPs and memory estimates
+inline void __network_estimate (const __network_info& info, contract_path& path)
+{
+  std::vector<std::vector<size_t>> work(info.symbs);
+  std::vector<bool> is_temp(work.size(),false);
+  std::vector<size_t> z;
+
+  double live = 0.0;
+  double peak = 0.0;
+  double maxs = 0.0;
+
+  path.flops = 0.0;
+  for(size_t s = 0; s < path.steps.size(); ++s) {
+    size_t i = path.steps[s].first;
+    size_t j = path.steps[s].second;
+    __network_pair_symbols(work[i],work[j],z);
+
+    double size = __network_size(z,info.ext);
+    path.flops += __network_flops(work[i],work[j],info.ext);
+    peak = std::max(peak,live+size);
+    maxs = std::max(maxs,size);
+    live += size;
+    if(is_temp[i]) live -= __network_size(work[i],info.ext);
+    if(is_temp[j]) live -= __network_size(work[j],info.ext);
+
+    if(i < j) std::swap(i,j);
+    work.erase(work.begin()+i); is_temp.erase(is_temp.begin()+i);
+    work.erase(work.begin()+j); is_temp.erase(is_temp.begin()+j);
+    work.push_back(z); is_temp.push_back(true);
+  }
+
+  path.peak_size = static_cast<size_t>(peak);
+  path.max_size = static_cast<size_t>(maxs);
+}
+
+/// Partial solution of exhaustive search for a subset of tensors
+struct __network_node {
+  double flops; ///< FLOPs to make this subset
+  double peak; ///< peak memory to make this subset
+  double size; ///< number of elements of the result (0 for an input tensor)
+  size_t first; ///< subset contracted first
+  size_t second; ///< subset contracted second
+  std::vector<size_t> symbs; ///< symbols of the result
+};
+
+/// generate steps in post-order
+inline void __network_post_order (
+  const std::vector<__network_node>& node, size_t set,
+  std::vector<size_t>& work, std::vector<std::pair<size_t,size_t>>& steps)
+{
+  if(node[set].first == 0) return; // input tensor
+
+  __network_post_order(node,node[set].first,work,steps);
+  __network_post_order(node,node[set].second,work,steps);
+
+  size_t i = std::find(work.begin(),work.end(),node[set].first)-work.begin();
+  size_t j = std::find(work.begin(),work.end(),node[set].second)-work.begin();
+  steps.push_back(std::make_pair(i,j));
+
+  if(i < j) std::swap(i,j);
+  work.erase(work.begin()+i);
+  work.erase(work.begin()+j);
+  work.push_back(set);
+}
+
+/// find the optimal path by dynamic programming over subsets of tensors, O(3^n)
+inline bool __network_exhaustive (const __network_info& info, double max_size, contract_path& path)
+{
+  const size_t n = info.symbs.size();
+  const size_t full = (1ul << n)-1;
+  const double inf = std::numeric_limits<double>::max();
+
+  std::vector<__network_node> node(full+1);
+  for(size_t set = 1; set <= full; ++set) node[set].flops = inf;
+
+  for(size_t t = 0; t < n; ++t) {
+    __network_node& leaf = node[1ul << t];
+    leaf.flops = 0.0;
+    leaf.peak = 0.0;
+    leaf.size = 0.0;
+    leaf.first = 0;
+    leaf.second = 0;
+    leaf.symbs = info.symbs[t];
+  }
+
+  // subsets are visited in increasing order, so that any proper subset has been solved
+  std::vector<size_t> z;
+  for(size_t set = 1; set <= full; ++set) {
+    if((set & (set-1)) == 0) continue; // input tensor
+
+    __network_node& best = node[set];
+    const size_t low = set & (~set+1);
+    // enumerate splits s.t. the first subset contains the lowest tensor, to avoid duplicates
+    for(size_t sub = (set-1) & set; sub > 0; sub = (sub-1) & set) {
+      if(!(sub & low)) continue;
+      const __network_node& x = node[sub];
+      const __network_node& y = node[set ^ sub];
+      if(x.flops == inf || y.flops == inf) continue;
+
+      __network_pair_symbols(x.symbs,y.symbs,z);
+
+      double size = __network_size(z,info.ext);
+      double flops = x.flops+y.flops+__network_flops(x.symbs,y.symbs,info.ext);
+      // evaluate the subset requiring more memory first
+      double peak = std::min(std::max(std::max(x.peak,x.size+y.peak),x.size+y.size+size),
+                             std::max(std::max(y.peak,y.size+x.peak),x.size+y.size+size));
+      if(max_size > 0.0 && peak > max_size) continue;
+      if(flops < best.flops || (flops == best.flops && peak < best.peak)) {
+        best.flops = flops;
+        best.peak = peak;
+        best.size = size;
+        if(std::max(x.peak,x.size+y.peak) <= std::max(y.peak,y.size+x.peak)) {
+          best.first = sub;
+          best.second = set ^ sub;
+        }
+        else {
+          best.first = set ^ sub;
+          best.second = sub;
+        }
+        best.symbs = z;
+      }
+    }
+  }
+
+  if(node[full].flops == inf) return false;
+
+  std::vector<size_t> work(n);
+  for(size_t t = 0; t < n; ++t) work[t] = 1ul << t;
+  path.steps.clear();
+  __network_post_order(node,full,work,path.steps);
+  path.is_optimal = true;
+  return true;
+}
+
+/// find a path greedily, contracting the pair which reduces memory the most at each step
+inline bool __network_greedy (const __network_info& info, double max_size, contract_path& path)
+{
+  std::vector<std::vector<size_t>> work(info.symbs);
+  std::vector<double> size(work.size(),0.0); // inputs are not counted
+  std::vector<size_t> z;
+
+  double live = 0.0;
+
+  path.steps.clear();
+  while(work.size() > 1) {
+    const double inf = std::numeric_limits<double>::max();
+    double best_score = inf;
+    double best_flops = inf;
+    size_t bi = 0;
+    size_t bj = 0;
+    // pairs sharing symbols are preferred over outer products
+    for(int pass = 0; pass < 2 && best_score == inf; ++pass) {
+      for(size_t i = 0; i < work.size(); ++i) {
+        for(size_t j = i+1; j < work.size(); ++j) {
+          __network_pair_symbols(work[i],work[j],z);
+          if(pass == 0 && z.size() == work[i].size()+work[j].size()) continue;
+          double zsize = __network_size(z,info.ext);
+          if(max_size > 0.0 && live+zsize > max_size) continue;
+          double score = zsize-__network_size(work[i],info.ext)-__network_size(work[j],info.ext);
+          double flops = __network_flops(work[i],work[j],info.ext);
+          if(score < best_score || (score == best_score && flops < best_flops)) {
+            best_score = score;
+            best_flops = flops;
+            bi = i;
+            bj = j;
+          }
+        }
+      }
+    }
+    if(best_score == inf) return false;
+
+    __network_pair_symbols(work[bi],work[bj],z);
+    path.steps.push_back(std::make_pair(bi,bj));
+    live += __network_size(z,info.ext)-size[bi]-size[bj];
+
+    work.erase(work.begin()+bj); size.erase(size.begin()+bj);
+    work.erase(work.begin()+bi); size.erase(size.begin()+bi);
+    work.push_back(z); size.push_back(__network_size(z,info.ext));
+  }
+
+  path.is_optimal = false;
+  return true;
+}
+
+/// Tensor in the working list of contract_network
+template<typename T>
+struct __network_tensor {
+  const T* data; ///< pointer to data, either of an input tensor or of store
+  std::vector<T> store; ///< storage of an intermediate
+  std::vector<size_t> ext;
+  std::vector<size_t> symbs;
+};
+
+/// return true if symbols of x are given by (f, k) or (k, f)
+/// \param trans set true if (k, f)
+inline bool __network_is_matrix (const std::vector<size_t>& x, const std::vector<size_t>& f, const std::vector<size_t>& k, bool& trans)
+{
+  trans = false;
+  if(std::equal(f.begin(),f.end(),x.begin()) && std::equal(k.begin(),k.end(),x.begin()+f.size())) return true;
+  trans = true;
+  if(std::equal(k.begin(),k.end(),x.begin()) && std::equal(f.begin(),f.end(),x.begin()+k.size())) return true;
+  return false;
+}
+
+/// permute x into the order of symbols s, buf is resized if necessary
+template<typename T, CBLAS_LAYOUT Layout>
+const T* __network_permute (const __network_tensor<T>& x, const std::vector<size_t>& s, std::vector<T>& buf)
+{
+  std::vector<size_t> idx(s.size());
+  for(size_t i = 0; i < s.size(); ++i) idx[i] = std::find(x.symbs.begin(),x.symbs.end(),s[i])-x.symbs.begin();
+  size_t size = 1; for(size_t i = 0; i < x.ext.size(); ++i) size *= x.ext[i];
+  buf.resize(size);
+  PermutePlan<T,0ul,Layout>::get(x.ext,idx).execute(x.data,buf.data());
+  return buf.data();
+}
+
+/// contract a pair of tensors by GEMM (with permutations if necessary), z = alpha * x * y + beta * z
+/// symbols of z are free indices of x followed by free indices of y
+template<typename T, CBLAS_LAYOUT Layout>
+void __network_contract_pair (
+  const T& alpha, const __network_tensor<T>& x, const __network_tensor<T>& y,
+  const T& beta, T* pz, std::vector<T>& bufx, std::vector<T>& bufy)
+{
+  std::vector<size_t> fx, fy, kx, ky;
+  size_t m = 1, n = 1, k = 1;
+  for(size_t i = 0; i < x.symbs.size(); ++i) {
+    if(std::find(y.symbs.begin(),y.symbs.end(),x.symbs[i]) == y.symbs.end()) {
+      fx.push_back(x.symbs[i]); m *= x.ext[i];
+    }
+    else {
+      kx.push_back(x.symbs[i]); k *= x.ext[i];
+    }
+  }
+  for(size_t i = 0; i < y.symbs.size(); ++i) {
+    if(std::find(x.symbs.begin(),x.symbs.end(),y.symbs[i]) == x.symbs.end()) {
+      fy.push_back(y.symbs[i]); n *= y.ext[i];
+    }
+    else {
+      ky.push_back(y.symbs[i]);
+    }
+  }
+
+  // contracted indices are ordered as in x or as in y, whichever requires fewer permutations
+  bool transx, transy;
+  bool is_x_matrix = __network_is_matrix(x.symbs,fx,kx,transx);
+  bool is_y_matrix = __network_is_matrix(y.symbs,fy,kx,transy);
+  const std::vector<size_t>* kp = &kx;
+  if(!(is_x_matrix && is_y_matrix) && kx != ky) {
+    bool tx, ty;
+    bool xm = __network_is_matrix(x.symbs,fx,ky,tx);
+    bool ym = __network_is_matrix(y.symbs,fy,ky,ty);
+    if(xm+ym > is_x_matrix+is_y_matrix) {
+      is_x_matrix = xm; transx = tx;
+      is_y_matrix = ym; transy = ty;
+      kp = &ky;
+    }
+  }
+
+  const T* px = x.data;
+  if(!is_x_matrix) {
+    std::vector<size_t> s(fx); s.insert(s.end(),kp->begin(),kp->end());
+    px = __network_permute<T,Layout>(x,s,bufx);
+    transx = false;
+  }
+  const T* py = y.data;
+  if(!is_y_matrix) {
+    std::vector<size_t> s(*kp); s.insert(s.end(),fy.begin(),fy.end());
+    py = __network_permute<T,Layout>(y,s,bufy);
+    transy = true;
+  }
+
+  // (f, k) is m x k, and (k, f) is k x m in terms of layout; y is regarded as k x n for NoTrans
+  const CBLAS_TRANSPOSE opx = transx ? CblasTrans : CblasNoTrans;
+  const CBLAS_TRANSPOSE opy = transy ? CblasNoTrans : CblasTrans;
+
+  size_t ldx = ((Layout == CblasRowMajor) ^ (opx == CblasNoTrans)) ? m : k;
+  size_t ldy = ((Layout == CblasRowMajor) ^ (opy == CblasNoTrans)) ? k : n;
+  size_t ldz =  (Layout == CblasRowMajor) ? n : m;
+
+  gemm(Layout,opx,opy,m,n,k,alpha,px,ldx,py,ldy,beta,pz,ldz);
+}
+
+} // namespace detail
+
+// ====================================================================================================
+
+/// find the contraction path of a tensor network
+/// \param exts extents of input tensors
+/// \param symbs index symbols of input tensors
+/// \param symbc index symbols of output tensor
+/// \param max_size limit of peak number of elements held by intermediates (0 for no limit)
+/// NOTE: every symbol must appear exactly twice in inputs and output, i.e. Hadamard products and traces are not supported
+template<class Symbol, class SymbolC>
+contract_path make_contract_path (
+  const std::vector<std::vector<size_t>>& exts,
+  const std::vector<std::vector<Symbol>>& symbs,
+  const SymbolC& symbc,
+  size_t max_size = 0)
+{
+  detail::__network_info info;
+  detail::__make_network_info(exts,symbs,symbc,info);
+
+  contract_path path;
+  bool found = (info.symbs.size() <= _BTAS_NETWORK_EXHAUSTIVE_MAX)
+             ? detail::__network_exhaustive(info,static_cast<double>(max_size),path)
+             : detail::__network_greedy    (info,static_cast<double>(max_size),path);
+  BTAS_assert(found,"make_contract_path, no contraction path satisfies the memory limit.");
+
+  detail::__network_estimate(info,path);
+  return path;
+}
+
+/// contract a tensor network along a given path, c = alpha * (a * b * ...) + beta * c
+/// intermediates are released as soon as they are consumed, and their storage is reused for later intermediates
+template<typename T, size_t N, CBLAS_LAYOUT Layout, class SymbolC, class AllocC>
+void contract_network (
+  const T& alpha,
+  const std::vector<network_operand<T,Layout>>& tensors,
+  const std::vector<std::vector<typename SymbolC::value_type>>& symbs,
+  const T& beta,
+        Tensor<T,N,Layout,AllocC>& c, const SymbolC& symbc,
+  const contract_path& path)
+{
+  std::vector<std::vector<size_t>> exts(tensors.size());
+  for(size_t t = 0; t < tensors.size(); ++t) exts[t] = tensors[t].extent();
+
+  detail::__network_info info;
+  detail::__make_network_info(exts,symbs,symbc,info);
+  BTAS_assert(path.steps.size()+1 == tensors.size(),"contract_network, detected inconsistent number of steps in path.");
+
+  std::vector<detail::__network_tensor<T>> work(tensors.size());
+  for(size_t t = 0; t < tensors.size(); ++t) {
+    work[t].data = tensors[t].data();
+    work[t].ext = exts[t];
+    work[t].symbs = info.symbs[t];
+  }
+
+  // storage of released intermediates
+  std::vector<std::vector<T>> pool;
+  std::vector<T> bufx;
+  std::vector<T> bufy;
+
+  // output symbols in the order of c
+  std::vector<size_t> extc(info.symbc.size());
+  for(size_t i = 0; i < info.symbc.size(); ++i) extc[i] = info.ext[info.symbc[i]];
+
+  // extent of c, which is either std::array or std::vector (dynamic rank),
+  // full contraction of dynamic rank is stored in c of extent {1} (see ContractPlan)
+  typename Tensor<T,N,Layout,AllocC>::extent_type extc_;
+  detail::__contract_resize(extc_,(N == 0 && extc.empty()) ? 1ul : extc.size());
+  for(size_t i = 0; i < extc_.size(); ++i) extc_[i] = (i < extc.size()) ? extc[i] : 1ul;
+
+  if(c.empty())
+    c.resize(extc_,static_cast<T>(0));
+  else
+    BTAS_assert(extc_.size() == c.extent().size() && std::equal(extc_.begin(),extc_.end(),c.extent().begin()),"contract_network, detected inconsistent extents (c).");
+
+  for(size_t s = 0; s < path.steps.size(); ++s) {
+    size_t i = path.steps[s].first;
+    size_t j = path.steps[s].second;
+    BTAS_assert(i != j && i < work.size() && j < work.size(),"contract_network, detected invalid step in path.");
+
+    detail::__network_tensor<T> z;
+    detail::__network_pair_symbols(work[i].symbs,work[j].symbs,z.symbs);
+    z.ext.resize(z.symbs.size());
+    size_t size = 1;
+    for(size_t k = 0; k < z.symbs.size(); ++k) size *= (z.ext[k] = info.ext[z.symbs[k]]);
+
+    if(s+1 == path.steps.size() && z.symbs == info.symbc) {
+      // the last step is written into c directly
+      detail::__network_contract_pair<T,Layout>(alpha,work[i],work[j],beta,c.data(),bufx,bufy);
+      return;
+    }
+
+    // reuse storage of a released intermediate
+    for(size_t k = 0; k < pool.size(); ++k) {
+      if(pool[k].capacity() >= size) { z.store.swap(pool[k]); pool.erase(pool.begin()+k); break; }
+    }
+    z.store.resize(size);
+    z.data = z.store.data();
+
+    detail::__network_contract_pair<T,Layout>(static_cast<T>(1),work[i],work[j],static_cast<T>(0),z.store.data(),bufx,bufy);
+
+    if(i < j) std::swap(i,j);
+    for(size_t k : { i, j }) {
+      if(work[k].store.empty()) continue; // input tensor
+      pool.push_back(std::vector<T>());
+      pool.back().swap(work[k].store);
+    }
+    work.erase(work.begin()+i);
+    work.erase(work.begin()+j);
+    work.push_back(std::move(z));
+  }
+
+  // permute the result into c
+  const detail::__network_tensor<T>& r = work[0];
+  std::vector<size_t> idx(info.symbc.size());
+  for(size_t i = 0; i < info.symbc.size(); ++i) idx[i] = std::find(r.symbs.begin(),r.symbs.end(),info.symbc[i])-r.symbs.begin();
+  PermutePlan<T,0ul,Layout>::get(r.ext,idx).execute(alpha,r.data,beta,c.data());
+}
+
+/// contract a tensor network in the order found by make_contract_path, c = alpha * (a * b * ...) + beta * c
+/// e.g. contract_network(1.0,{L,psi,W,R},{{'a','s','b'},{'a','p','c'},{'b','q','p','t'},{'c','t','d'}},0.0,c,make_array('s','q','d'))
+/// \return contraction path with FLOP and peak-memory estimates
+template<typename T, size_t N, CBLAS_LAYOUT Layout, class SymbolC, class AllocC>
+contract_path contract_network (
+  const T& alpha,
+  const std::vector<network_operand<T,Layout>>& tensors,
+  const std::vector<std::vector<typename SymbolC::value_type>>& symbs,
+  const T& beta,
+        Tensor<T,N,Layout,AllocC>& c, const SymbolC& symbc,
+  size_t max_size = 0)
+{
+  std::vector<std::vector<size_t>> exts(tensors.size());
+  for(size_t t = 0; t < tensors.size(); ++t) exts[t] = tensors[t].extent();
+
+  contract_path path = make_contract_path(exts,symbs,symbc,max_size);
+  contract_network(alpha,tensors,symbs,beta,c,symbc,path);
+  return path;
+}
+
+} // namespace btas
+
+#endif // __BTAS_CONTRACT_NETWORK_HPP
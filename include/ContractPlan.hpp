@@ -0,0 +1,801 @@
+#ifndef __BTAS_CONTRACT_PLAN_HPP
+#define __BTAS_CONTRACT_PLAN_HPP
+
+#include <array>
+#include <vector>
+#include <tuple>
+#include <utility> // std::make_pair
+#include <algorithm> // std::equal, std::fill
+#include <type_traits> // std::conditional
+
+#include <BTAS_assert.h>
+#include <blas.h>
+#include <remove_complex.h>
+#include <Tensor.hpp>
+#include <PlanCache.hpp>
+#include <PermutePlan.hpp>
+#include <permute.hpp>
+#include <parallel.h>
+#include <contract_helper.hpp>
+#include <Workspace.hpp>
+
+namespace btas {
+
+/// Complex conjugation of operands of contraction, c = alpha * op(a) * op(b) + beta * c, where op(x) is either x or conj(x)
+/// NOTE: ignored for real types
+enum ContractConj { ConjNone = 0, ConjA = 1, ConjB = 2, ConjAB = 3 };
+
+/// Arguments of GEMM carried out by ContractPlan, i.e. c = alpha * op(x) * op(y) + beta * c,
+/// where x and y are (permuted) a and b, or b and a if swapped
+struct contract_gemm {
+
+  CBLAS_TRANSPOSE transx;
+
+  CBLAS_TRANSPOSE transy;
+
+  size_t m, n, k; ///< GEMM dimensions
+
+  size_t ldx, ldy, ldc; ///< leading dimensions
+
+  bool is_swapped; ///< true if x is b and y is a
+
+};
+
+/// Plan to carry out contraction with index symbols, c = alpha * a * b + beta * c, for repeated calls of the same shape
+/// Upon construction, the contraction is analyzed only once:
+/// 1) index symbols are parsed into contraction indices,
+/// 2) either a strided batch of GEMMs is chosen by the cost model (see contract_batch_helper),
+///    or which of a, b and c to permute and trans flags are chosen by make_contract_layout,
+/// 3) permutations, GEMM dimensions and leading dimensions are fixed,
+///    and the kernel is chosen from the ranks of a, b and c, i.e. DOT, GEMV, GEMV^T, GER or GEMM.
+/// Symbols which appear in a, b and c are batch (Hadamard) indices, e.g. c[i,j,k] = sum_l a[i,j,l] * b[i,l,k],
+/// which are carried out by a strided batch of GEMMs if batch indices are fused in a, b and c,
+/// or by a loop of GEMMs over batch indices split over OpenMP threads otherwise (see reset_batch_).
+/// Conjugation of a and b (see ContractConj) is folded into CblasConjTrans if the operand is transposed in GEMM,
+/// otherwise the operand is conjugated while it is permuted into workspace (or copied if not permuted).
+/// Rank of 0 stands for dynamic rank (Tensor<T,0,Layout>), which is analyzed in the same manner at runtime.
+/// NOTE: since a tensor of dynamic rank w/o index has no element, full contraction of dynamic rank is stored in c of extent {1}.
+/// Temporaries are taken from a workspace of workspace_size() elements, which is given to execute() or taken from
+/// the thread-local Workspace, so that execute() does no heap allocation once the workspace is large enough.
+template<typename T, size_t L, size_t M, size_t N, CBLAS_LAYOUT Layout = CblasRowMajor>
+class ContractPlan {
+
+public:
+
+  typedef typename TensorStride<L,Layout>::extent_type extent_type_a;
+
+  typedef typename TensorStride<M,Layout>::extent_type extent_type_b;
+
+  typedef typename TensorStride<N,Layout>::extent_type extent_type_c;
+
+  /// number of contracted indices (meaningful for static ranks only)
+  static constexpr size_t K = (L+M-N)/2;
+
+  /// contraction indices, std::vector if any of ranks is dynamic
+  typedef typename std::conditional<(L > 0 && M > 0 && N > 0),std::array<size_t,K>,std::vector<size_t>>::type index_type;
+
+  /// default
+  ContractPlan ()
+  : is_a_permuted_(false), is_b_permuted_(false), is_c_permuted_(false), kernel_(Gemm),
+    transa_(CblasNoTrans), transb_(CblasNoTrans), m_(0), n_(0), k_(0), lda_(1), ldb_(1), ldc_(1),
+    is_hadamard_(false), is_strided_(false), nbatch_(1), stra_(0), strb_(0), strc_(0),
+    conja_(false), conjb_(false), is_a_conj_(false), is_b_conj_(false),
+    offa_(0), offb_(0), offc_(0), work_size_(0)
+  { }
+
+  /// construct from extents and index symbols
+  template<class SymbolA, class SymbolB, class SymbolC>
+  ContractPlan (
+    const extent_type_a& exta, const SymbolA& symba,
+    const extent_type_b& extb, const SymbolB& symbb, const SymbolC& symbc, ContractConj conj = ConjNone)
+  : ContractPlan()
+  { this->reset(exta,symba,extb,symbb,symbc,conj); }
+
+  /// analyze the contraction
+  template<class SymbolA, class SymbolB, class SymbolC>
+  void reset (
+    const extent_type_a& exta, const SymbolA& symba,
+    const extent_type_b& extb, const SymbolB& symbb, const SymbolC& symbc, ContractConj conj = ConjNone)
+  {
+    conja_ = is_complex<T>::value && (conj & ConjA);
+    conjb_ = is_complex<T>::value && (conj & ConjB);
+
+    // ranks are taken at runtime, which are the same as L, M and N unless dynamic
+    const size_t la = exta.size();
+    const size_t lb = extb.size();
+    const size_t lc = symbc.size();
+    BTAS_assert(symba.size() == la && symbb.size() == lb,"ContractPlan::reset, detected inconsistent rank of tensor and symbols.");
+
+    // batch indices
+    is_hadamard_ = false;
+    for(size_t i = 0; i < la && !is_hadamard_; ++i)
+      is_hadamard_ = (std::find(symbb.begin(),symbb.end(),symba[i]) != symbb.end() && std::find(symbc.begin(),symbc.end(),symba[i]) != symbc.end());
+    if(is_hadamard_) {
+      this->reset_batch_(exta,symba,extb,symbb,symbc);
+      return;
+    }
+
+    BTAS_assert(la+lb >= lc && (la+lb-lc)%2 == 0,"ContractPlan::reset, detected inconsistent number of symbols.");
+    const size_t lk = (la+lb-lc)/2;
+
+    index_type idxa; detail::__contract_resize(idxa,lk);
+    index_type idxb; detail::__contract_resize(idxb,lk);
+    SymbolC symbaxb(symbc);
+
+    parse_contract_symbols(symba,symbb,idxa,idxb,symbaxb);
+
+    exta_ = exta;
+    extb_ = extb;
+
+    // extent of a*b: free indices of a followed by free indices of b
+    extent_type_c extaxb; detail::__contract_resize(extaxb,lc);
+    size_t n = 0;
+    for(size_t i = 0; i < la; ++i)
+      if(std::find(idxa.begin(),idxa.end(),i) == idxa.end()) extaxb[n++] = exta[i];
+    for(size_t i = 0; i < lb; ++i)
+      if(std::find(idxb.begin(),idxb.end(),i) == idxb.end()) extaxb[n++] = extb[i];
+
+    size_t sizea = 1; for(size_t i = 0; i < la; ++i) sizea *= exta[i];
+    size_t sizeb = 1; for(size_t i = 0; i < lb; ++i) sizeb *= extb[i];
+    size_t sizec = 1; for(size_t i = 0; i < lc; ++i) sizec *= extaxb[i];
+    size_t sizek = 1; for(size_t i = 0; i < lk; ++i) {
+      BTAS_assert(exta[idxa[i]] == extb[idxb[i]],"ContractPlan::reset, detected inconsistent extents (a vs b).");
+      sizek *= exta[idxa[i]];
+    }
+
+    // permutation of a*b into c
+    typename TensorStride<N,Layout>::index_type pmutc; detail::__contract_resize(pmutc,lc);
+    make_permute_index(symbaxb,symbc,pmutc);
+    extc_ = make_permute(extaxb,pmutc);
+    if(lc == 0) {
+      // full contraction of dynamic rank is stored in c of extent {1}
+      detail::__contract_resize(extc_,1);
+      extc_[0] = 1;
+    }
+
+    // kernel by ranks of free indices of a and b
+    /**/ if(la == lk && lb == lk) kernel_ = Dot;
+    else if(lb == lk)            kernel_ = Gemv;
+    else if(la == lk)            kernel_ = GemvT;
+    else if(lk == 0)             kernel_ = Ger;
+    else                         kernel_ = Gemm;
+
+    // contraction of a and b, strided batch of GEMMs is not used w/ conjugation
+    if(conja_ || conjb_)
+      batch_ = contract_batch_helper<Layout>();
+    else
+      batch_ = contract_batch_helper<Layout>(exta,idxa,extb,idxb,sizeof(T));
+
+    is_a_permuted_ = false;
+    is_b_permuted_ = false;
+    is_c_permuted_ = false;
+    layout_ = contract_layout();
+
+    if(batch_.enabled()) {
+      // a*b is computed in the order of free indices of a and b
+      for(size_t i = 0; i < lc; ++i) if(pmutc[i] != i) is_c_permuted_ = true;
+      if(is_c_permuted_) {
+        planc_.reset(extaxb,pmutc);
+        layout_.pmutc.assign(pmutc.begin(),pmutc.end());
+        layout_.bytes = 2.0*sizec*sizeof(T);
+      }
+    }
+    else {
+      make_contract_layout(exta,idxa,extb,idxb,pmutc,sizeof(T),layout_);
+
+      is_a_permuted_ = !layout_.pmuta.empty();
+      if(is_a_permuted_) plana_.reset(exta,layout_.pmuta);
+
+      is_b_permuted_ = !layout_.pmutb.empty();
+      if(is_b_permuted_) planb_.reset(extb,layout_.pmutb);
+
+      // extent of a*b in the order chosen by the layout
+      is_c_permuted_ = !layout_.pmutc.empty();
+      if(is_c_permuted_) {
+        for(size_t i = 0; i < lc; ++i) extaxb[layout_.pmutc[i]] = extc_[i];
+        planc_.reset(extaxb,layout_.pmutc);
+      }
+
+      m_ = sizea/sizek;
+      n_ = sizeb/sizek;
+      k_ = sizek;
+
+      lda_ = ((Layout == CblasRowMajor) ^ (!layout_.is_a_trans)) ? m_ : k_;
+      ldb_ = ((Layout == CblasRowMajor) ^ (!layout_.is_b_trans)) ? k_ : n_;
+
+      if(layout_.is_c_swapped) {
+        // (b^T * a^T)^T = gemm(op(b),op(a)) w/ c of n x m
+        transa_ = layout_.is_a_trans ? CblasNoTrans : CblasTrans;
+        transb_ = layout_.is_b_trans ? CblasNoTrans : CblasTrans;
+        ldc_ = (Layout == CblasRowMajor) ? m_ : n_;
+      }
+      else {
+        transa_ = layout_.is_a_trans ? CblasTrans : CblasNoTrans;
+        transb_ = layout_.is_b_trans ? CblasTrans : CblasNoTrans;
+        ldc_ = (Layout == CblasRowMajor) ? n_ : m_;
+      }
+    }
+
+    this->reset_conj_();
+
+    // workspace: [permuted a | permuted b | a*b]
+    offa_ = 0;
+    offb_ = offa_+((is_a_permuted_ || is_a_conj_) ? sizea : 0);
+    offc_ = offb_+((is_b_permuted_ || is_b_conj_) ? sizeb : 0);
+    work_size_ = offc_+(is_c_permuted_ ? sizec : 0);
+  }
+
+  /// carry out contraction, c = alpha * a * b + beta * c
+  /// \param work workspace of workspace_size() elements at least
+  void execute (
+    const T& alpha,
+    const TensorBase<T,L,Layout>& a,
+    const TensorBase<T,M,Layout>& b,
+    const T& beta,
+          TensorBase<T,N,Layout>& c, T* work) const
+  {
+    BTAS_assert(exta_.size() == a.extent().size() && std::equal(exta_.begin(),exta_.end(),a.extent().begin()),"ContractPlan::execute, detected inconsistent extents (a).");
+    BTAS_assert(extb_.size() == b.extent().size() && std::equal(extb_.begin(),extb_.end(),b.extent().begin()),"ContractPlan::execute, detected inconsistent extents (b).");
+    BTAS_assert(extc_.size() == c.extent().size() && std::equal(extc_.begin(),extc_.end(),c.extent().begin()),"ContractPlan::execute, detected inconsistent extents (c).");
+
+    // a*b is written to workspace if c is permuted
+    T* pc = is_c_permuted_ ? work+offc_ : c.data();
+    const T betac = is_c_permuted_ ? static_cast<T>(0) : beta;
+
+    if(is_hadamard_) {
+      this->execute_batch_(alpha,this->prepare_a_(a.data(),work),this->prepare_b_(b.data(),work),betac,pc);
+    }
+    else if(batch_.enabled()) {
+      batch_.call(alpha,a.data(),b.data(),betac,pc);
+    }
+    else {
+      const T* pa = this->prepare_a_(a.data(),work);
+      const T* pb = this->prepare_b_(b.data(),work);
+      switch(kernel_) {
+        case Dot:
+          // contracted indices of a and b are in the same order
+          pc[0] = (betac == static_cast<T>(0)) ? alpha*dot(k_,pa,1,pb,1) : alpha*dot(k_,pa,1,pb,1)+betac*pc[0];
+          break;
+        case Gemv:
+          // c(m) = op(a)(m,k) * b(k)
+          gemv(Layout,transa_,(layout_.is_a_trans ? k_ : m_),(layout_.is_a_trans ? m_ : k_),alpha,pa,lda_,pb,1,betac,pc,1);
+          break;
+        case GemvT:
+          // c(n) = a(k) * op(b)(k,n) = op(b)^T(n,k) * a(k)
+          gemv(Layout,(layout_.is_b_trans ? CblasNoTrans : CblasTrans),(layout_.is_b_trans ? n_ : k_),(layout_.is_b_trans ? k_ : n_),alpha,pb,ldb_,pa,1,betac,pc,1);
+          break;
+        case Ger:
+          // c = beta * c + alpha * a^T * b, or (b^T * a)^T if swapped
+          if(betac == static_cast<T>(0))
+            std::fill(pc,pc+m_*n_,static_cast<T>(0));
+          else if(betac != static_cast<T>(1))
+            scal(m_*n_,betac,pc,1);
+          if(layout_.is_c_swapped)
+            ger(Layout,n_,m_,alpha,pb,1,pa,1,pc,ldc_);
+          else
+            ger(Layout,m_,n_,alpha,pa,1,pb,1,pc,ldc_);
+          break;
+        default:
+          if(layout_.is_c_swapped)
+            gemm(Layout,transb_,transa_,n_,m_,k_,alpha,pb,ldb_,pa,lda_,betac,pc,ldc_);
+          else
+            gemm(Layout,transa_,transb_,m_,n_,k_,alpha,pa,lda_,pb,ldb_,betac,pc,ldc_);
+      }
+    }
+
+    if(is_c_permuted_) planc_.execute(static_cast<T>(1),pc,beta,c.data());
+  }
+
+  /// permute (and conjugate) a and b into workspace if needed, and return pointers to operands of GEMM (see contract_batch)
+  /// \param pc a*b, which is either c or workspace if c is permuted
+  /// NOTE: not applicable if strided batch of GEMMs is used
+  void prepare (const T* a, const T* b, T* c, T* work, const T*& pa, const T*& pb, T*& pc) const
+  {
+    pa = this->prepare_a_(a,work);
+    pb = this->prepare_b_(b,work);
+    pc = is_c_permuted_ ? work+offc_ : c;
+  }
+
+  /// permute a*b into c, c = P(a*b) + beta * c, if c is permuted (see contract_batch)
+  void finalize (const T* pc, const T& beta, T* c) const
+  {
+    if(is_c_permuted_) planc_.execute(static_cast<T>(1),pc,beta,c);
+  }
+
+  /// return arguments of GEMM which carries out a*b, any kernel is written as GEMM (see contract_batch)
+  contract_gemm gemm_args () const
+  {
+    contract_gemm args;
+    args.is_swapped = layout_.is_c_swapped;
+    if(args.is_swapped) {
+      args.transx = transb_; args.transy = transa_;
+      args.m = n_; args.n = m_;
+      args.ldx = ldb_; args.ldy = lda_;
+    }
+    else {
+      args.transx = transa_; args.transy = transb_;
+      args.m = m_; args.n = n_;
+      args.ldx = lda_; args.ldy = ldb_;
+    }
+    args.k = k_;
+    args.ldc = ldc_;
+    return args;
+  }
+
+  /// carry out contraction, c = alpha * a * b + beta * c
+  /// temporaries are taken from the thread-local Workspace, c is resized w/o initialization and overwritten if empty
+  template<class AllocC>
+  void execute (
+    const T& alpha,
+    const TensorBase<T,L,Layout>& a,
+    const TensorBase<T,M,Layout>& b,
+    const T& beta,
+          Tensor<T,N,Layout,AllocC>& c) const
+  {
+    const bool is_empty = c.empty();
+    if(is_empty) c.resize_uninitialized(extc_);
+    Workspace::Scope scope;
+    this->execute(alpha,a,b,(is_empty ? static_cast<T>(0) : beta),c,scope.allocate<T>(work_size_));
+  }
+
+  /// return extent of c
+  const extent_type_c& extent_c () const { return extc_; }
+
+  /// return number of elements of workspace required
+  size_t workspace_size () const { return work_size_; }
+
+  /// return true if batch of GEMMs is used, i.e. strided batch of GEMMs is chosen, or c has batch indices
+  bool is_batched () const { return batch_.enabled() || is_hadamard_; }
+
+  /// return true if c has batch (Hadamard) indices, which appear in a, b and c
+  bool is_hadamard () const { return is_hadamard_; }
+
+  /// return name of BLAS kernel, i.e. "dot", "gemv", "gemv^T", "ger", "gemm", "gemm_batch" or "gemm_loop"
+  const char* kernel () const
+  {
+    if(is_hadamard_) return is_strided_ ? "gemm_batch" : "gemm_loop";
+    if(batch_.enabled()) return "gemm_batch";
+    switch(kernel_) {
+      case Dot:   return "dot";
+      case Gemv:  return "gemv";
+      case GemvT: return "gemv^T";
+      case Ger:   return "ger";
+      default:    return "gemm";
+    }
+  }
+
+  /// return true if a is permuted before GEMM
+  bool is_a_permuted () const { return is_a_permuted_; }
+
+  /// return true if b is permuted before GEMM
+  bool is_b_permuted () const { return is_b_permuted_; }
+
+  /// return true if a*b is permuted into c
+  bool is_c_permuted () const { return is_c_permuted_; }
+
+  /// return true if a is conjugated in workspace, i.e. conjugation of a is not folded into CblasConjTrans
+  bool is_a_conj () const { return is_a_conj_; }
+
+  /// return true if b is conjugated in workspace, i.e. conjugation of b is not folded into CblasConjTrans
+  bool is_b_conj () const { return is_b_conj_; }
+
+  /// return layout of contraction chosen by the cost model (see make_contract_layout), for logging
+  const contract_layout& layout () const { return layout_; }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  /// return a cached plan for (extents, symbols), the plan is created upon the first call
+  /// NOTE: the cache is thread-local and holds at most _BTAS_CONTRACT_PLAN_CACHE_SIZE plans for each type of symbols, the least recently used plan is evicted first,
+  ///       the reference is valid until clear_cache() or clear_plan_caches() is called, or _BTAS_CONTRACT_PLAN_CACHE_SIZE other plans are created in the same thread
+  template<class SymbolA, class SymbolB, class SymbolC>
+  static const ContractPlan& get (
+    const extent_type_a& exta, const SymbolA& symba,
+    const extent_type_b& extb, const SymbolB& symbb, const SymbolC& symbc, ContractConj conj = ConjNone)
+  {
+    typedef std::tuple<extent_type_a,extent_type_b,SymbolA,SymbolB,SymbolC,int> key_type;
+    typedef detail::__plan_cache<key_type,ContractPlan> cache_type;
+
+    // cache for each type of symbols, which is cleared by clear_cache() through its tag
+    static thread_local cache_type cache(ContractPlan::tag_(),_BTAS_CONTRACT_PLAN_CACHE_SIZE);
+
+    // extents and symbols are copied into the storage of the probe key, which is not reallocated for dynamic rank
+    const int iconj = static_cast<int>(conj);
+    key_type& key = cache.probe();
+    key = std::tie(exta,extb,symba,symbb,symbc,iconj);
+    const ContractPlan* plan = cache.find(key);
+    if(plan) return *plan;
+    return cache.insert(key,ContractPlan(exta,symba,extb,symbb,symbc,conj));
+  }
+
+  /// release cached plans for all types of symbols in the calling thread
+  static void clear_cache () { detail::__plan_cache_base::clear_all(ContractPlan::tag_()); }
+
+private:
+
+  /// analyze contraction w/ batch indices, c[h,i,j] = sum_k a[h,i,k] * b[h,k,j]
+  /// each of a, b and c is viewed as a batch of matrices w/o permutation if possible (see detail::__make_batch_view),
+  /// otherwise, it is permuted into (h,i,k), (h,k,j) or (h,i,j) respectively.
+  /// batch, free and contracted indices are analyzed in the order of memory, i.e. reversed for col-major,
+  /// and GEMMs are called in row-major.
+  template<class SymbolA, class SymbolB, class SymbolC>
+  void reset_batch_ (
+    const extent_type_a& exta, const SymbolA& symba,
+    const extent_type_b& extb, const SymbolB& symbb, const SymbolC& symbc)
+  {
+    enum { Free = 0, Contracted = 1, Batch = 2 };
+
+    const size_t la = exta.size();
+    const size_t lb = extb.size();
+    const size_t lc = symbc.size();
+
+    exta_ = exta;
+    extb_ = extb;
+    detail::__contract_resize(extc_,lc);
+
+    // position in memory order
+    const bool rev = (Layout == CblasColMajor);
+    auto mem = [rev] (size_t i, size_t rank) { return rev ? rank-1-i : i; };
+
+    // role and rank of each index of c in memory order
+    std::vector<size_t> ec(lc), rolec(lc), rankc(lc);
+    size_t nh = 0, nfa = 0, nfb = 0;
+    for(size_t j = 0; j < lc; ++j) {
+      const size_t jc = mem(j,lc);
+      const size_t ia = std::find(symba.begin(),symba.end(),symbc[jc])-symba.begin();
+      const size_t ib = std::find(symbb.begin(),symbb.end(),symbc[jc])-symbb.begin();
+      BTAS_assert(ia < la || ib < lb,"ContractPlan::reset, symbol of c is not found in a nor b.");
+      extc_[jc] = (ia < la) ? exta[ia] : extb[ib];
+      if(ia < la && ib < lb) {
+        BTAS_assert(exta[ia] == extb[ib],"ContractPlan::reset, detected inconsistent extents (a vs b).");
+        rolec[j] = Batch; rankc[j] = nh++;
+      }
+      else if(ia < la) { rolec[j] = Free; rankc[j] = nfa++; }
+      else             { rolec[j] = Free+1; rankc[j] = nfb++; }
+      ec[j] = extc_[jc];
+    }
+
+    // labels and orders of a and b in memory order, labels of b are (contracted, free) = (0, 1)
+    std::vector<size_t> ea(la), laba(la), orda(la), pka(la);
+    size_t nk = 0;
+    for(size_t i = 0; i < la; ++i) {
+      const size_t ia = mem(i,la);
+      ea[i] = exta[ia];
+      const size_t jc = std::find(symbc.begin(),symbc.end(),symba[ia])-symbc.begin();
+      const bool inb = (std::find(symbb.begin(),symbb.end(),symba[ia]) != symbb.end());
+      if(jc < lc) { const size_t j = mem(jc,lc); laba[i] = (rolec[j] == Batch) ? Batch : Free; orda[i] = rankc[j]; }
+      else        { BTAS_assert(inb,"ContractPlan::reset, symbol of a is not found in b nor c."); laba[i] = Contracted; orda[i] = nk++; }
+    }
+    std::vector<size_t> eb(lb), labb(lb), ordb(lb), ordb_self(lb);
+    size_t nkb = 0;
+    for(size_t i = 0; i < lb; ++i) {
+      const size_t ib = mem(i,lb);
+      eb[i] = extb[ib];
+      const size_t jc = std::find(symbc.begin(),symbc.end(),symbb[ib])-symbc.begin();
+      if(jc < lc) {
+        const size_t j = mem(jc,lc);
+        labb[i] = (rolec[j] == Batch) ? Batch : Free+1;
+        ordb[i] = ordb_self[i] = rankc[j];
+      }
+      else {
+        const size_t ia = std::find(symba.begin(),symba.end(),symbb[ib])-symba.begin();
+        BTAS_assert(ia < la,"ContractPlan::reset, symbol of b is not found in a nor c.");
+        BTAS_assert(exta[ia] == extb[ib],"ContractPlan::reset, detected inconsistent extents (a vs b).");
+        labb[i] = 0;
+        ordb[i] = orda[mem(ia,la)]; // order of contracted indices in a
+        ordb_self[i] = nkb++;
+      }
+    }
+    BTAS_assert(nk == nkb,"ContractPlan::reset, detected inconsistent contraction indices.");
+
+    size_t sizea = 1; for(size_t i = 0; i < la; ++i) sizea *= ea[i];
+    size_t sizeb = 1; for(size_t i = 0; i < lb; ++i) sizeb *= eb[i];
+    size_t sizec = 1; for(size_t j = 0; j < lc; ++j) sizec *= ec[j];
+
+    // which of a and b to permute, contracted indices are ordered as in either a or b
+    detail::__batch_view va, vb, vc;
+    const bool ok_a = detail::__make_batch_view(ea,laba,orda,nh,va);
+    const bool ok_b = detail::__make_batch_view(eb,labb,ordb,nh,vb);
+    const bool ok_b_self = ok_b || detail::__make_batch_view(eb,labb,ordb_self,nh,vb);
+
+    is_a_permuted_ = false;
+    is_b_permuted_ = false;
+    layout_ = contract_layout();
+
+    bool order_by_b = false; // contracted indices are ordered as in b
+    if(!(ok_a && ok_b)) {
+      if(ok_a && ok_b_self) {
+        // contracted indices are ordered differently, the smaller one is permuted
+        is_a_permuted_ = (sizea <= sizeb);
+        is_b_permuted_ = !is_a_permuted_;
+        order_by_b = is_a_permuted_;
+      }
+      else {
+        is_a_permuted_ = !ok_a;
+        is_b_permuted_ = !ok_b_self || !ok_a;
+        order_by_b = !ok_a && ok_b_self;
+        if(order_by_b) is_b_permuted_ = false;
+      }
+    }
+    if(order_by_b) {
+      // reorder contracted indices of a as in b
+      for(size_t i = 0; i < lb; ++i) {
+        if(labb[i] != 0) continue;
+        const size_t ia = std::find(symba.begin(),symba.end(),symbb[mem(i,lb)])-symba.begin();
+        orda[mem(ia,la)] = ordb_self[i];
+      }
+      ordb = ordb_self;
+    }
+
+    // permute x into canonical order in memory, (batch, 0, 1) by labels and orders
+    auto canonical = [this,rev,&mem] (std::vector<size_t>& ext, std::vector<size_t>& label, std::vector<size_t>& order,
+                                      size_t first, size_t second, std::vector<size_t>& pmut) {
+      const size_t rank = ext.size();
+      const size_t labels[] = { Batch, first, second };
+      std::vector<size_t> src; // source position in memory order
+      for(size_t l = 0; l < 3; ++l) {
+        std::vector<std::pair<size_t,size_t>> x;
+        for(size_t i = 0; i < rank; ++i) if(label[i] == labels[l]) x.push_back(std::make_pair(order[i],i));
+        std::sort(x.begin(),x.end());
+        for(size_t i = 0; i < x.size(); ++i) src.push_back(x[i].second);
+      }
+      // permutation in actual order of indices
+      pmut.resize(rank);
+      for(size_t i = 0; i < rank; ++i) pmut[i] = mem(src[mem(i,rank)],rank);
+      std::vector<size_t> ext_(rank), label_(rank), order_(rank);
+      for(size_t i = 0; i < rank; ++i) { ext_[i] = ext[src[i]]; label_[i] = label[src[i]]; order_[i] = order[src[i]]; }
+      ext.swap(ext_); label.swap(label_); order.swap(order_);
+    };
+
+    if(is_a_permuted_) {
+      canonical(ea,laba,orda,Free,Contracted,layout_.pmuta);
+      plana_.reset(exta,layout_.pmuta);
+      detail::__make_batch_view(ea,laba,orda,nh,va);
+    }
+    if(is_b_permuted_) {
+      canonical(eb,labb,ordb,0,Free+1,layout_.pmutb);
+      planb_.reset(extb,layout_.pmutb);
+      detail::__make_batch_view(eb,labb,ordb,nh,vb);
+    }
+    else if(!ok_b) {
+      detail::__make_batch_view(eb,labb,ordb,nh,vb);
+    }
+
+    // a*b is computed in canonical order if c cannot be viewed as a batch of matrices
+    is_c_permuted_ = !detail::__make_batch_view(ec,rolec,rankc,nh,vc);
+    if(is_c_permuted_) {
+      std::vector<size_t> ec_(ec), rolec_(rolec), rankc_(rankc), pmut;
+      canonical(ec_,rolec_,rankc_,Free,Free+1,pmut);
+      detail::__make_batch_view(ec_,rolec_,rankc_,nh,vc);
+      // pmut permutes c into a*b, inverse permutes a*b into c
+      extent_type_c extaxb; detail::__contract_resize(extaxb,lc);
+      layout_.pmutc.resize(lc);
+      for(size_t i = 0; i < lc; ++i) {
+        extaxb[i] = extc_[pmut[i]];
+        layout_.pmutc[pmut[i]] = i;
+      }
+      planc_.reset(extaxb,layout_.pmutc);
+    }
+
+    layout_.is_a_trans = va.is_trans;
+    layout_.is_b_trans = vb.is_trans;
+    layout_.is_c_swapped = vc.is_trans;
+    layout_.bytes = (is_a_permuted_ ? 2.0*sizea*sizeof(T) : 0.0)
+                  + (is_b_permuted_ ? 2.0*sizeb*sizeof(T) : 0.0)
+                  + (is_c_permuted_ ? 2.0*sizec*sizeof(T) : 0.0);
+
+    m_ = va.ext[0];
+    k_ = va.ext[1];
+    n_ = vb.ext[1];
+    lda_ = va.ld;
+    ldb_ = vb.ld;
+    ldc_ = vc.ld;
+    if(layout_.is_c_swapped) {
+      transa_ = va.is_trans ? CblasNoTrans : CblasTrans;
+      transb_ = vb.is_trans ? CblasNoTrans : CblasTrans;
+    }
+    else {
+      transa_ = va.is_trans ? CblasTrans : CblasNoTrans;
+      transb_ = vb.is_trans ? CblasTrans : CblasNoTrans;
+    }
+
+    // batch indices in order of c, which are fused to a single stride if possible
+    hext_.clear();
+    hstra_.clear();
+    hstrb_.clear();
+    hstrc_.clear();
+    nbatch_ = 1;
+    for(size_t j = 0; j < lc; ++j) {
+      if(rolec[j] != Batch || ec[j] == 1) continue;
+      hext_.push_back(ec[j]);
+      hstra_.push_back(va.hstr[rankc[j]]);
+      hstrb_.push_back(vb.hstr[rankc[j]]);
+      hstrc_.push_back(vc.hstr[rankc[j]]);
+      nbatch_ *= ec[j];
+    }
+    is_strided_ = true;
+    for(size_t i = 1; i < hext_.size(); ++i) {
+      if(hstra_[i-1] != hstra_[i]*hext_[i]) is_strided_ = false;
+      if(hstrb_[i-1] != hstrb_[i]*hext_[i]) is_strided_ = false;
+      if(hstrc_[i-1] != hstrc_[i]*hext_[i]) is_strided_ = false;
+    }
+    stra_ = hext_.empty() ? 0 : hstra_.back();
+    strb_ = hext_.empty() ? 0 : hstrb_.back();
+    strc_ = hext_.empty() ? 0 : hstrc_.back();
+
+    this->reset_conj_();
+
+    // workspace: [permuted a | permuted b | a*b]
+    offa_ = 0;
+    offb_ = offa_+((is_a_permuted_ || is_a_conj_) ? sizea : 0);
+    offc_ = offb_+((is_b_permuted_ || is_b_conj_) ? sizeb : 0);
+    work_size_ = offc_+(is_c_permuted_ ? sizec : 0);
+  }
+
+  /// fold conjugation of a and b into CblasConjTrans if the operand is transposed in GEMM (or in GEMV for a),
+  /// otherwise the operand is conjugated in workspace, w/ identity permutation if it is not permuted
+  void reset_conj_ ()
+  {
+    is_a_conj_ = false;
+    is_b_conj_ = false;
+    const bool is_gemm = is_hadamard_ || kernel_ == Gemm;
+    if(conja_) {
+      if((is_gemm || kernel_ == Gemv) && transa_ == CblasTrans)
+        transa_ = CblasConjTrans;
+      else
+        is_a_conj_ = true;
+    }
+    if(conjb_) {
+      if(is_gemm && transb_ == CblasTrans)
+        transb_ = CblasConjTrans;
+      else
+        is_b_conj_ = true;
+    }
+    if(is_a_conj_ && !is_a_permuted_) {
+      std::vector<size_t> iden(exta_.size());
+      for(size_t i = 0; i < iden.size(); ++i) iden[i] = i;
+      plana_.reset(exta_,iden);
+    }
+    if(is_b_conj_ && !is_b_permuted_) {
+      std::vector<size_t> iden(extb_.size());
+      for(size_t i = 0; i < iden.size(); ++i) iden[i] = i;
+      planb_.reset(extb_,iden);
+    }
+  }
+
+  /// permute and/or conjugate a into workspace if needed, and return pointer to operand of GEMM
+  const T* prepare_a_ (const T* a, T* work) const
+  {
+    if(is_a_conj_)
+      plana_.execute_conj(a,work+offa_);
+    else if(is_a_permuted_)
+      plana_.execute(a,work+offa_);
+    else
+      return a;
+    return work+offa_;
+  }
+
+  /// permute and/or conjugate b into workspace if needed, and return pointer to operand of GEMM
+  const T* prepare_b_ (const T* b, T* work) const
+  {
+    if(is_b_conj_)
+      planb_.execute_conj(b,work+offb_);
+    else if(is_b_permuted_)
+      planb_.execute(b,work+offb_);
+    else
+      return b;
+    return work+offb_;
+  }
+
+  /// carry out GEMMs over batch indices
+  void execute_batch_ (const T& alpha, const T* pa, const T* pb, const T& beta, T* pc) const
+  {
+    const bool swap = layout_.is_c_swapped;
+    if(is_strided_) {
+      if(swap)
+        gemm_batch_strided(CblasRowMajor,transb_,transa_,n_,m_,k_,alpha,pb,ldb_,strb_,pa,lda_,stra_,beta,pc,ldc_,strc_,nbatch_);
+      else
+        gemm_batch_strided(CblasRowMajor,transa_,transb_,m_,n_,k_,alpha,pa,lda_,stra_,pb,ldb_,strb_,beta,pc,ldc_,strc_,nbatch_);
+      return;
+    }
+
+    const size_t nh = hext_.size();
+    const bool is_parallel = (nbatch_ > 1 && nbatch_*m_*n_*k_ >= _BTAS_GEMM_BATCH_PARALLEL_THRESHOLD && detail::__max_threads() > 1);
+
+#ifdef _OPENMP
+#pragma omp parallel if(is_parallel)
+#endif
+    {
+      size_t first = 0;
+      size_t last  = nbatch_;
+      if(is_parallel) detail::__thread_range(nbatch_,first,last);
+
+      for(size_t ib = first; ib < last; ++ib) {
+        // offsets of ib-th batch
+        size_t oa = 0, ob = 0, oc = 0;
+        for(size_t i = nh, ord = ib; i > 0; --i) {
+          const size_t h = ord%hext_[i-1]; ord /= hext_[i-1];
+          oa += h*hstra_[i-1];
+          ob += h*hstrb_[i-1];
+          oc += h*hstrc_[i-1];
+        }
+        if(swap)
+          gemm(CblasRowMajor,transb_,transa_,n_,m_,k_,alpha,pb+ob,ldb_,pa+oa,lda_,beta,pc+oc,ldc_);
+        else
+          gemm(CblasRowMajor,transa_,transb_,m_,n_,k_,alpha,pa+oa,lda_,pb+ob,ldb_,beta,pc+oc,ldc_);
+      }
+    }
+  }
+
+  /// BLAS kernel chosen by ranks
+  enum Kernel { Dot, Gemv, GemvT, Ger, Gemm };
+
+  /// tag to identify caches owned by this class
+  static const void* tag_ ()
+  {
+    static const char tag = 0;
+    return &tag;
+  }
+
+  //  Members
+
+  extent_type_a exta_; ///< extent of a
+
+  extent_type_b extb_; ///< extent of b
+
+  extent_type_c extc_; ///< extent of c
+
+  bool is_a_permuted_; ///< true if a is permuted before GEMM
+
+  bool is_b_permuted_; ///< true if b is permuted before GEMM
+
+  bool is_c_permuted_; ///< true if a*b is permuted into c
+
+  Kernel kernel_; ///< BLAS kernel
+
+  PermutePlan<T,L,Layout> plana_; ///< permutation of a
+
+  PermutePlan<T,M,Layout> planb_; ///< permutation of b
+
+  PermutePlan<T,N,Layout> planc_; ///< permutation of a*b into c
+
+  contract_layout layout_; ///< layout of contraction
+
+  contract_batch_helper<Layout> batch_; ///< strided batch of GEMMs
+
+  CBLAS_TRANSPOSE transa_;
+
+  CBLAS_TRANSPOSE transb_;
+
+  size_t m_, n_, k_; ///< GEMM dimensions
+
+  size_t lda_, ldb_, ldc_; ///< leading dimensions
+
+  bool is_hadamard_; ///< true if c has batch indices
+
+  bool is_strided_; ///< true if batch indices are fused to a single stride in a, b and c
+
+  size_t nbatch_; ///< number of batches
+
+  size_t stra_, strb_, strc_; ///< strides of fused batch index
+
+  std::vector<size_t> hext_; ///< extents of batch indices (w/o those of extent 1)
+
+  std::vector<size_t> hstra_, hstrb_, hstrc_; ///< strides of batch indices
+
+  bool conja_; ///< true if a is conjugated (complex types only)
+
+  bool conjb_; ///< true if b is conjugated (complex types only)
+
+  bool is_a_conj_; ///< true if a is conjugated in workspace
+
+  bool is_b_conj_; ///< true if b is conjugated in workspace
+
+  size_t offa_, offb_, offc_; ///< offsets of temporaries in workspace
+
+  size_t work_size_; ///< number of elements of workspace
+
+}; // class ContractPlan<T,L,M,N,Layout>
+
+} // namespace btas
+
+#endif // __BTAS_CONTRACT_PLAN_HPP
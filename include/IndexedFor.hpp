@@ -7,7 +7,7 @@
 #ifndef __BTAS_INDEX_FOR_HPP
 #define __BTAS_INDEX_FOR_HPP
 
-#include <mkl.h>
+#include <backend.h> // CBLAS_LAYOUT
 
 // TODO: To implement OpenMP version of IndexFor
 
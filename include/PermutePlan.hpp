@@ -0,0 +1,289 @@
+#ifndef __BTAS_PERMUTE_PLAN_HPP
+#define __BTAS_PERMUTE_PLAN_HPP
+
+#include <vector>
+#include <utility> // std::pair
+#include <algorithm> // std::copy, std::reverse, std::stable_sort
+
+#include <BTAS_assert.h>
+#include <PlanCache.hpp>
+#include <TensorStride.hpp>
+#include <reindex.hpp>
+
+namespace btas {
+
+/// Plan to permute a contiguous tensor x into a contiguous tensor y, y[i,j,k,...] = x[idx...]
+/// Upon construction, the permutation is analyzed only once:
+/// 1) indices of extent 1 are dropped,
+/// 2) index groups which stay adjacent in both x and y are fused, e.g. {2,3,0,1} becomes a 2D transpose,
+/// 3) the outer loops are reordered to minimize strided traffic,
+/// 4) a kernel is selected from copy, strided copy, 2D transpose, and blocked N-D transpose.
+/// The plan can be executed repeatedly on different data of the same shape.
+template<typename T, size_t N, CBLAS_LAYOUT Layout = CblasRowMajor>
+class PermutePlan {
+
+public:
+
+  typedef typename TensorStride<N,Layout>::extent_type extent_type;
+
+  typedef typename TensorStride<N,Layout>::stride_type stride_type;
+
+  typedef typename TensorStride<N,Layout>::index_type index_type;
+
+  /// kernels to carry out permutation
+  enum kernel_type {
+    Copy, ///< no permutation is needed (up to extents of 1)
+    Strided, ///< fastest index is untouched, copied as contiguous blocks
+    Transpose, ///< 2D transpose after fusion
+    Blocked ///< N-D transpose, tiled over two fast indices
+  };
+
+  /// default
+  PermutePlan () : kernel_(Copy), size_(0), p_(0) { }
+
+  /// construct from extent of x and permutation index, y's i-th index is x's idx[i]-th index
+  template<class Index>
+  PermutePlan (const extent_type& ext_x, const Index& idx)
+  { this->reset(ext_x,idx); }
+
+  /// construct from extent and (arbitrary) stride of x, and permutation index
+  template<class Index>
+  PermutePlan (const extent_type& ext_x, const stride_type& str_x, const Index& idx)
+  { this->reset(ext_x,str_x,idx); }
+
+  /// analyze the permutation
+  template<class Index>
+  void reset (const extent_type& ext_x, const Index& idx)
+  {
+    TensorStride<N,Layout> tn_stride_x(ext_x);
+    this->reset(ext_x,tn_stride_x.stride(),idx);
+  }
+
+  /// analyze the permutation of x having arbitrary stride (e.g. TensorView), y is always contiguous
+  template<class Index>
+  void reset (const extent_type& ext_x, const stride_type& str_x, const Index& idx)
+  {
+    const size_t rank = ext_x.size();
+    BTAS_assert(idx.size() == rank && str_x.size() == rank,"PermutePlan::reset, detected inconsistent size of argument.");
+
+    // extent and stride of x in the order of y (row-major, i.e. the last index runs fastest in y)
+    std::vector<size_t> ext(rank);
+    std::vector<size_t> str(rank);
+    size_t n = 0;
+    for(typename Index::const_iterator it = idx.begin(); it != idx.end(); ++it, ++n) {
+      ext[n] = ext_x[*it];
+      str[n] = str_x[*it];
+    }
+    if(Layout == CblasColMajor) {
+      std::reverse(ext.begin(),ext.end());
+      std::reverse(str.begin(),str.end());
+    }
+
+    size_ = 1;
+    for(size_t i = 0; i < rank; ++i) size_ *= ext[i];
+
+    ext_.clear();
+    str_x_.clear();
+    str_y_.clear();
+    kernel_ = Copy;
+    p_ = 0;
+
+    if(size_ == 0) return;
+
+    // drop indices of extent 1 and fuse adjacent indices
+    for(size_t i = 0; i < rank; ++i) {
+      if(ext[i] == 1) continue;
+      if(!ext_.empty() && str_x_.back() == ext[i]*str[i]) {
+        ext_.back() *= ext[i];
+        str_x_.back() = str[i];
+      }
+      else {
+        ext_.push_back(ext[i]);
+        str_x_.push_back(str[i]);
+      }
+    }
+
+    const size_t m = ext_.size();
+
+    if(m == 0 || (m == 1 && str_x_[0] == 1)) return;
+
+    str_y_.resize(m);
+    str_y_[m-1] = 1;
+    for(size_t i = m-1; i > 0; --i) str_y_[i-1] = ext_[i]*str_y_[i];
+
+    // find the fastest index in x, if x has no contiguous index, the last index is copied with stride
+    size_t p = m-1;
+    if(str_x_[m-1] != 1)
+      for(size_t i = 0; i < m-1; ++i) if(str_x_[i] == 1) { p = i; break; }
+
+    // reorder outer loops: the largest strides go outermost, the fastest index of x sits next to the last
+    std::vector<size_t> order;
+    for(size_t i = 0; i < m-1; ++i) if(i != p) order.push_back(i);
+    std::stable_sort(order.begin(),order.end(),[this] (size_t i, size_t j) {
+      return str_x_[i]+str_y_[i] > str_x_[j]+str_y_[j];
+    });
+    if(p != m-1) order.push_back(p);
+    order.push_back(m-1);
+
+    std::vector<size_t> ext_tmp(m);
+    std::vector<size_t> str_x_tmp(m);
+    std::vector<size_t> str_y_tmp(m);
+    for(size_t i = 0; i < m; ++i) {
+      ext_tmp[i] = ext_[order[i]];
+      str_x_tmp[i] = str_x_[order[i]];
+      str_y_tmp[i] = str_y_[order[i]];
+    }
+    ext_.swap(ext_tmp);
+    str_x_.swap(str_x_tmp);
+    str_y_.swap(str_y_tmp);
+
+    if(p == m-1) {
+      kernel_ = Strided;
+    }
+    else {
+      kernel_ = (m == 2) ? Transpose : Blocked;
+      p_ = m-2;
+    }
+  }
+
+  /// carry out permutation, py must have the same size as px
+  void execute (const T* px, T* py) const
+  {
+    this->execute_(px,py,detail::__assign_op());
+  }
+
+  /// carry out permutation with complex conjugation, py = conj(P(px))
+  void execute_conj (const T* px, T* py) const
+  {
+    this->execute_(px,py,detail::__conj_op());
+  }
+
+  /// carry out scaled-accumulate permutation, py = alpha * P(px) + beta * py
+  /// NOTE: py is not read if beta == 0, so that py can be uninitialized
+  void execute (const T& alpha, const T* px, const T& beta, T* py) const
+  {
+    if(beta == static_cast<T>(0)) {
+      if(alpha == static_cast<T>(1))
+        this->execute_(px,py,detail::__assign_op());
+      else
+        this->execute_(px,py,detail::__scal_op<T>{alpha});
+    }
+    else {
+      this->execute_(px,py,detail::__axpby_op<T>{alpha,beta});
+    }
+  }
+
+  /// carry out permutation in place, w/o full-size temporary
+  /// square 2D transpose is done by swapping tiles, otherwise permutation cycles are followed with a bitmap,
+  /// which is much slower than execute() but requires only size/64 words of extra memory
+  /// NOTE: the plan must be made from contiguous stride of x
+  void execute_inplace (T* px) const
+  {
+    switch(kernel_) {
+      case Copy:
+        break;
+      case Strided:
+        detail::__reindex_inplace_cycle(px,ext_,str_x_,str_y_,ext_.back());
+        break;
+      case Transpose:
+        if(ext_[0] == ext_[1])
+          detail::__reindex_inplace_square(px,ext_[0]);
+        else
+          detail::__reindex_inplace_cycle(px,ext_,str_x_,str_y_,1ul);
+        break;
+      case Blocked:
+        detail::__reindex_inplace_cycle(px,ext_,str_x_,str_y_,1ul);
+        break;
+    }
+  }
+
+  /// return selected kernel
+  kernel_type kernel () const { return kernel_; }
+
+  /// return rank after index fusion
+  size_t fused_rank () const { return ext_.size(); }
+
+  /// return number of elements
+  size_t size () const { return size_; }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  /// return a cached plan for (ext_x, idx), the plan is created upon the first call
+  /// NOTE: the cache is thread-local and holds at most _BTAS_PERMUTE_PLAN_CACHE_SIZE plans, the least recently used plan is evicted first,
+  ///       the reference is valid until clear_cache() or clear_plan_caches() is called, or _BTAS_PERMUTE_PLAN_CACHE_SIZE other plans are created in the same thread
+  template<class Index>
+  static const PermutePlan& get (const extent_type& ext_x, const Index& idx)
+  {
+    index_type idx_(ext_x);
+    BTAS_assert(idx.size() == idx_.size(),"PermutePlan::get, detected inconsistent size of argument.");
+    std::copy(idx.begin(),idx.end(),idx_.begin());
+
+    cache_type& cache = PermutePlan::cache_();
+    key_type key(ext_x,idx_);
+    const PermutePlan* plan = cache.find(key);
+    if(plan) return *plan;
+    return cache.insert(key,PermutePlan(ext_x,idx_));
+  }
+
+  /// release cached plans in the calling thread
+  static void clear_cache () { PermutePlan::cache_().clear(); }
+
+  /// return number of cached plans in the calling thread
+  static size_t cache_size () { return PermutePlan::cache_().size(); }
+
+private:
+
+  /// carry out permutation with element-wise operation op(y,x)
+  template<class Op_>
+  void execute_ (const T* px, T* py, const Op_& op) const
+  {
+    switch(kernel_) {
+      case Copy:
+        detail::__copy_block(px,1ul,py,size_,op);
+        break;
+      case Strided:
+        detail::__reindex_strided(px,py,ext_,str_x_,str_y_,op);
+        break;
+      case Transpose:
+      case Blocked:
+        detail::__reindex_tiled(px,py,ext_,str_x_,str_y_,p_,op);
+        break;
+    }
+  }
+
+  typedef std::pair<extent_type,index_type> key_type;
+
+  typedef detail::__plan_cache<key_type,PermutePlan> cache_type;
+
+  static cache_type& cache_ ()
+  {
+    static thread_local cache_type cache(PermutePlan::tag_(),_BTAS_PERMUTE_PLAN_CACHE_SIZE);
+    return cache;
+  }
+
+  /// tag to identify caches owned by this class
+  static const void* tag_ ()
+  {
+    static const char tag = 0;
+    return &tag;
+  }
+
+  //  Members
+
+  kernel_type kernel_; ///< selected kernel
+
+  size_t size_; ///< number of elements
+
+  size_t p_; ///< fastest index of x (after reordering)
+
+  std::vector<size_t> ext_; ///< fused extent in the order of loops (row-major)
+
+  std::vector<size_t> str_x_; ///< fused stride of x in the order of loops
+
+  std::vector<size_t> str_y_; ///< fused stride of y in the order of loops
+
+}; // class PermutePlan<T,N,Layout>
+
+} // namespace btas
+
+#endif // __BTAS_PERMUTE_PLAN_HPP
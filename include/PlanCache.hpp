@@ -0,0 +1,133 @@
+#ifndef __BTAS_PLAN_CACHE_HPP
+#define __BTAS_PLAN_CACHE_HPP
+
+#include <vector>
+#include <map>
+#include <utility> // std::pair, std::move
+#include <algorithm> // std::find, std::max
+
+/// max. number of plans cached in each thread for each type of PermutePlan (at least 1)
+#ifndef _BTAS_PERMUTE_PLAN_CACHE_SIZE
+#define _BTAS_PERMUTE_PLAN_CACHE_SIZE 64ul
+#endif
+
+/// max. number of plans cached in each thread for each type of ContractPlan and symbols (at least 1)
+#ifndef _BTAS_CONTRACT_PLAN_CACHE_SIZE
+#define _BTAS_CONTRACT_PLAN_CACHE_SIZE 64ul
+#endif
+
+namespace btas {
+
+namespace detail {
+
+/// base of thread-local plan caches, which are registered to be cleared by clear_plan_caches()
+class __plan_cache_base {
+
+public:
+
+  /// register this cache to the registry of the calling thread
+  explicit
+  __plan_cache_base (const void* owner) : owner_(owner) { registry_().push_back(this); }
+
+  /// unregister this cache
+  virtual
+ ~__plan_cache_base ()
+  {
+    std::vector<__plan_cache_base*>& r = registry_();
+    r.erase(std::find(r.begin(),r.end(),this));
+  }
+
+  /// release all plans
+  virtual void clear () = 0;
+
+  /// clear caches of the calling thread, which are owned by owner (all caches if owner is nullptr)
+  static void clear_all (const void* owner = nullptr)
+  {
+    std::vector<__plan_cache_base*>& r = registry_();
+    for(size_t i = 0; i < r.size(); ++i)
+      if(owner == nullptr || r[i]->owner_ == owner) r[i]->clear();
+  }
+
+private:
+
+  __plan_cache_base (const __plan_cache_base&) = delete;
+
+  __plan_cache_base& operator= (const __plan_cache_base&) = delete;
+
+  /// caches of the calling thread
+  /// NOTE: the registry is constructed before, thus destroyed after, any thread-local cache
+  static std::vector<__plan_cache_base*>& registry_ ()
+  {
+    static thread_local std::vector<__plan_cache_base*> registry;
+    return registry;
+  }
+
+  const void* owner_; ///< tag of the class which owns this cache
+
+};
+
+/// thread-local cache of plans w/ LRU eviction, which holds at most capacity plans
+/// a reference to a cached plan is valid until it is evicted, i.e. capacity other plans are inserted, or the cache is cleared
+template<class Key, class Plan>
+class __plan_cache : public __plan_cache_base {
+
+public:
+
+  __plan_cache (const void* owner, size_t capacity)
+  : __plan_cache_base(owner), capacity_(std::max(capacity,1ul)), tick_(0)
+  { }
+
+  /// return a key owned by the cache, which is assigned before find() to reuse its storage,
+  /// i.e. no heap allocation is done for keys holding std::vector upon a hit, and the key is copied only upon insert
+  Key& probe () { return probe_; }
+
+  /// return the cached plan for key, or nullptr if not found
+  const Plan* find (const Key& key)
+  {
+    typename map_type::iterator it = map_.find(key);
+    if(it == map_.end()) return nullptr;
+    it->second.second = ++tick_;
+    return &it->second.first;
+  }
+
+  /// insert plan for key, the least recently used plan is evicted if the cache is full
+  const Plan& insert (const Key& key, Plan&& plan)
+  {
+    if(map_.size() >= capacity_) {
+      // NOTE: linear search is done only upon a miss, which is much cheaper than the analysis of a new plan
+      typename map_type::iterator lru = map_.begin();
+      for(typename map_type::iterator it = map_.begin(); it != map_.end(); ++it)
+        if(it->second.second < lru->second.second) lru = it;
+      map_.erase(lru);
+    }
+    return map_.insert(std::make_pair(key,std::make_pair(std::move(plan),++tick_))).first->second.first;
+  }
+
+  /// release all plans
+  void clear () { map_.clear(); }
+
+  /// return number of cached plans
+  size_t size () const { return map_.size(); }
+
+private:
+
+  typedef std::map<Key,std::pair<Plan,size_t>> map_type;
+
+  map_type map_; ///< plans w/ time of last use
+
+  Key probe_; ///< key for lookup
+
+  size_t capacity_; ///< max. number of plans
+
+  size_t tick_; ///< counter of uses
+
+};
+
+} // namespace detail
+
+/// release cached plans of PermutePlan and ContractPlan of all types in the calling thread
+inline void clear_plan_caches () { detail::__plan_cache_base::clear_all(); }
+
+} // namespace btas
+
+#endif // __BTAS_PLAN_CACHE_HPP
@@ -2,11 +2,14 @@
 #define __BTAS_TENSOR_HPP
 
 #include <vector>
+#include <memory> // std::allocator
 #include <algorithm> // std::fill
 #include <functional> // std::bind, std::ref, std::cref
 #include <type_traits> // std::enable_if
+#include <utility> // std::move
 
 #include <blas.h>
+#include <allocator.hpp>
 #include <TensorBase.hpp>
 #include <IndexedFor.hpp>
 
@@ -30,7 +33,10 @@ void AssignTensor_ (const Idx_& index, const T1& x, T2& y) { y(index) = x(index)
 
 } // namespace detail
 
-template<typename T, size_t N, CBLAS_LAYOUT Layout = CblasRowMajor>
+/// Dense tensor which owns its data
+/// Allocator gives memory of data (see allocator.hpp for aligned, huge-page and NUMA-aware allocators),
+/// which is value-initialized by constructors and resize() w/ extent, but not by resize_uninitialized()
+template<typename T, size_t N, CBLAS_LAYOUT Layout = CblasRowMajor, class Allocator = std::allocator<T>>
 class Tensor : public TensorBase<T,N,Layout> {
 
   typedef TensorBase<T,N,Layout> base_;
@@ -52,6 +58,7 @@ public:
   typedef typename base_::ordinal_type ordinal_type;
   typedef typename base_::iterator iterator;
   typedef typename base_::const_iterator const_iterator;
+  typedef Allocator allocator_type;
 
   // ---------------------------------------------------------------------------------------------------- 
 
@@ -65,7 +72,7 @@ public:
   Tensor (const extent_type& ext)
   {
     base_::reset_tn_stride_(ext);
-    store_.resize(tn_stride_.size());
+    store_.resize(tn_stride_.size(),value_type());
     start_ = store_.data();
     finish_ = start_+store_.size();
   }
@@ -75,7 +82,7 @@ public:
   Tensor (const size_t& i, const Args&... args)
   {
     base_::reset_tn_stride_(i,args...);
-    store_.resize(tn_stride_.size());
+    store_.resize(tn_stride_.size(),value_type());
     start_ = store_.data();
     finish_ = start_+store_.size();
   }
@@ -117,6 +124,42 @@ public:
     finish_ = start_+store_.size();
   }
 
+  /// move from a Tensor object, which takes over data w/o copy and leaves x empty
+  Tensor (Tensor&& x) noexcept
+  : store_(std::move(x.store_))
+  {
+    tn_stride_.swap(x.tn_stride_);
+    start_ = x.start_;
+    finish_ = x.finish_;
+    x.start_ = nullptr;
+    x.finish_ = nullptr;
+  }
+
+  /// move from a Tensor object of another rank w/ new extent of the same size (see reshape),
+  /// which takes over data w/o copy and leaves x empty
+  template<size_t K>
+  Tensor (Tensor<T,K,Layout,Allocator>&& x, const extent_type& ext)
+  {
+    base_::reset_tn_stride_(ext);
+    BTAS_assert(tn_stride_.size() == x.size(),"Tensor, detected inconsistent size of new extent.");
+    store_.swap(x.store_);
+    start_ = store_.data();
+    finish_ = start_+store_.size();
+    x.clear();
+  }
+
+  /// from a Tensor object w/ another allocator
+  template<class A>
+  Tensor (const Tensor<T,N,Layout,A>& x)
+  {
+    base_::reset_tn_stride_(x.extent());
+    store_.resize(x.size());
+    start_ = store_.data();
+    finish_ = start_+store_.size();
+    //
+    copy(x.size(),x.data(),1,start_,1);
+  }
+
   /// from a TensorBase object
   Tensor (const TensorBase<T,N,Layout>& x)
   {
@@ -197,6 +240,27 @@ public:
     return *this;
   }
 
+  /// move from a Tensor object, old data are deallocated and x becomes empty
+  Tensor& operator= (Tensor&& x) noexcept
+  {
+    Tensor(std::move(x)).swap(*this);
+    return *this;
+  }
+
+  /// from a Tensor object w/ another allocator
+  template<class A>
+  Tensor& operator= (const Tensor<T,N,Layout,A>& x)
+  {
+    base_::reset_tn_stride_(x.extent());
+    store_.resize(x.size());
+    start_ = store_.data();
+    finish_ = start_+store_.size();
+    //
+    copy(x.size(),x.data(),1,start_,1);
+    //
+    return *this;
+  }
+
   /// from a TensorBase object
   Tensor& operator= (const TensorBase<T,N,Layout>& x)
   {
@@ -257,7 +321,7 @@ public:
   void resize (const extent_type& ext)
   {
     base_::reset_tn_stride_(ext);
-    store_.resize(tn_stride_.size());
+    store_.resize(tn_stride_.size(),value_type());
     start_ = store_.data();
     finish_ = start_+store_.size();
   }
@@ -276,11 +340,53 @@ public:
   void resize (const size_t& i, const Args&... args)
   {
     base_::reset_tn_stride_(i,args...);
+    store_.resize(tn_stride_.size(),value_type());
+    start_ = store_.data();
+    finish_ = start_+store_.size();
+  }
+
+  /// resize by extent w/o initialization of data, which is to be overwritten, e.g. by GEMM w/ beta = 0 or permutation
+  /// neither old data are kept if reallocated, nor new buffer is filled, which also lets threads writing it first own its pages
+  void resize_uninitialized (const extent_type& ext)
+  {
+    base_::reset_tn_stride_(ext);
+    if(tn_stride_.size() > store_.capacity()) store_type().swap(store_);
     store_.resize(tn_stride_.size());
     start_ = store_.data();
     finish_ = start_+store_.size();
   }
 
+  /// resize by variadic arguments list w/o initialization of data
+  template<typename... Args>
+  void resize_uninitialized (const size_t& i, const Args&... args)
+  {
+    base_::reset_tn_stride_(i,args...);
+    if(tn_stride_.size() > store_.capacity()) store_type().swap(store_);
+    store_.resize(tn_stride_.size());
+    start_ = store_.data();
+    finish_ = start_+store_.size();
+  }
+
+  // ---------------------------------------------------------------------------------------------------- 
+
+  // reshape
+
+  /// reshape in place by extent of the same size, which only changes extent and stride (no copy)
+  void reshape (const extent_type& ext)
+  {
+    size_t n = (ext.size() > 0) ? 1ul : 0ul;
+    for(size_t i = 0; i < ext.size(); ++i) n *= ext[i];
+    BTAS_assert(n == this->size(),"Tensor::reshape, detected inconsistent size of new extent.");
+    base_::reset_tn_stride_(ext);
+  }
+
+  /// reshape in place by variadic arguments list
+  template<typename... Args>
+  void reshape (const size_t& i, const Args&... args)
+  {
+    this->reshape(make_array<typename extent_type::value_type>(i,args...));
+  }
+
   // ---------------------------------------------------------------------------------------------------- 
 
   // other functions
@@ -321,15 +427,19 @@ private:
 
   // members
 
-  std::vector<value_type> store_; /// data is stored as 1d-array
+  template<typename U, size_t K, CBLAS_LAYOUT L, class A> friend class Tensor;
 
-}; // class Tensor<T, N, Layout>
+  typedef std::vector<value_type,detail::__default_init_allocator<Allocator>> store_type;
+
+  store_type store_; /// data is stored as 1d-array
+
+}; // class Tensor<T, N, Layout, Allocator>
 
 // ==================================================================================================== 
 
 /// Variable rank tensor
-template<typename T, CBLAS_LAYOUT Layout>
-class Tensor<T,0ul,Layout> : public TensorBase<T,0ul,Layout> {
+template<typename T, CBLAS_LAYOUT Layout, class Allocator>
+class Tensor<T,0ul,Layout,Allocator> : public TensorBase<T,0ul,Layout> {
 
   typedef TensorBase<T,0ul,Layout> base_;
 
@@ -350,6 +460,7 @@ public:
   typedef typename base_::ordinal_type ordinal_type;
   typedef typename base_::iterator iterator;
   typedef typename base_::const_iterator const_iterator;
+  typedef Allocator allocator_type;
 
   // ---------------------------------------------------------------------------------------------------- 
 
@@ -363,7 +474,7 @@ public:
   Tensor (const extent_type& ext)
   {
     base_::reset_tn_stride_(ext);
-    store_.resize(tn_stride_.size());
+    store_.resize(tn_stride_.size(),value_type());
     start_ = store_.data();
     finish_ = start_+store_.size();
   }
@@ -373,7 +484,7 @@ public:
   Tensor (const size_t& i, const Args&... args)
   {
     base_::reset_tn_stride_(i,args...);
-    store_.resize(tn_stride_.size());
+    store_.resize(tn_stride_.size(),value_type());
     start_ = store_.data();
     finish_ = start_+store_.size();
   }
@@ -415,6 +526,42 @@ public:
     finish_ = start_+store_.size();
   }
 
+  /// move from a Tensor object, which takes over data w/o copy and leaves x empty
+  Tensor (Tensor&& x) noexcept
+  : store_(std::move(x.store_))
+  {
+    tn_stride_.swap(x.tn_stride_);
+    start_ = x.start_;
+    finish_ = x.finish_;
+    x.start_ = nullptr;
+    x.finish_ = nullptr;
+  }
+
+  /// move from a Tensor object of another rank w/ new extent of the same size (see reshape),
+  /// which takes over data w/o copy and leaves x empty
+  template<size_t K>
+  Tensor (Tensor<T,K,Layout,Allocator>&& x, const extent_type& ext)
+  {
+    base_::reset_tn_stride_(ext);
+    BTAS_assert(tn_stride_.size() == x.size(),"Tensor, detected inconsistent size of new extent.");
+    store_.swap(x.store_);
+    start_ = store_.data();
+    finish_ = start_+store_.size();
+    x.clear();
+  }
+
+  /// from a Tensor object w/ another allocator
+  template<class A>
+  Tensor (const Tensor<T,0ul,Layout,A>& x)
+  {
+    base_::reset_tn_stride_(x.extent());
+    store_.resize(x.size());
+    start_ = store_.data();
+    finish_ = start_+store_.size();
+    //
+    copy(x.size(),x.data(),1,start_,1);
+  }
+
   /// from a TensorBase object
   Tensor (const TensorBase<T,0ul,Layout>& x)
   {
@@ -497,6 +644,27 @@ public:
     return *this;
   }
 
+  /// move from a Tensor object, old data are deallocated and x becomes empty
+  Tensor& operator= (Tensor&& x) noexcept
+  {
+    Tensor(std::move(x)).swap(*this);
+    return *this;
+  }
+
+  /// from a Tensor object w/ another allocator
+  template<class A>
+  Tensor& operator= (const Tensor<T,0ul,Layout,A>& x)
+  {
+    base_::reset_tn_stride_(x.extent());
+    store_.resize(x.size());
+    start_ = store_.data();
+    finish_ = start_+store_.size();
+    //
+    copy(x.size(),x.data(),1,start_,1);
+    //
+    return *this;
+  }
+
   /// from a TensorBase object
   Tensor& operator= (const TensorBase<T,0ul,Layout>& x)
   {
@@ -559,7 +727,7 @@ public:
   void resize (const extent_type& ext)
   {
     base_::reset_tn_stride_(ext);
-    store_.resize(tn_stride_.size());
+    store_.resize(tn_stride_.size(),value_type());
     start_ = store_.data();
     finish_ = start_+store_.size();
   }
@@ -578,6 +746,28 @@ public:
   void resize (const size_t& i, const Args&... args)
   {
     base_::reset_tn_stride_(i,args...);
+    store_.resize(tn_stride_.size(),value_type());
+    start_ = store_.data();
+    finish_ = start_+store_.size();
+  }
+
+  /// resize by extent w/o initialization of data, which is to be overwritten, e.g. by GEMM w/ beta = 0 or permutation
+  /// neither old data are kept if reallocated, nor new buffer is filled, which also lets threads writing it first own its pages
+  void resize_uninitialized (const extent_type& ext)
+  {
+    base_::reset_tn_stride_(ext);
+    if(tn_stride_.size() > store_.capacity()) store_type().swap(store_);
+    store_.resize(tn_stride_.size());
+    start_ = store_.data();
+    finish_ = start_+store_.size();
+  }
+
+  /// resize by variadic arguments list w/o initialization of data
+  template<typename... Args>
+  void resize_uninitialized (const size_t& i, const Args&... args)
+  {
+    base_::reset_tn_stride_(i,args...);
+    if(tn_stride_.size() > store_.capacity()) store_type().swap(store_);
     store_.resize(tn_stride_.size());
     start_ = store_.data();
     finish_ = start_+store_.size();
@@ -585,6 +775,19 @@ public:
 
   // ---------------------------------------------------------------------------------------------------- 
 
+  // reshape
+
+  /// reshape in place by extent of the same size, which only changes extent and stride (no copy)
+  void reshape (const extent_type& ext)
+  {
+    size_t n = (ext.size() > 0) ? 1ul : 0ul;
+    for(size_t i = 0; i < ext.size(); ++i) n *= ext[i];
+    BTAS_assert(n == this->size(),"Tensor::reshape, detected inconsistent size of new extent.");
+    base_::reset_tn_stride_(ext);
+  }
+
+  // ---------------------------------------------------------------------------------------------------- 
+
   // other functions
 
   /// swap objects
@@ -623,9 +826,13 @@ private:
 
   // members
 
-  std::vector<value_type> store_; /// data is stored as 1d-array
+  template<typename U, size_t K, CBLAS_LAYOUT L, class A> friend class Tensor;
+
+  typedef std::vector<value_type,detail::__default_init_allocator<Allocator>> store_type;
+
+  store_type store_; /// data is stored as 1d-array
 
-}; // class Tensor<T, 0ul, Layout>
+}; // class Tensor<T, 0ul, Layout, Allocator>
 
 // ---------------------------------------------------------------------------------------------------- 
 
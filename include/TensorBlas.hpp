@@ -30,10 +30,10 @@ void copy (const TensorBase<T,M,Layout>& x, TensorBase<T,N,Layout>& y)
 }
 
 /// deep copy with initializing y
-template<typename T, size_t N, CBLAS_LAYOUT Layout>
-void copy (const TensorBase<T,N,Layout>& x, Tensor<T,N,Layout>& y)
+template<typename T, size_t N, CBLAS_LAYOUT Layout, class AllocY>
+void copy (const TensorBase<T,N,Layout>& x, Tensor<T,N,Layout,AllocY>& y)
 {
-  y.resize(x.extent());
+  y.resize_uninitialized(x.extent());
   copy(x.size(),x.data(),1,y.data(),1);
 }
 
@@ -57,8 +57,8 @@ void axpy (const U& alpha, const TensorBase<T,M,Layout>& x, TensorBase<T,N,Layou
 }
 
 /// axpy with initializing y if necessary
-template<typename U, typename T, size_t N, CBLAS_LAYOUT Layout>
-void axpy (const U& alpha, const TensorBase<T,N,Layout>& x, Tensor<T,N,Layout>& y)
+template<typename U, typename T, size_t N, CBLAS_LAYOUT Layout, class AllocY>
+void axpy (const U& alpha, const TensorBase<T,N,Layout>& x, Tensor<T,N,Layout,AllocY>& y)
 {
   if(y.empty())
     y.resize(x.extent(),T(0));
@@ -330,11 +330,18 @@ struct blasWrapper_<M,N,0ul> {
     const T& beta,
           TensorBase<T,M+N,Layout>& c)
   {
-    scal(beta,c); ger(alpha,a,b,c);
+    // c is not read if beta == 0, i.e. it may be uninitialized (NaN * 0 stays NaN in scal)
+    if(beta == static_cast<T>(0))
+      std::fill(c.data(),c.data()+c.size(),static_cast<T>(0));
+    else
+      scal(beta,c);
+    ger(alpha,a,b,c);
   }
 };
 
-/// gemm
+/// dynamic rank, the kernel is chosen by ranks at runtime
+/// NOTE: full contraction (dot) is stored in c of extent {1}, since a tensor of dynamic rank w/o index has no element,
+///       c must be sized in advance, since its extent cannot be changed through TensorBase
 template<>
 struct blasWrapper_<0ul,0ul,0ul> {
   template<typename T, CBLAS_LAYOUT Layout>
@@ -347,8 +354,33 @@ struct blasWrapper_<0ul,0ul,0ul> {
     const T& beta,
           TensorBase<T,0ul,Layout>& c)
   {
-    // TODO: implement any cases
-    gemm(transa,transb,alpha,a,b,beta,c);
+    const size_t l = a.extent().size();
+    const size_t m = b.extent().size();
+    const size_t n = c.extent().size();
+
+    BTAS_assert(n > 0,"failed by empty c of dynamic rank, which must have extent {1} for full contraction.");
+
+    /**/ if(l == m && n == 1 && c.size() == 1 && a.size() == b.size()) {
+      BTAS_assert(std::equal(a.extent().begin(),a.extent().end(),b.extent().begin()),"failed by inconsistent extents (a vs b).");
+      c.data()[0] = (beta == static_cast<T>(0)) ? alpha*dot(a.size(),a.data(),1,b.data(),1)
+                                                : alpha*dot(a.size(),a.data(),1,b.data(),1)+beta*c.data()[0];
+      return;
+    }
+
+    BTAS_assert(l+m >= n && (l+m-n)%2 == 0,"failed by inconsistent ranks of a, b and c.");
+    const size_t k = (l+m-n)/2;
+
+    /**/ if(k == m) gemv(transa,alpha,a,b,beta,c);
+    else if(k == l) gemv(transb,alpha,b,a,beta,c);
+    else if(k == 0) {
+      // c is not read if beta == 0 (see blasWrapper_<M,N,0>)
+      if(beta == static_cast<T>(0))
+        std::fill(c.data(),c.data()+c.size(),static_cast<T>(0));
+      else
+        scal(beta,c);
+      ger(alpha,a,b,c);
+    }
+    else            gemm(transa,transb,alpha,a,b,beta,c);
   }
 };
 
@@ -2,52 +2,183 @@
 #define __BTAS_TENSOR_CONTRACT_HPP
 
 #include <array>
+#include <vector>
+#include <algorithm> // std::find, std::equal
 
 #include <Tensor.hpp>
-#include <TensorPermute.hpp>
+#include <TensorBlas.hpp>
+#include <permute.hpp>
 
 #include <contract_helper.hpp>
+#include <symbols.hpp>
+#include <ContractPlan.hpp>
+
+// define _BTAS_CONTRACT_PLAN_CACHE to carry out contract() with index symbols by a cached ContractPlan,
+// which skips parsing symbols and analyzing permutations for repeated calls of the same shape.
 
 namespace btas {
 
 /// tensor trace function called with indices to be contracted
-template<typename T, size_t L, size_t M, size_t N, CBLAS_LAYOUT Layout, class Index>
+template<typename T, size_t L, size_t M, size_t N, CBLAS_LAYOUT Layout, class Index, class AllocA, class AllocB, class AllocC>
 void contract (
   const T& alpha,
-  const Tensor<T,L,Layout>& a, const Index& idxa,
-  const Tensor<T,M,Layout>& b, const Index& idxb,
+  const Tensor<T,L,Layout,AllocA>& a, const Index& idxa,
+  const Tensor<T,M,Layout,AllocB>& b, const Index& idxb,
   const T& beta,
-        Tensor<T,N,Layout>& c)
+        Tensor<T,N,Layout,AllocC>& c)
 {
-  contract_helper<Tensor<T,L,Layout>,Tensor<T,M,Layout>,Index> helper(a,idxa,b,idxb);
-  blasCall(helper.transa(),helper.transb(),alpha,helper.get_a(),helper.get_b(),beta,c);
+  // extent of c: free indices of a followed by free indices of b
+  typename Tensor<T,N,Layout>::extent_type extc;
+  size_t n = 0;
+  for(size_t i = 0; i < L; ++i)
+    if(std::find(idxa.begin(),idxa.end(),i) == idxa.end()) extc[n++] = a.extent(i);
+  for(size_t i = 0; i < M; ++i)
+    if(std::find(idxb.begin(),idxb.end(),i) == idxb.end()) extc[n++] = b.extent(i);
+
+  // c is overwritten w/o initialization if empty
+  const bool is_empty = c.empty();
+  if(is_empty)
+    c.resize_uninitialized(extc);
+  else
+    BTAS_assert(std::equal(extc.begin(),extc.end(),c.extent().begin()),"contract, detected inconsistent extents (a*b vs c).");
+  const T betac = is_empty ? static_cast<T>(0) : beta;
+
+  // strided batch of GEMMs if it is cheaper than permutation + GEMM
+  contract_batch_helper<Layout> batch(a.extent(),idxa,b.extent(),idxb,sizeof(T));
+  if(batch.enabled()) {
+    batch.call(alpha,a.data(),b.data(),betac,c.data());
+    return;
+  }
+
+  contract_helper<Tensor<T,L,Layout,AllocA>,Tensor<T,M,Layout,AllocB>,Index> helper(a,idxa,b,idxb);
+  blasCall(helper.transa(),helper.transb(),alpha,helper.get_a(),helper.get_b(),betac,c);
+}
+
+/// tensor trace function for dynamic rank called with indices to be contracted
+/// indices are converted to symbols, s.t. c has free indices of a followed by those of b, and carried out by ContractPlan,
+/// which dispatches to DOT, GEMV, GEMV^T, GER, GEMM or batched GEMM by ranks and extents given at runtime.
+/// NOTE: if all indices are contracted, the result is stored in c of extent {1}
+template<typename T, CBLAS_LAYOUT Layout, class Index, class AllocA, class AllocB, class AllocC>
+void contract (
+  const T& alpha,
+  const Tensor<T,0ul,Layout,AllocA>& a, const Index& idxa,
+  const Tensor<T,0ul,Layout,AllocB>& b, const Index& idxb,
+  const T& beta,
+        Tensor<T,0ul,Layout,AllocC>& c)
+{
+  const size_t L = a.extent().size();
+  const size_t M = b.extent().size();
+  BTAS_assert(idxa.size() == idxb.size(),"contract, detected inconsistent number of contraction indices.");
+
+  // symbol of a's i-th index is i, and that of b's free j-th index is L+j
+  std::vector<size_t> symba(L);
+  for(size_t i = 0; i < L; ++i) symba[i] = i;
+  std::vector<size_t> symbb(M);
+  for(size_t j = 0; j < M; ++j) symbb[j] = L+j;
+  for(size_t i = 0; i < idxa.size(); ++i) {
+    BTAS_assert(idxa[i] < L && idxb[i] < M,"contract, detected out of range contraction index.");
+    symbb[idxb[i]] = idxa[i];
+  }
+  std::vector<size_t> symbc;
+  for(size_t i = 0; i < L; ++i)
+    if(std::find(idxa.begin(),idxa.end(),i) == idxa.end()) symbc.push_back(i);
+  for(size_t j = 0; j < M; ++j)
+    if(std::find(idxb.begin(),idxb.end(),j) == idxb.end()) symbc.push_back(L+j);
+
+  ContractPlan<T,0ul,0ul,0ul,Layout>(a.extent(),symba,b.extent(),symbb,symbc).execute(alpha,a,b,beta,c);
 }
 
 /// tensor trace function called with index symbols of tensors
-template<typename T, size_t L, size_t M, size_t N, CBLAS_LAYOUT Layout, class SymbolA, class SymbolB, class SymbolC>
+/// dynamic rank, i.e. Tensor<T,0,Layout>, is also acceptable (see ContractPlan)
+/// conj specifies complex conjugation of a and/or b, e.g. c = conj(a) * b for ConjA (see ContractConj)
+template<typename T, size_t L, size_t M, size_t N, CBLAS_LAYOUT Layout, class SymbolA, class SymbolB, class SymbolC, class AllocA, class AllocB, class AllocC>
+void contract (
+  const T& alpha,
+  const Tensor<T,L,Layout,AllocA>& a, const SymbolA& symba,
+  const Tensor<T,M,Layout,AllocB>& b, const SymbolB& symbb,
+  const T& beta,
+        Tensor<T,N,Layout,AllocC>& c, const SymbolC& symbc, ContractConj conj = ConjNone)
+{
+#ifdef _BTAS_CONTRACT_PLAN_CACHE
+  ContractPlan<T,L,M,N,Layout>::get(a.extent(),symba,b.extent(),symbb,symbc,conj).execute(alpha,a,b,beta,c);
+#else
+  // which of a, b and a*b to permute is chosen by the cost model (see make_contract_layout)
+  ContractPlan<T,L,M,N,Layout>(a.extent(),symba,b.extent(),symbb,symbc,conj).execute(alpha,a,b,beta,c);
+#endif
+}
+
+/// tensor trace function called with index symbols given at compile time
+/// e.g. contract(1.0,a,symbols<'i','p','j'>(),b,symbols<'p','k'>(),0.0,c,symbols<'i','j','k'>())
+/// if a and b are already in matrix form, GEMM is called directly w/o parsing symbols nor allocating temporaries,
+/// which writes into c directly also if free indices of b come first in c, i.e. c = (b^T * a^T)^T
+/// conjugation of a transposed operand is passed to GEMM as CblasConjTrans, otherwise it is carried out by ContractPlan
+/// otherwise, the contraction is carried out by a cached ContractPlan (see ContractPlan::get), i.e. symbols are analyzed once for each extent
+template<typename T, size_t L, size_t M, size_t N, CBLAS_LAYOUT Layout, class AllocA, class AllocB, class AllocC, char... As, char... Bs, char... Cs>
 void contract (
   const T& alpha,
-  const Tensor<T,L,Layout>& a, const SymbolA& symba,
-  const Tensor<T,M,Layout>& b, const SymbolB& symbb,
+  const Tensor<T,L,Layout,AllocA>& a, const symbols<As...>&,
+  const Tensor<T,M,Layout,AllocB>& b, const symbols<Bs...>&,
   const T& beta,
-        Tensor<T,N,Layout>& c, const SymbolC& symbc)
+        Tensor<T,N,Layout,AllocC>& c, const symbols<Cs...>&, ContractConj conj = ConjNone)
 {
-  const size_t K = (L+M-N)/2;
+  typedef contract_symbols<symbols<As...>,symbols<Bs...>,symbols<Cs...>> info;
+
+  static_assert(L == sizeof...(As) && M == sizeof...(Bs) && N == sizeof...(Cs),"contract, detected inconsistent rank of tensor and symbols.");
+
+  // trans flags of a and b passed to GEMM, i.e. flipped if c is swapped
+  const bool conja = is_complex<T>::value && (conj & ConjA);
+  const bool conjb = is_complex<T>::value && (conj & ConjB);
+  const bool is_a_trans = info::is_c_swapped ? (info::transa == CblasNoTrans) : (info::transa != CblasNoTrans);
+  const bool is_b_trans = info::is_c_swapped ? (info::transb == CblasNoTrans) : (info::transb != CblasNoTrans);
+
+  if(info::is_matrix && (!info::is_c_permuted || info::is_c_swapped) && (!conja || is_a_trans) && (!conjb || is_b_trans)) {
+    const std::array<size_t,info::K> idxa = info::idxa::array();
+    const std::array<size_t,info::K> idxb = info::idxb::array();
+    const std::array<size_t,N> idxc = info::extc::array();
+
+    typename Tensor<T,N,Layout>::extent_type extc;
+    for(size_t i = 0; i < N; ++i) extc[i] = (idxc[i] < L) ? a.extent(idxc[i]) : b.extent(idxc[i]-L);
+
+    // c is overwritten w/o initialization if empty
+    const bool is_empty = c.empty();
+    if(is_empty)
+      c.resize_uninitialized(extc);
+    else
+      BTAS_assert(std::equal(extc.begin(),extc.end(),c.extent().begin()),"contract, detected inconsistent extents (a*b vs c).");
+    const T betac = is_empty ? static_cast<T>(0) : beta;
+
+    size_t k = 1;
+    for(size_t i = 0; i < info::K; ++i) {
+      BTAS_assert(a.extent(idxa[i]) == b.extent(idxb[i]),"contract, detected inconsistent extents (a vs b).");
+      k *= a.extent(idxa[i]);
+    }
+    size_t m = 1;
+    size_t n = 1;
+    for(size_t i = 0; i < N; ++i) {
+      if(idxc[i] < L) m *= extc[i];
+      else            n *= extc[i];
+    }
 
-  std::array<size_t,K> idxa;
-  std::array<size_t,K> idxb;
-  SymbolC symbaxb;
+    const size_t lda = ((Layout == CblasRowMajor) ^ (info::transa == CblasNoTrans)) ? m : k;
+    const size_t ldb = ((Layout == CblasRowMajor) ^ (info::transb == CblasNoTrans)) ? k : n;
 
-  parse_contract_symbols(symba,symbb,idxa,idxb,symbaxb);
+    const CBLAS_TRANSPOSE transa = is_a_trans ? (conja ? CblasConjTrans : CblasTrans) : CblasNoTrans;
+    const CBLAS_TRANSPOSE transb = is_b_trans ? (conjb ? CblasConjTrans : CblasTrans) : CblasNoTrans;
 
-  if(std::equal(symbc.begin(),symbc.end(),symbaxb.begin())) {
-    contract(alpha,a,idxa,b,idxb,beta,c);
+    if(info::is_c_swapped) {
+      // c = (b^T * a^T)^T, i.e. c is n x m
+      const size_t ldc = (Layout == CblasRowMajor) ? m : n;
+      gemm(Layout,transb,transa,n,m,k,alpha,b.data(),ldb,a.data(),lda,betac,c.data(),ldc);
+    }
+    else {
+      const size_t ldc = (Layout == CblasRowMajor) ? n : m;
+      gemm(Layout,transa,transb,m,n,k,alpha,a.data(),lda,b.data(),ldb,betac,c.data(),ldc);
+    }
   }
   else {
-    Tensor<T,N,Layout> axb;
-    if(!c.empty()) permute(c,symbc,axb,symbaxb);
-    contract(alpha,a,idxa,b,idxb,beta,axb);
-    permute(axb,symbaxb,c,symbc);
+    // permutation is chosen by the cost model, which is analyzed only once for each extent of a and b,
+    // since the cache of plans for a given set of symbols is keyed only by extents (and conj), it is always enabled
+    ContractPlan<T,L,M,N,Layout>::get(a.extent(),symbols<As...>::array(),b.extent(),symbols<Bs...>::array(),symbols<Cs...>::array(),conj).execute(alpha,a,b,beta,c);
   }
 }
 
@@ -8,7 +8,13 @@
 #include <TensorLapack.hpp>
 
 #include <permute.hpp>
+#include <reshape.hpp>
+#include <gesvd_randomized.hpp>
+#include <TensorContract.hpp>
+#include <ContractBatch.hpp>
+#include <ContractNetwork.hpp>
 #include <slice.hpp>
 #include <tie.hpp>
+#include <trace.hpp>
 
 #endif // __BTAS_TENSOR_CORE_HPP
@@ -3,10 +3,14 @@
 
 #include <vector>
 #include <algorithm>
+#include <numeric> // std::accumulate
+#include <utility> // std::move
+#include <cmath> // std::sqrt
 
 #include <lapack.h>
 #include <remove_complex.h>
 #include <Tensor.hpp>
+#include <Workspace.hpp>
 
 #include <BTAS_assert.h>
 
@@ -15,13 +19,13 @@ namespace btas {
 /// Solve real-symmetric eigenvalue problem (SEP)
 /// Def.: A({i,j,k},{i,j,k}) = Z({i,j,k,e}) * w({e}) * Z^T({e,i,j,k})
 /// NOTE: if called with complex array, gives an error
-template<typename T, size_t N, CBLAS_LAYOUT Layout>
+template<typename T, size_t N, CBLAS_LAYOUT Layout, class AllocA, class AllocW, class AllocZ>
 void syev (
   const char& jobz,
   const char& uplo,
-  const Tensor<T,2*N-2,Layout>& a,
-        Tensor<T,1,Layout>& w,
-        Tensor<T,N,Layout>& z)
+  const Tensor<T,2*N-2,Layout,AllocA>& a,
+        Tensor<T,1,Layout,AllocW>& w,
+        Tensor<T,N,Layout,AllocZ>& z)
 {
   const size_t K = N-1;
 
@@ -33,10 +37,10 @@ void syev (
   for(size_t i = 0; i < K; ++i) zExtent[i] = a.extent(i);
   zExtent[N-1] = aCols;
 
-  z.resize(zExtent);
+  z.resize_uninitialized(zExtent);
   copy(a,z); // reshape a and copy to z
 
-  w.resize(aCols);
+  w.resize_uninitialized(aCols);
 
   syev(Layout,jobz,uplo,aCols,z.data(),aCols,w.data());
 }
@@ -44,13 +48,13 @@ void syev (
 /// Solve hermitian eigenvalue problem (HEP)
 /// Def.: A({i,j,k},{i,j,k}) = Z({i,j,k,e}) * w({e}) * Z^T({e,i,j,k})
 /// NOTE: if called with real array, redirect to Syev
-template<typename T, size_t N, CBLAS_LAYOUT Layout>
+template<typename T, size_t N, CBLAS_LAYOUT Layout, class AllocA, class AllocW, class AllocZ>
 void heev (
   const char& jobz,
   const char& uplo,
-  const Tensor<T,2*N-2,Layout>& a,
-        Tensor<typename remove_complex<T>::type,1,Layout>& w,
-        Tensor<T,N,Layout>& z)
+  const Tensor<T,2*N-2,Layout,AllocA>& a,
+        Tensor<typename remove_complex<T>::type,1,Layout,AllocW>& w,
+        Tensor<T,N,Layout,AllocZ>& z)
 {
   const size_t K = N-1;
 
@@ -62,178 +66,366 @@ void heev (
   for(size_t i = 0; i < K; ++i) zExtent[i] = a.extent(i);
   zExtent[N-1] = aCols;
 
-  z.resize(zExtent); copy(a,z); // reshape a and copy to z
+  z.resize_uninitialized(zExtent); copy(a,z); // reshape a and copy to z
 
-  w.resize(aCols);
+  w.resize_uninitialized(aCols);
 
   heev(Layout,jobz,uplo,aCols,z.data(),aCols,w.data());
 }
 
-/// Solve singular value decomposition (SVD)
-template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout>
-void gesvd (
+namespace detail {
+
+/// SVD of a given by extent aExt and data pa, which are destroyed on exit (see gesvd)
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class AllocS, class AllocU, class AllocVT>
+void __gesvd (
   const char& jobu,
   const char& jobvt,
-  const Tensor<T,M+N-2,Layout>& a,
-        Tensor<typename remove_complex<T>::type,1,Layout>& s,
-        Tensor<T,M,Layout>& u,
-        Tensor<T,N,Layout>& vt)
+  const typename Tensor<T,M+N-2,Layout>::extent_type& aExt,
+        T* pa,
+        Tensor<typename remove_complex<T>::type,1,Layout,AllocS>& s,
+        Tensor<T,M,Layout,AllocU>& u,
+        Tensor<T,N,Layout,AllocVT>& vt)
 {
-  size_t aRows = std::accumulate(a.extent().begin(),a.extent().begin()+M-1,1ul,std::multiplies<size_t>());
-  size_t aCols = std::accumulate(a.extent().begin()+M-1,a.extent().end(),  1ul,std::multiplies<size_t>());
+  size_t aRows = std::accumulate(aExt.begin(),aExt.begin()+M-1,1ul,std::multiplies<size_t>());
+  size_t aCols = std::accumulate(aExt.begin()+M-1,aExt.end(),  1ul,std::multiplies<size_t>());
   size_t lda = (Layout == CblasRowMajor) ? aCols : aRows;
 
   size_t sExts = std::min(aRows,aCols);
 
   size_t uCols = (jobu == 'A' || jobu == 'a') ? aRows : sExts;
-  size_t ldu = (Layout == CblasRowMajor) ? aRows : uCols;
+  size_t ldu = (Layout == CblasRowMajor) ? uCols : aRows;
 
   size_t vtRows = (jobvt == 'A' || jobvt == 'a') ? aCols : sExts;
   size_t ldvt = (Layout == CblasRowMajor) ? aCols : vtRows;
 
   typename Tensor<T,M,Layout>::extent_type uExtent;
-  for(size_t i = 0; i < M-1; ++i) uExtent[i] = a.extent(i);
+  for(size_t i = 0; i < M-1; ++i) uExtent[i] = aExt[i];
   uExtent[M-1] = uCols;
 
   typename Tensor<T,N,Layout>::extent_type vtExtent;
   vtExtent[0] = vtRows;
-  for(size_t i = 1; i < N; ++i) vtExtent[i] = a.extent(i+M-2);
+  for(size_t i = 1; i < N; ++i) vtExtent[i] = aExt[i+M-2];
 
-  s.resize(sExts);
+  s.resize_uninitialized(sExts);
 
-  BTAS_assert((jobu == 'O' || jobu == 'o' || jobvt == 'O' || jobvt == 'o'), "job* = 'O' is currently disabled.")
+  BTAS_assert(!(jobu == 'O' || jobu == 'o' || jobvt == 'O' || jobvt == 'o'), "job* = 'O' is currently disabled.")
 
-  if(jobu  != 'N' && jobu  != 'n') u.resize(uExtent);
-  if(jobvt != 'N' && jobvt != 'n') vt.resize(vtExtent);
+  if(jobu  != 'N' && jobu  != 'n') u.resize_uninitialized(uExtent);
+  if(jobvt != 'N' && jobvt != 'n') vt.resize_uninitialized(vtExtent);
 
-  Tensor<T,M+N-2,Layout> aCp(a);
-  gesvd(Layout,jobu,jobvt,aRows,aCols,aCp.data(),lda,s.data(),u.data(),ldu,vt.data(),ldvt);
+  gesvd(Layout,jobu,jobvt,aRows,aCols,pa,lda,s.data(),u.data(),ldu,vt.data(),ldvt);
 }
 
-/// perform a QR decomposition : a = q * r
-/// \param a input tensor
-/// \param q on exit, unitary matrix is stored
-/// \param r on exit, upper trapezoidal matrix is stored
-template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout>
-void geqrf (
-  const Tensor<T,M+N-2,Layout>& a,
-        Tensor<T,M,Layout>& q,
-        Tensor<T,N,Layout>& r)
+/// QR decomposition of a given by extent aExt and data pa, which are destroyed on exit (see geqrf)
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class AllocQ, class AllocR>
+void __geqrf (
+  const typename Tensor<T,M+N-2,Layout>::extent_type& aExt,
+        T* pa,
+        Tensor<T,M,Layout,AllocQ>& q,
+        Tensor<T,N,Layout,AllocR>& r)
 {
-  size_t aRows = std::accumulate(a.extent().begin(),a.extent().begin()+M-1,1ul,std::multiplies<size_t>());
-  size_t aCols = std::accumulate(a.extent().begin()+M-1,a.extent().end(),  1ul,std::multiplies<size_t>());
+  size_t aRows = std::accumulate(aExt.begin(),aExt.begin()+M-1,1ul,std::multiplies<size_t>());
+  size_t aCols = std::accumulate(aExt.begin()+M-1,aExt.end(),  1ul,std::multiplies<size_t>());
   size_t lda = (Layout == CblasRowMajor) ? aCols : aRows;
 
   size_t tExts = std::min(aRows,aCols);
 
   typename Tensor<T,M,Layout>::extent_type qExtent;
-  for(size_t i = 0; i < M-1; ++i) qExtent[i] = a.extent(i);
+  for(size_t i = 0; i < M-1; ++i) qExtent[i] = aExt[i];
   qExtent[M-1] = tExts;
 
   typename Tensor<T,N,Layout>::extent_type rExtent;
   rExtent[0] = tExts;
-  for(size_t i = 1; i < N; ++i) rExtent[i] = a.extent(i+M-2);
-
-  Tensor<T,2,Layout> aCp(aRows,aCols);
-  copy(a,aCp);
+  for(size_t i = 1; i < N; ++i) rExtent[i] = aExt[i+M-2];
 
-  std::vector<double> tau(tExts);
-  geqrf(Layout,aRows,aCols,aCp.data(),lda,tau.data());
+  Workspace::Scope scope;
+  T* tau = scope.allocate<T>(tExts);
+  geqrf(Layout,aRows,aCols,pa,lda,tau);
 
   r.resize(rExtent);
   r.fill(static_cast<T>(0));
 
-  q.resize(qExtent);
+  q.resize_uninitialized(qExtent);
 
   // NOTE: by def. tExts <= aCols
   if(Layout == CblasRowMajor) {
     for(size_t i = 0; i < tExts; ++i)
       for(size_t j = i; j < aCols; ++j)
-        r[i*aCols+j] = aCp(i,j);
+        r[i*aCols+j] = pa[i*lda+j];
 
     for(size_t i = 0; i < aRows; ++i)
       for(size_t j = 0; j < tExts; ++j)
-        q[i*tExts+j] = aCp(i,j);
+        q[i*tExts+j] = pa[i*lda+j];
   }
   else {
     for(size_t j = 0; j < tExts; ++j)
       for(size_t i = 0; i <= j; ++i)
-        r[i+j*tExts] = aCp(i,j);
+        r[i+j*tExts] = pa[i+j*lda];
     for(size_t j = tExts; j < aCols; ++j)
       for(size_t i = 0; i < tExts; ++i)
-        r[i+j*tExts] = aCp(i,j);
+        r[i+j*tExts] = pa[i+j*lda];
 
     for(size_t j = 0; j < tExts; ++j)
       for(size_t i = 0; i < aRows; ++i)
-        q[i+j*aRows] = aCp(i,j);
+        q[i+j*aRows] = pa[i+j*lda];
   }
 
   // Now get the Q matrix out
   size_t ldq = (Layout == CblasRowMajor) ? tExts : aRows;
-  orgqr(Layout,aRows,tExts,tExts,q.data(),ldq,tau.data());
+  orgqr(Layout,aRows,tExts,tExts,q.data(),ldq,tau);
 }
 
-/// perform a LQ decomposition : a = l * q
-/// \param a input tensor
-/// \param l on exit, lower trapezoidal matrix is stored
-/// \param q on exit, unitary matrix is stored
-template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout>
-void gelqf (
-  const Tensor<T,M+N-2,Layout>& a,
-        Tensor<T,M,Layout>& l,
-        Tensor<T,N,Layout>& q)
+/// LQ decomposition of a given by extent aExt and data pa, which are destroyed on exit (see gelqf)
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class AllocL, class AllocQ>
+void __gelqf (
+  const typename Tensor<T,M+N-2,Layout>::extent_type& aExt,
+        T* pa,
+        Tensor<T,M,Layout,AllocL>& l,
+        Tensor<T,N,Layout,AllocQ>& q)
 {
-  size_t aRows = std::accumulate(a.extent().begin(),a.extent().begin()+M-1,1ul,std::multiplies<size_t>());
-  size_t aCols = std::accumulate(a.extent().begin()+M-1,a.extent().end(),  1ul,std::multiplies<size_t>());
+  size_t aRows = std::accumulate(aExt.begin(),aExt.begin()+M-1,1ul,std::multiplies<size_t>());
+  size_t aCols = std::accumulate(aExt.begin()+M-1,aExt.end(),  1ul,std::multiplies<size_t>());
   size_t lda = (Layout == CblasRowMajor) ? aCols : aRows;
 
   size_t tExts = std::min(aRows,aCols);
 
   typename Tensor<T,M,Layout>::extent_type lExtent;
-  for(size_t i = 0; i < M-1; ++i) lExtent[i] = a.extent(i);
+  for(size_t i = 0; i < M-1; ++i) lExtent[i] = aExt[i];
   lExtent[M-1] = tExts;
 
   typename Tensor<T,N,Layout>::extent_type qExtent;
   qExtent[0] = tExts;
-  for(size_t i = 1; i < N; ++i) qExtent[i] = a.extent(i+M-2);
-
-  Tensor<T,2,Layout> aCp(aRows,aCols);
-  copy(a,aCp);
+  for(size_t i = 1; i < N; ++i) qExtent[i] = aExt[i+M-2];
 
-  std::vector<double> tau(tExts);
-  gelqf(Layout,aRows,aCols,aCp.data(),lda,tau.data());
+  Workspace::Scope scope;
+  T* tau = scope.allocate<T>(tExts);
+  gelqf(Layout,aRows,aCols,pa,lda,tau);
 
   l.resize(lExtent);
   l.fill(static_cast<T>(0));
 
-  q.resize(qExtent);
+  q.resize_uninitialized(qExtent);
 
   // NOTE: by def. tExts <= aCols
   if(Layout == CblasRowMajor) {
     for(size_t i = 0; i < tExts; ++i)
       for(size_t j = 0; j <= i; ++j)
-        l[i*tExts+j] = aCp(i,j);
+        l[i*tExts+j] = pa[i*lda+j];
     for(size_t i = tExts; i < aRows; ++i)
       for(size_t j = 0; j < tExts; ++j)
-        l[i*tExts+j] = aCp(i,j);
+        l[i*tExts+j] = pa[i*lda+j];
 
     for(size_t i = 0; i < tExts; ++i)
       for(size_t j = 0; j < aCols; ++j)
-        q[i*aCols+j] = aCp(i,j);
+        q[i*aCols+j] = pa[i*lda+j];
   }
   else {
     for(size_t j = 0; j < tExts; ++j)
       for(size_t i = j; i < aRows; ++i)
-        l[i+j*aRows] = aCp(i,j);
+        l[i+j*aRows] = pa[i+j*lda];
 
     for(size_t j = 0; j < aCols; ++j)
       for(size_t i = 0; i < tExts; ++i)
-        q[i+j*tExts] = aCp(i,j);
+        q[i+j*tExts] = pa[i+j*lda];
   }
 
   // Now get the Q matrix out
   size_t ldq = (Layout == CblasRowMajor) ? aCols : tExts;
-  orglq(Layout,tExts,aCols,tExts,q.data(),ldq,tau.data());
+  orglq(Layout,tExts,aCols,tExts,q.data(),ldq,tau);
+}
+
+} // namespace detail
+
+/// Solve singular value decomposition (SVD)
+/// a is consumed : its memory is used as workspace of LAPACK, and its data are destroyed on exit
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class AllocA, class AllocS, class AllocU, class AllocVT>
+void gesvd (
+  const char& jobu,
+  const char& jobvt,
+        Tensor<T,M+N-2,Layout,AllocA>&& a,
+        Tensor<typename remove_complex<T>::type,1,Layout,AllocS>& s,
+        Tensor<T,M,Layout,AllocU>& u,
+        Tensor<T,N,Layout,AllocVT>& vt)
+{
+  detail::__gesvd(jobu,jobvt,a.extent(),a.data(),s,u,vt);
+}
+
+/// Solve singular value decomposition (SVD)
+/// a is copied to the thread-local Workspace, which is used as workspace of LAPACK
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class AllocA, class AllocS, class AllocU, class AllocVT>
+void gesvd (
+  const char& jobu,
+  const char& jobvt,
+  const Tensor<T,M+N-2,Layout,AllocA>& a,
+        Tensor<typename remove_complex<T>::type,1,Layout,AllocS>& s,
+        Tensor<T,M,Layout,AllocU>& u,
+        Tensor<T,N,Layout,AllocVT>& vt)
+{
+  Workspace::Scope scope;
+  T* pa = scope.allocate<T>(a.size());
+  copy(a.size(),a.data(),1,pa,1);
+  detail::__gesvd(jobu,jobvt,a.extent(),pa,s,u,vt);
+}
+
+/// truncation of singular values, e.g. gesvd_truncated(a,s,u,vt,{max_rank,cutoff,rel_cutoff,renormalize})
+/// NOTE: at least 1 singular triplet is retained
+struct SVDTruncation {
+
+  size_t max_rank; ///< max. number of singular values to be retained (0 : unlimited)
+
+  double cutoff; ///< singular values smaller than cutoff are discarded
+
+  double rel_cutoff; ///< singular values smaller than rel_cutoff * s(0) are discarded
+
+  bool renormalize; ///< if true, retained singular values are rescaled to the norm of a
+
+};
+
+/// Solve truncated singular value decomposition (SVD) : a ~ u * diag(s) * vt
+/// only the retained singular triplets are stored in s, u and vt, which are sized by the number of retained singular values
+/// a is copied to the thread-local Workspace and decomposed by gesdd (divide and conquer), or by gesvd if gesdd failed to converge
+/// \return discarded weight, i.e. sum of squares of the discarded singular values (before renormalization)
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class AllocS, class AllocU, class AllocVT>
+typename remove_complex<T>::type gesvd_truncated (
+  const TensorBase<T,M+N-2,Layout>& a,
+        Tensor<typename remove_complex<T>::type,1,Layout,AllocS>& s,
+        Tensor<T,M,Layout,AllocU>& u,
+        Tensor<T,N,Layout,AllocVT>& vt,
+  const SVDTruncation& trunc)
+{
+  typedef typename remove_complex<T>::type real_type;
+
+  const auto& aExt = a.extent();
+
+  size_t aRows = std::accumulate(aExt.begin(),aExt.begin()+M-1,1ul,std::multiplies<size_t>());
+  size_t aCols = std::accumulate(aExt.begin()+M-1,aExt.end(),  1ul,std::multiplies<size_t>());
+  size_t lda = (Layout == CblasRowMajor) ? aCols : aRows;
+
+  size_t sExts = std::min(aRows,aCols);
+
+  size_t ldu = (Layout == CblasRowMajor) ? sExts : aRows;
+  size_t ldvt = (Layout == CblasRowMajor) ? aCols : sExts;
+
+  typename Tensor<T,M,Layout>::extent_type uExtent;
+  for(size_t i = 0; i < M-1; ++i) uExtent[i] = aExt[i];
+  uExtent[M-1] = sExts;
+
+  typename Tensor<T,N,Layout>::extent_type vtExtent;
+  vtExtent[0] = sExts;
+  for(size_t i = 1; i < N; ++i) vtExtent[i] = aExt[i+M-2];
+
+  s.resize_uninitialized(sExts);
+  u.resize_uninitialized(uExtent);
+  vt.resize_uninitialized(vtExtent);
+
+  if(sExts == 0) return static_cast<real_type>(0);
+
+  // u and vt are written by LAPACK directly, and compacted in place after truncation
+  {
+    Workspace::Scope scope;
+    T* pa = scope.allocate<T>(a.size());
+    copy(a.size(),a.data(),1,pa,1);
+    lapack_int info = gesdd(Layout,'S',aRows,aCols,pa,lda,s.data(),u.data(),ldu,vt.data(),ldvt);
+    BTAS_assert(info >= 0,"gesvd_truncated, illegal argument was given to gesdd.");
+    if(info > 0) {
+      copy(a.size(),a.data(),1,pa,1);
+      gesvd(Layout,'S','S',aRows,aCols,pa,lda,s.data(),u.data(),ldu,vt.data(),ldvt);
+    }
+  }
+
+  // number of singular values to be retained
+  size_t k = sExts;
+  if(trunc.max_rank > 0 && k > trunc.max_rank) k = trunc.max_rank;
+  while(k > 1 && (s[k-1] < trunc.cutoff || s[k-1] < trunc.rel_cutoff*s[0])) --k;
+
+  real_type kept = static_cast<real_type>(0);
+  for(size_t i = 0; i < k; ++i) kept += s[i]*s[i];
+  real_type discarded = static_cast<real_type>(0);
+  for(size_t i = k; i < sExts; ++i) discarded += s[i]*s[i];
+
+  if(trunc.renormalize && kept > static_cast<real_type>(0)) {
+    real_type factor = std::sqrt((kept+discarded)/kept);
+    for(size_t i = 0; i < k; ++i) s[i] *= factor;
+  }
+
+  if(k == sExts) return discarded;
+
+  // NOTE: leading k columns of u (column-major) and leading k rows of vt (row-major) are already contiguous
+  if(Layout == CblasRowMajor) {
+    for(size_t i = 1; i < aRows; ++i)
+      std::copy(u.data()+i*sExts,u.data()+i*sExts+k,u.data()+i*k);
+  }
+  else {
+    for(size_t j = 1; j < aCols; ++j)
+      std::copy(vt.data()+j*sExts,vt.data()+j*sExts+k,vt.data()+j*k);
+  }
+
+  // NOTE: shrinking by resize_uninitialized never reallocates, and keeps the leading data
+  uExtent[M-1] = k;
+  vtExtent[0] = k;
+  s.resize_uninitialized(k);
+  u.resize_uninitialized(uExtent);
+  vt.resize_uninitialized(vtExtent);
+
+  return discarded;
+}
+
+/// perform a QR decomposition : a = q * r
+/// \param a input tensor, which is consumed : its memory is used as workspace of LAPACK, and its data are destroyed on exit
+/// \param q on exit, unitary matrix is stored
+/// \param r on exit, upper trapezoidal matrix is stored
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class AllocA, class AllocQ, class AllocR>
+void geqrf (
+        Tensor<T,M+N-2,Layout,AllocA>&& a,
+        Tensor<T,M,Layout,AllocQ>& q,
+        Tensor<T,N,Layout,AllocR>& r)
+{
+  detail::__geqrf(a.extent(),a.data(),q,r);
+}
+
+/// perform a QR decomposition : a = q * r
+/// \param a input tensor, which is copied to the thread-local Workspace
+/// \param q on exit, unitary matrix is stored
+/// \param r on exit, upper trapezoidal matrix is stored
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class AllocA, class AllocQ, class AllocR>
+void geqrf (
+  const Tensor<T,M+N-2,Layout,AllocA>& a,
+        Tensor<T,M,Layout,AllocQ>& q,
+        Tensor<T,N,Layout,AllocR>& r)
+{
+  Workspace::Scope scope;
+  T* pa = scope.allocate<T>(a.size());
+  copy(a.size(),a.data(),1,pa,1);
+  detail::__geqrf(a.extent(),pa,q,r);
+}
+
+/// perform a LQ decomposition : a = l * q
+/// \param a input tensor, which is consumed : its memory is used as workspace of LAPACK, and its data are destroyed on exit
+/// \param l on exit, lower trapezoidal matrix is stored
+/// \param q on exit, unitary matrix is stored
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class AllocA, class AllocL, class AllocQ>
+void gelqf (
+        Tensor<T,M+N-2,Layout,AllocA>&& a,
+        Tensor<T,M,Layout,AllocL>& l,
+        Tensor<T,N,Layout,AllocQ>& q)
+{
+  detail::__gelqf(a.extent(),a.data(),l,q);
+}
+
+/// perform a LQ decomposition : a = l * q
+/// \param a input tensor, which is copied to the thread-local Workspace
+/// \param l on exit, lower trapezoidal matrix is stored
+/// \param q on exit, unitary matrix is stored
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class AllocA, class AllocL, class AllocQ>
+void gelqf (
+  const Tensor<T,M+N-2,Layout,AllocA>& a,
+        Tensor<T,M,Layout,AllocL>& l,
+        Tensor<T,N,Layout,AllocQ>& q)
+{
+  Workspace::Scope scope;
+  T* pa = scope.allocate<T>(a.size());
+  copy(a.size(),a.data(),1,pa,1);
+  detail::__gelqf(a.extent(),pa,l,q);
 }
 
 } // namespace btas
@@ -5,7 +5,7 @@
 #include <vector>
 #include <algorithm>
 
-#include <mkl.h>
+#include <backend.h> // CBLAS_LAYOUT
 
 #ifdef _ENABLE_BOOST_SERIALIZE
 #include <boost/serialization/serialization.hpp>
@@ -183,30 +183,30 @@ public:
   /// access by tensor index
   template<class Index>
   reference operator() (const Index& idx)
-  { return *(iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_)); }
+  { return *(iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_)); }
 
   /// access by tensor index
   reference operator() (const index_type& idx)
-  { return *(iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_)); }
+  { return *(iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_)); }
 
   /// access by tensor index with const-qualifier
   template<class Index>
   const_reference operator() (const Index& idx) const
-  { return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_)); }
+  { return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_)); }
 
   /// access by tensor index with const-qualifier
   const_reference operator() (const index_type& idx) const
-  { return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_)); }
+  { return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_)); }
 
   /// access by tensor index
   template<typename... Args>
   reference operator() (const Args&... args)
-  { return *(iterator(first_.current_,make_array<typename index_type::value_type>(args...),first_.tn_stride_,first_.hack_stride_)); }
+  { return *(iterator(first_.current_,make_array<typename index_type::value_type>(args...),first_.tn_stride_,first_.stride_hack_)); }
 
   /// access by tensor index with const-qualifier
   template<typename... Args>
   const_reference operator() (const Args&... args) const
-  { return *(const_iterator(first_.current_,make_array<typename index_type::value_type>(args...),first_.tn_stride_,first_.hack_stride_)); }
+  { return *(const_iterator(first_.current_,make_array<typename index_type::value_type>(args...),first_.tn_stride_,first_.stride_hack_)); }
 
   /// access by tensor index with range check
   template<class Index>
@@ -214,7 +214,7 @@ public:
   {
     for(size_t i = 0; i < N; ++i)
       BTAS_assert(idx[i] < first_.tn_stride_.extent(i),"TensorView::at, out of range access detected.");
-    return *(iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_));
+    return *(iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_));
   }
 
   /// access by tensor index with range check
@@ -222,7 +222,7 @@ public:
   {
     for(size_t i = 0; i < N; ++i)
       BTAS_assert(idx[i] < first_.tn_stride_.extent(i),"TensorView::at, out of range access detected.");
-    return *(iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_));
+    return *(iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_));
   }
 
   /// access by tensor index with range check having const-qualifier
@@ -231,7 +231,7 @@ public:
   {
     for(size_t i = 0; i < N; ++i)
       BTAS_assert(idx[i] < first_.tn_stride_.extent(i),"TensorView::at, out of range access detected.");
-    return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_));
+    return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_));
   }
 
   /// access by tensor index with range check having const-qualifier
@@ -239,7 +239,7 @@ public:
   {
     for(size_t i = 0; i < N; ++i)
       BTAS_assert(idx[i] < first_.tn_stride_.extent(i),"TensorView::at, out of range access detected.");
-    return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_));
+    return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_));
   }
 
   /// access by tensor index with range check
@@ -249,7 +249,7 @@ public:
     index_type idx = make_array<typename index_type::value_type>(args...);
     for(size_t i = 0; i < N; ++i)
       BTAS_assert(idx[i] < first_.tn_stride_.extent(i),"TensorView::at, out of range access detected.");
-    return *(iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_));
+    return *(iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_));
   }
 
   /// access by tensor index with range check having const-qualifier
@@ -259,7 +259,7 @@ public:
     index_type idx = make_array<typename index_type::value_type>(args...);
     for(size_t i = 0; i < N; ++i)
       BTAS_assert(idx[i] < first_.tn_stride_.extent(i),"TensorView::at, out of range access detected.");
-    return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_));
+    return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_));
   }
 
   // others
@@ -448,30 +448,30 @@ public:
   /// access by tensor index
   template<class Index>
   reference operator() (const Index& idx)
-  { return *(iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_)); }
+  { return *(iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_)); }
 
   /// access by tensor index
   reference operator() (const index_type& idx)
-  { return *(iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_)); }
+  { return *(iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_)); }
 
   /// access by tensor index with const-qualifier
   template<class Index>
   const_reference operator() (const Index& idx) const
-  { return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_)); }
+  { return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_)); }
 
   /// access by tensor index with const-qualifier
   const_reference operator() (const index_type& idx) const
-  { return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_)); }
+  { return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_)); }
 
   /// access by tensor index
   template<typename... Args>
   reference operator() (const Args&... args)
-  { return *(iterator(first_.current_,make_array<typename index_type::value_type>(args...),first_.tn_stride_,first_.hack_stride_)); }
+  { return *(iterator(first_.current_,make_array<typename index_type::value_type>(args...),first_.tn_stride_,first_.stride_hack_)); }
 
   /// access by tensor index with const-qualifier
   template<typename... Args>
   const_reference operator() (const Args&... args) const
-  { return *(const_iterator(first_.current_,make_array<typename index_type::value_type>(args...),first_.tn_stride_,first_.hack_stride_)); }
+  { return *(const_iterator(first_.current_,make_array<typename index_type::value_type>(args...),first_.tn_stride_,first_.stride_hack_)); }
 
   /// access by tensor index with range check
   template<class Index>
@@ -479,7 +479,7 @@ public:
   {
     for(size_t i = 0; i < idx.size(); ++i)
       BTAS_assert(idx[i] < first_.tn_stride_.extent(i),"TensorView::at, out of range access detected.");
-    return *(iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_));
+    return *(iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_));
   }
 
   /// access by tensor index with range check
@@ -487,7 +487,7 @@ public:
   {
     for(size_t i = 0; i < idx.size(); ++i)
       BTAS_assert(idx[i] < first_.tn_stride_.extent(i),"TensorView::at, out of range access detected.");
-    return *(iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_));
+    return *(iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_));
   }
 
   /// access by tensor index with range check having const-qualifier
@@ -496,7 +496,7 @@ public:
   {
     for(size_t i = 0; i < idx.size(); ++i)
       BTAS_assert(idx[i] < first_.tn_stride_.extent(i),"TensorView::at, out of range access detected.");
-    return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_));
+    return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_));
   }
 
   /// access by tensor index with range check having const-qualifier
@@ -504,7 +504,7 @@ public:
   {
     for(size_t i = 0; i < idx.size(); ++i)
       BTAS_assert(idx[i] < first_.tn_stride_.extent(i),"TensorView::at, out of range access detected.");
-    return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_));
+    return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_));
   }
 
   /// access by tensor index with range check
@@ -514,7 +514,7 @@ public:
     index_type idx = make_array<typename index_type::value_type>(args...);
     for(size_t i = 0; i < idx.size(); ++i)
       BTAS_assert(idx[i] < first_.tn_stride_.extent(i),"TensorView::at, out of range access detected.");
-    return *(iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_));
+    return *(iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_));
   }
 
   /// access by tensor index with range check having const-qualifier
@@ -524,7 +524,7 @@ public:
     index_type idx = make_array<typename index_type::value_type>(args...);
     for(size_t i = 0; i < idx.size(); ++i)
       BTAS_assert(idx[i] < first_.tn_stride_.extent(i),"TensorView::at, out of range access detected.");
-    return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.hack_stride_));
+    return *(const_iterator(first_.current_,idx,first_.tn_stride_,first_.stride_hack_));
   }
 
   // others
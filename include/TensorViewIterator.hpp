@@ -348,6 +348,12 @@ public:
   /// \return ordinal index in tensor-view
   ordinal_type ordinal () const { return tn_stride_.ordinal(index_); }
 
+  /// \return underlying iterator
+  const Iterator& base () const { return current_; }
+
+  /// \return stride(hack) to move underlying iterator
+  const stride_type& stride_hack () const { return stride_hack_; }
+
 // ---------------------------------------------------------------------------------------------------- 
 
   //
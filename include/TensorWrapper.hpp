@@ -69,15 +69,26 @@ public:
   explicit
   TensorWrapper (const TensorWrapper& x) : base_(x) { }
 
+  /// (shallow) move constructor, which allows to return TensorWrapper by value (e.g. reshape_view)
+  TensorWrapper (TensorWrapper&& x) : base_(x) { }
+
   /// (shallow) copy from a Tensor object
+  template<class Alloc>
   explicit
-  TensorWrapper (Tensor<T,N,Layout>& x) : base_(x) { }
+  TensorWrapper (Tensor<T,N,Layout,Alloc>& x) : base_(x) { }
 
   /// destructor
  ~TensorWrapper () { }
 
   // ---------------------------------------------------------------------------------------------------- 
 
+  // (Shallow) Copy assign
+
+  /// from TensorWrapper, which re-points this to data of x
+  TensorWrapper& operator= (const TensorWrapper&) = default;
+
+  // ---------------------------------------------------------------------------------------------------- 
+
   // (Deep) Copy assign
 
   /// from an arbitral tensor object
@@ -201,6 +212,9 @@ public:
   explicit
   TensorWrapper (const TensorWrapper& x) : base_(x) { }
 
+  /// (shallow) move constructor, which allows to return TensorWrapper by value (e.g. reshape_view)
+  TensorWrapper (TensorWrapper&& x) : base_(x) { }
+
   /// from non-const TensorWrapper
   explicit
   TensorWrapper (const TensorWrapper<T*,N,Layout>& x)
@@ -211,8 +225,9 @@ public:
   }
 
   /// (shallow) copy from a Tensor object
+  template<class Alloc>
   explicit
-  TensorWrapper (const Tensor<T,N,Layout>& x)
+  TensorWrapper (const Tensor<T,N,Layout,Alloc>& x)
   {
     tn_stride_ = x.tn_stride_;
     start_ = x.start_;
@@ -224,6 +239,13 @@ public:
 
   // ---------------------------------------------------------------------------------------------------- 
 
+  // (Shallow) Copy assign
+
+  /// from TensorWrapper, which re-points this to data of x
+  TensorWrapper& operator= (const TensorWrapper&) = default;
+
+  // ---------------------------------------------------------------------------------------------------- 
+
   // reset
 
   /// from a pointer to the first element w/ extent object
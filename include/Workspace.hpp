@@ -0,0 +1,199 @@
+#ifndef __BTAS_WORKSPACE_HPP
+#define __BTAS_WORKSPACE_HPP
+
+#include <vector>
+#include <algorithm> // std::max
+#include <cstdlib> // free
+
+#include <allocator.hpp>
+#include <BTAS_assert.h>
+
+/// initial size of thread-local workspace in bytes, which is allocated by the first use in each thread
+#ifndef _BTAS_WORKSPACE_INITIAL_SIZE
+#define _BTAS_WORKSPACE_INITIAL_SIZE 0ul
+#endif
+
+namespace btas {
+
+/// Thread-local arena of temporaries, i.e. permuted operands of contractions, LAPACK workspaces, etc.
+/// Temporaries are taken from a single buffer by bumping an offset, and released all together at the end of Workspace::Scope.
+/// If the buffer is exhausted, temporaries are allocated on heap instead, and the buffer is regrown to the high-water mark
+/// when the outermost scope is closed, s.t. repeated calls of the same shape never allocate on heap again.
+/// The buffer can be pre-sized by reserve(), e.g. w/ high_water() measured by a dry run:
+///
+///   contract(...); // dry run
+///   size_t bytes = Workspace::local().high_water();
+///   #pragma omp parallel
+///   Workspace::local().reserve(bytes); // each thread has its own workspace
+class Workspace {
+
+public:
+
+  /// alignment of temporaries in bytes
+  static constexpr size_t alignment = 64;
+
+  /// RAII scope of temporaries, which are released when the scope is closed
+  /// NOTE: scopes must be nested, i.e. closed in the reverse order of opening
+  class Scope {
+
+  public:
+
+    /// open scope of workspace of the calling thread
+    Scope () : ws_(Workspace::local()) { ws_.open_(top_,used_,nheap_); }
+
+    /// open scope of a workspace
+    explicit
+    Scope (Workspace& ws) : ws_(ws) { ws_.open_(top_,used_,nheap_); }
+
+    /// close scope, temporaries allocated in this scope are released
+   ~Scope () { ws_.close_(top_,used_,nheap_); }
+
+    /// allocate n elements of T w/o initialization, valid until the scope is closed
+    template<typename T>
+    T* allocate (size_t n) { return static_cast<T*>(ws_.allocate_(n*sizeof(T))); }
+
+  private:
+
+    Scope (const Scope&) = delete;
+
+    Scope& operator= (const Scope&) = delete;
+
+    Workspace& ws_; ///< workspace
+
+    size_t top_; ///< offset of the buffer upon opening
+
+    size_t used_; ///< bytes in use upon opening
+
+    size_t nheap_; ///< number of heap blocks upon opening
+
+  }; // class Workspace::Scope
+
+  // ----------------------------------------------------------------------------------------------------
+
+  /// return workspace of the calling thread
+  static Workspace& local ()
+  {
+    static thread_local Workspace ws(_BTAS_WORKSPACE_INITIAL_SIZE);
+    return ws;
+  }
+
+  /// constructor w/ initial size of the buffer in bytes
+  explicit
+  Workspace (size_t bytes = 0ul)
+  : buffer_(nullptr), capacity_(0), top_(0), used_(0), high_water_(0), heap_allocs_(0), nscope_(0)
+  {
+    reserve(bytes);
+  }
+
+  /// destructor
+ ~Workspace ()
+  {
+    for(size_t i = 0; i < heap_.size(); ++i) free(heap_[i]);
+    free(buffer_);
+  }
+
+  /// make the buffer at least bytes, which is done immediately if no scope is open, or when the outermost scope is closed
+  void reserve (size_t bytes)
+  {
+    high_water_ = std::max(high_water_,bytes);
+    if(nscope_ == 0) grow_();
+  }
+
+  /// deallocate the buffer and reset the high-water mark (no scope must be open)
+  void release ()
+  {
+    BTAS_assert(nscope_ == 0,"Workspace::release, detected open scope.");
+    free(buffer_);
+    buffer_ = nullptr;
+    capacity_ = 0;
+    high_water_ = 0;
+  }
+
+  /// return size of the buffer in bytes
+  size_t capacity () const { return capacity_; }
+
+  /// return bytes in use by temporaries
+  size_t used () const { return used_; }
+
+  /// return max. bytes in use at the same time so far, i.e. the size of the buffer needed to run w/o heap allocation
+  size_t high_water () const { return high_water_; }
+
+  /// return number of heap allocations, i.e. (re)allocations of the buffer and temporaries which overflowed it
+  size_t heap_allocations () const { return heap_allocs_; }
+
+private:
+
+  Workspace (const Workspace&) = delete;
+
+  Workspace& operator= (const Workspace&) = delete;
+
+  void open_ (size_t& top, size_t& used, size_t& nheap)
+  {
+    top = top_;
+    used = used_;
+    nheap = heap_.size();
+    ++nscope_;
+  }
+
+  void close_ (size_t top, size_t used, size_t nheap)
+  {
+    for(size_t i = nheap; i < heap_.size(); ++i) free(heap_[i]);
+    heap_.resize(nheap);
+    top_ = top;
+    used_ = used;
+    if(--nscope_ == 0) grow_();
+  }
+
+  /// bump allocation from the buffer, or heap allocation if the buffer is exhausted
+  void* allocate_ (size_t bytes)
+  {
+    BTAS_assert(nscope_ > 0,"Workspace::allocate, no scope is open.");
+    bytes = (bytes == 0) ? alignment : (bytes+alignment-1)/alignment*alignment;
+    void* p = nullptr;
+    if(top_+bytes <= capacity_) {
+      p = buffer_+top_;
+      top_ += bytes;
+    }
+    else {
+      p = detail::__aligned_malloc(bytes,alignment);
+      heap_.push_back(p);
+      ++heap_allocs_;
+    }
+    used_ += bytes;
+    high_water_ = std::max(high_water_,used_);
+    return p;
+  }
+
+  /// regrow the buffer to the high-water mark (the buffer is not in use)
+  void grow_ ()
+  {
+    if(high_water_ <= capacity_) return;
+    free(buffer_);
+    buffer_ = static_cast<char*>(detail::__aligned_malloc(high_water_,alignment));
+    capacity_ = high_water_;
+    ++heap_allocs_;
+  }
+
+  //  Members
+
+  char* buffer_; ///< buffer of temporaries
+
+  size_t capacity_; ///< size of the buffer in bytes
+
+  size_t top_; ///< offset of the next temporary in the buffer
+
+  size_t used_; ///< bytes in use, incl. those allocated on heap
+
+  size_t high_water_; ///< max. bytes in use so far
+
+  size_t heap_allocs_; ///< number of heap allocations
+
+  size_t nscope_; ///< number of open scopes
+
+  std::vector<void*> heap_; ///< temporaries allocated on heap
+
+}; // class Workspace
+
+} // namespace btas
+
+#endif // __BTAS_WORKSPACE_HPP
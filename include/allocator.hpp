@@ -0,0 +1,218 @@
+#ifndef __BTAS_ALLOCATOR_HPP
+#define __BTAS_ALLOCATOR_HPP
+
+#include <cstdlib> // posix_memalign, free
+#include <new> // std::bad_alloc
+#include <memory> // std::allocator_traits
+#include <utility> // std::forward
+#include <type_traits>
+
+#ifdef __linux__
+#include <sys/mman.h> // madvise
+#endif
+
+#ifdef _BTAS_USE_NUMA
+#include <numa.h> // numa_alloc_interleaved, numa_free (link w/ -lnuma)
+#endif
+
+#include <parallel.h>
+
+// Allocators for Tensor<T,N,Layout,Allocator> (see Tensor::allocator_type)
+//   aligned_allocator<T,Align>   : Align-byte (default 64) aligned memory, i.e. a cache line or an AVX-512 register
+//   huge_page_allocator<T>       : 2 MB aligned memory backed by transparent huge pages (madvise), for large tensors
+//   first_touch_allocator<T>     : pages are touched by OpenMP threads in contiguous chunks upon allocation,
+//                                  s.t. they are placed on NUMA nodes of threads which work on them
+//   numa_interleave_allocator<T> : pages are interleaved over all NUMA nodes by libnuma if _BTAS_USE_NUMA is defined,
+//                                  otherwise first_touch_allocator is used instead
+
+#ifndef _BTAS_HUGE_PAGE_SIZE
+#define _BTAS_HUGE_PAGE_SIZE 2097152ul
+#endif
+
+#ifndef _BTAS_PAGE_SIZE
+#define _BTAS_PAGE_SIZE 4096ul
+#endif
+
+namespace btas {
+
+namespace detail {
+
+/// allocate bytes aligned to align (power of 2 and multiple of sizeof(void*))
+inline void* __aligned_malloc (size_t bytes, size_t align)
+{
+  void* p = nullptr;
+  if(posix_memalign(&p,align,(bytes > 0) ? bytes : align) != 0) throw std::bad_alloc();
+  return p;
+}
+
+/// advise the kernel to back [p,p+bytes) by transparent huge pages
+inline void __advise_huge_pages (void* p, size_t bytes)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  madvise(p,bytes,MADV_HUGEPAGE);
+#endif
+}
+
+/// touch a byte of each page of [p,p+bytes), which is split over OpenMP threads in contiguous chunks (see __thread_range)
+inline void __first_touch (void* p, size_t bytes)
+{
+  char* c = static_cast<char*>(p);
+  const size_t npages = (bytes+_BTAS_PAGE_SIZE-1)/_BTAS_PAGE_SIZE;
+  const bool is_parallel = (npages > 1 && __max_threads() > 1);
+
+#ifdef _OPENMP
+#pragma omp parallel if(is_parallel)
+#endif
+  {
+    size_t first = 0;
+    size_t last  = npages;
+    if(is_parallel) __thread_range(npages,first,last);
+
+    for(size_t i = first; i < last; ++i) c[i*_BTAS_PAGE_SIZE] = 0;
+  }
+}
+
+/// memory aligned to Align bytes
+template<size_t Align>
+struct __aligned_policy {
+  static void* allocate (size_t bytes) { return __aligned_malloc(bytes,Align); }
+  static void deallocate (void* p, size_t) { free(p); }
+};
+
+/// memory aligned to huge pages and backed by them, if not smaller than a huge page
+struct __huge_page_policy {
+  static void* allocate (size_t bytes)
+  {
+    if(bytes < _BTAS_HUGE_PAGE_SIZE) return __aligned_malloc(bytes,64);
+    void* p = __aligned_malloc(bytes,_BTAS_HUGE_PAGE_SIZE);
+    __advise_huge_pages(p,bytes);
+    return p;
+  }
+  static void deallocate (void* p, size_t) { free(p); }
+};
+
+/// memory placed on NUMA nodes by first touch of OpenMP threads
+struct __first_touch_policy {
+  static void* allocate (size_t bytes)
+  {
+    if(bytes < _BTAS_PAGE_SIZE) return __aligned_malloc(bytes,64);
+    void* p = __aligned_malloc(bytes,_BTAS_PAGE_SIZE);
+    __first_touch(p,bytes);
+    return p;
+  }
+  static void deallocate (void* p, size_t) { free(p); }
+};
+
+#ifdef _BTAS_USE_NUMA
+/// memory interleaved over NUMA nodes by libnuma
+struct __numa_interleave_policy {
+  static void* allocate (size_t bytes)
+  {
+    if(numa_available() < 0) return __first_touch_policy::allocate(bytes);
+    void* p = numa_alloc_interleaved((bytes > 0) ? bytes : 1);
+    if(!p) throw std::bad_alloc();
+    return p;
+  }
+  static void deallocate (void* p, size_t bytes)
+  {
+    if(numa_available() < 0)
+      __first_touch_policy::deallocate(p,bytes);
+    else
+      numa_free(p,(bytes > 0) ? bytes : 1);
+  }
+};
+#else
+typedef __first_touch_policy __numa_interleave_policy;
+#endif
+
+/// stateless allocator which takes memory from Policy::allocate and Policy::deallocate
+template<typename T, class Policy>
+class __policy_allocator {
+
+public:
+
+  typedef T value_type;
+
+  template<typename U> struct rebind { typedef __policy_allocator<U,Policy> other; };
+
+  __policy_allocator () noexcept { }
+
+  template<typename U>
+  __policy_allocator (const __policy_allocator<U,Policy>&) noexcept { }
+
+  T* allocate (size_t n) { return static_cast<T*>(Policy::allocate(n*sizeof(T))); }
+
+  void deallocate (T* p, size_t n) noexcept { Policy::deallocate(p,n*sizeof(T)); }
+
+}; // class __policy_allocator<T,Policy>
+
+template<typename T, typename U, class Policy>
+inline bool operator== (const __policy_allocator<T,Policy>&, const __policy_allocator<U,Policy>&) { return true; }
+
+template<typename T, typename U, class Policy>
+inline bool operator!= (const __policy_allocator<T,Policy>&, const __policy_allocator<U,Policy>&) { return false; }
+
+/// adaptor of allocator A whose construct() w/o argument leaves trivial types (incl. std::complex) uninitialized,
+/// so that std::vector::resize(n) does not fill the buffer, while resize(n,value) fills it as usual
+template<class A>
+class __default_init_allocator : public A {
+
+  typedef std::allocator_traits<A> traits_;
+
+public:
+
+  template<typename U> struct rebind {
+    typedef __default_init_allocator<typename traits_::template rebind_alloc<U>> other;
+  };
+
+  __default_init_allocator () noexcept(noexcept(A())) { }
+
+  __default_init_allocator (const A& a) noexcept : A(a) { }
+
+  template<class B>
+  __default_init_allocator (const __default_init_allocator<B>& a) noexcept : A(static_cast<const B&>(a)) { }
+
+  /// default-initialize, which is no-op for trivially copyable and destructible types
+  template<typename U>
+  void construct (U* p) noexcept(std::is_nothrow_default_constructible<U>::value)
+  {
+    __construct_(p,std::integral_constant<bool,std::is_trivially_copyable<U>::value && std::is_trivially_destructible<U>::value>());
+  }
+
+  template<typename U, typename... Args>
+  void construct (U* p, Args&&... args)
+  {
+    traits_::construct(static_cast<A&>(*this),p,std::forward<Args>(args)...);
+  }
+
+private:
+
+  template<typename U>
+  static void __construct_ (U*, std::true_type) { }
+
+  template<typename U>
+  static void __construct_ (U* p, std::false_type) { ::new(static_cast<void*>(p)) U; }
+
+}; // class __default_init_allocator<A>
+
+} // namespace detail
+
+/// Align-byte aligned allocator (default 64 bytes)
+template<typename T, size_t Align = 64>
+using aligned_allocator = detail::__policy_allocator<T,detail::__aligned_policy<Align>>;
+
+/// allocator backed by transparent huge pages for 2 MB or larger
+template<typename T>
+using huge_page_allocator = detail::__policy_allocator<T,detail::__huge_page_policy>;
+
+/// allocator which places pages by first touch of OpenMP threads
+template<typename T>
+using first_touch_allocator = detail::__policy_allocator<T,detail::__first_touch_policy>;
+
+/// allocator which interleaves pages over NUMA nodes (libnuma w/ _BTAS_USE_NUMA, first touch otherwise)
+template<typename T>
+using numa_interleave_allocator = detail::__policy_allocator<T,detail::__numa_interleave_policy>;
+
+} // namespace btas
+
+#endif // __BTAS_ALLOCATOR_HPP
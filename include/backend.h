@@ -0,0 +1,52 @@
+#ifndef __BTAS_BACKEND_H
+#define __BTAS_BACKEND_H
+
+// BLAS/LAPACK backend, selected at compile time by one of
+//   _BTAS_USE_MKL       : Intel MKL (default), <mkl.h>
+//   _BTAS_USE_OPENBLAS  : OpenBLAS, <cblas.h> and <lapacke.h>
+//   _BTAS_USE_BLIS      : BLIS (built w/ --enable-cblas) and libflame (w/ LAPACKE), <cblas.h> and <lapacke.h>
+//   _BTAS_USE_REFERENCE : reference CBLAS and LAPACKE from netlib, <cblas.h> and <lapacke.h>
+// all backends provide CBLAS_LAYOUT, cblas_* and LAPACKE_* functions, and
+// _BTAS_CBLAS_HAS_AXPBY is defined if cblas_?axpby is available, otherwise axpby is emulated by scal and axpy.
+// _BTAS_CBLAS_HAS_GEMM3M is defined if cblas_?gemm3m is available, which is used for complex GEMM if _BTAS_USE_GEMM3M is defined.
+// MKL-only extensions (cblas_?gemm_batch and cblas_?gemm_batch_strided) are checked by __MKL_CBLAS__ where they are used.
+
+#include <complex>
+
+#ifndef lapack_complex_float
+#define lapack_complex_float  std::complex<float>
+#endif
+
+#ifndef lapack_complex_double
+#define lapack_complex_double std::complex<double>
+#endif
+
+#if !defined(_BTAS_USE_MKL) && !defined(_BTAS_USE_OPENBLAS) && !defined(_BTAS_USE_BLIS) && !defined(_BTAS_USE_REFERENCE)
+#define _BTAS_USE_MKL
+#endif
+
+#if (defined(_BTAS_USE_MKL)+defined(_BTAS_USE_OPENBLAS)+defined(_BTAS_USE_BLIS)+defined(_BTAS_USE_REFERENCE)) > 1
+#error "btas: only one of _BTAS_USE_MKL, _BTAS_USE_OPENBLAS, _BTAS_USE_BLIS and _BTAS_USE_REFERENCE can be defined."
+#endif
+
+#if defined(_BTAS_USE_MKL)
+
+#include <mkl.h>
+#define _BTAS_CBLAS_HAS_AXPBY
+#define _BTAS_CBLAS_HAS_GEMM3M
+
+#elif defined(_BTAS_USE_OPENBLAS)
+
+#include <cblas.h>
+#include <lapacke.h>
+#define _BTAS_CBLAS_HAS_AXPBY
+#define _BTAS_CBLAS_HAS_GEMM3M
+
+#else // BLIS or reference
+
+#include <cblas.h>
+#include <lapacke.h>
+
+#endif
+
+#endif // __BTAS_BACKEND_H
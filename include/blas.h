@@ -1,7 +1,7 @@
 #ifndef __BTAS_BLAS_HEADER_INCLUDED
 #define __BTAS_BLAS_HEADER_INCLUDED
 
-#include <mkl.h>
+#include <backend.h>
 
 #include <blas/axpby_impl.h>
 #include <blas/axpy_impl.h>
@@ -11,6 +11,8 @@
 #include <blas/gemv_impl.h>
 #include <blas/ger_impl.h>
 #include <blas/gemm_impl.h>
+#include <blas/gemm_batch_impl.h>
+#include <blas/gemm_batch_strided_impl.h>
 #include <blas/scal_impl.h>
 
 #endif // __BTAS_BLAS_HEADER_INCLUDED
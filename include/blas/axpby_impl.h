@@ -1,14 +1,42 @@
 #ifndef __BTAS_BLAS_AXPBY_IMPL_H
 #define __BTAS_BLAS_AXPBY_IMPL_H
 
+#include <complex>
+
 #include <BTAS_assert.h>
+#include <backend.h>
 
-// only for intel MKL
+#include <blas/axpy_impl.h>
+#include <blas/scal_impl.h>
 
-#ifdef __MKL_CBLAS__
+// cblas_?axpby is an extension of Intel MKL and OpenBLAS,
+// which is emulated by scal and axpy for the other backends (see backend.h)
 
 namespace btas {
 
+namespace detail {
+
+/// y = alpha * x + beta * y by scal and axpy, y is not read if beta = 0 (as cblas_?axpby)
+template<typename T>
+void __axpby_emulated (
+  const size_t& N,
+  const T& alpha,
+  const T* X,
+  const size_t& incX,
+  const T& beta,
+        T* Y,
+  const size_t& incY)
+{
+  if(beta == static_cast<T>(0)) {
+    for(size_t i = 0; i < N; ++i) Y[i*incY] = alpha*X[i*incX];
+    return;
+  }
+  if(beta != static_cast<T>(1)) scal(N, beta, Y, incY);
+  axpy(N, alpha, X, incX, Y, incY);
+}
+
+} // namespace detail
+
 /// generic axpby function
 template<typename T>
 void axpby (
@@ -20,9 +48,11 @@ void axpby (
         T* Y,
   const size_t& incY)
 {
-  BTAS_assert(false, "axpby is not implemented.");
+  detail::__axpby_emulated(N, alpha, X, incX, beta, Y, incY);
 }
 
+#ifdef _BTAS_CBLAS_HAS_AXPBY
+
 inline void axpby (
   const size_t& N,
   const float& alpha,
@@ -71,8 +101,58 @@ inline void axpby (
   cblas_zaxpby(N, &alpha, X, incX, &beta, Y, incY);
 }
 
-} // namespace btas
+#else // _BTAS_CBLAS_HAS_AXPBY
+
+inline void axpby (
+  const size_t& N,
+  const float& alpha,
+  const float* X,
+  const size_t& incX,
+  const float& beta,
+        float* Y,
+  const size_t& incY)
+{
+  detail::__axpby_emulated(N, alpha, X, incX, beta, Y, incY);
+}
+
+inline void axpby (
+  const size_t& N,
+  const double& alpha,
+  const double* X,
+  const size_t& incX,
+  const double& beta,
+        double* Y,
+  const size_t& incY)
+{
+  detail::__axpby_emulated(N, alpha, X, incX, beta, Y, incY);
+}
 
-#endif // __MKL_CBLAS__
+inline void axpby (
+  const size_t& N,
+  const std::complex<float>& alpha,
+  const std::complex<float>* X,
+  const size_t& incX,
+  const std::complex<float>& beta,
+        std::complex<float>* Y,
+  const size_t& incY)
+{
+  detail::__axpby_emulated(N, alpha, X, incX, beta, Y, incY);
+}
+
+inline void axpby (
+  const size_t& N,
+  const std::complex<double>& alpha,
+  const std::complex<double>* X,
+  const size_t& incX,
+  const std::complex<double>& beta,
+        std::complex<double>* Y,
+  const size_t& incY)
+{
+  detail::__axpby_emulated(N, alpha, X, incX, beta, Y, incY);
+}
+
+#endif // _BTAS_CBLAS_HAS_AXPBY
+
+} // namespace btas
 
 #endif // __BTAS_BLAS_AXPBY_IMPL_H
@@ -3,9 +3,11 @@
 
 #include <BTAS_assert.h>
 
+#include <blas/generic_impl.h>
+
 namespace btas {
 
-/// generic axpy function
+/// generic axpy function (see detail::__generic_axpy)
 template<typename T>
 void axpy (
   const size_t& N,
@@ -15,7 +17,7 @@ void axpy (
         T* Y,
   const size_t& incY)
 {
-  BTAS_assert(false,"axpy is not implemented.");
+  detail::__generic_axpy(N, alpha, X, incX, Y, incY);
 }
 
 inline void axpy (
@@ -5,6 +5,7 @@
 
 namespace btas {
 
+/// generic copy function
 template<typename T>
 void copy (
   const size_t& N,
@@ -13,7 +14,7 @@ void copy (
         T* Y,
   const size_t& incY)
 {
-  BTAS_assert(false, "copy is not implemented.");
+  for(size_t i = 0; i < N; ++i) Y[i*incY] = X[i*incX];
 }
 
 inline void copy (
@@ -3,6 +3,8 @@
 
 #include <BTAS_assert.h>
 
+#include <blas/generic_impl.h>
+
 namespace btas {
 
 inline float dot (
@@ -73,6 +75,7 @@ inline std::complex<double> dotc (
   return dotc_;
 }
 
+/// generic dot function (see detail::__generic_dot)
 template<typename T>
 T dot (
   const size_t& N,
@@ -81,7 +84,7 @@ T dot (
   const T* Y,
   const size_t& incY)
 {
-  BTAS_assert(false, "dot is not implemented.");
+  return detail::__generic_dot(N, X, incX, Y, incY, false);
 }
 
 template<typename T>
@@ -92,7 +95,7 @@ T dotc (
   const T* Y,
   const size_t& incY)
 {
-  return dot(N, X, incX, Y, incY);
+  return detail::__generic_dot(N, X, incX, Y, incY, true);
 }
 
 template<typename T>
@@ -0,0 +1,210 @@
+#ifndef __BTAS_BLAS_GEMM_BATCH_IMPL_H
+#define __BTAS_BLAS_GEMM_BATCH_IMPL_H
+
+#include <vector>
+#include <complex>
+
+#include <BTAS_assert.h>
+#include <parallel.h>
+
+#include <blas/gemm_impl.h>
+
+// cblas_?gemm_batch (group API) is available since Intel MKL 11.3,
+// otherwise, GEMMs are called in a loop, which is split over OpenMP threads if the batch is large enough.
+
+#if defined(__MKL_CBLAS__) && defined(INTEL_MKL_VERSION) && (INTEL_MKL_VERSION >= 110300)
+#define _BTAS_CBLAS_GEMM_BATCH
+#endif
+
+// total number of multiply-adds in a batch to run the GEMM loop on multiple threads
+#ifndef _BTAS_GEMM_BATCH_PARALLEL_THRESHOLD
+#define _BTAS_GEMM_BATCH_PARALLEL_THRESHOLD 65536ul
+#endif
+
+namespace btas {
+
+/// generic gemm_batch function with groups, for i-th group of groupSize[i] GEMMs sharing transA[i], ..., ldC[i],
+/// C[j] = alpha[i] * op(A[j]) * op(B[j]) + beta[i] * C[j], where j runs over GEMMs of i-th group
+template<typename T>
+void gemm_batch (
+  const CBLAS_LAYOUT& order,
+  const CBLAS_TRANSPOSE* transA,
+  const CBLAS_TRANSPOSE* transB,
+  const size_t* M,
+  const size_t* N,
+  const size_t* K,
+  const T* alpha,
+  const T** A,
+  const size_t* ldA,
+  const T** B,
+  const size_t* ldB,
+  const T* beta,
+        T** C,
+  const size_t* ldC,
+  const size_t& groupCount,
+  const size_t* groupSize)
+{
+  size_t total = 0;
+  size_t work = 0;
+  for(size_t g = 0; g < groupCount; ++g) {
+    total += groupSize[g];
+    work += groupSize[g]*M[g]*N[g]*K[g];
+  }
+
+  const bool is_parallel = (total > 1 && work >= _BTAS_GEMM_BATCH_PARALLEL_THRESHOLD && detail::__max_threads() > 1);
+
+#ifdef _OPENMP
+#pragma omp parallel if(is_parallel)
+#endif
+  {
+    size_t first = 0;
+    size_t last  = total;
+    if(is_parallel) detail::__thread_range(total,first,last);
+
+    // find the group of the first GEMM
+    size_t g = 0;
+    size_t offset = 0;
+    while(g < groupCount && offset+groupSize[g] <= first) offset += groupSize[g++];
+
+    for(size_t j = first; j < last; ++j) {
+      while(j >= offset+groupSize[g]) offset += groupSize[g++];
+      gemm(order, transA[g], transB[g], M[g], N[g], K[g], alpha[g], A[j], ldA[g], B[j], ldB[g], beta[g], C[j], ldC[g]);
+    }
+  }
+}
+
+#ifdef _BTAS_CBLAS_GEMM_BATCH
+
+namespace detail {
+
+/// convert dimensions to MKL_INT
+inline std::vector<MKL_INT> __mkl_int_array (const size_t* x, size_t n)
+{
+  return std::vector<MKL_INT>(x,x+n);
+}
+
+} // namespace detail
+
+inline void gemm_batch (
+  const CBLAS_LAYOUT& order,
+  const CBLAS_TRANSPOSE* transA,
+  const CBLAS_TRANSPOSE* transB,
+  const size_t* M,
+  const size_t* N,
+  const size_t* K,
+  const float* alpha,
+  const float** A,
+  const size_t* ldA,
+  const float** B,
+  const size_t* ldB,
+  const float* beta,
+        float** C,
+  const size_t* ldC,
+  const size_t& groupCount,
+  const size_t* groupSize)
+{
+  const std::vector<MKL_INT> M_ = detail::__mkl_int_array(M,groupCount);
+  const std::vector<MKL_INT> N_ = detail::__mkl_int_array(N,groupCount);
+  const std::vector<MKL_INT> K_ = detail::__mkl_int_array(K,groupCount);
+  const std::vector<MKL_INT> ldA_ = detail::__mkl_int_array(ldA,groupCount);
+  const std::vector<MKL_INT> ldB_ = detail::__mkl_int_array(ldB,groupCount);
+  const std::vector<MKL_INT> ldC_ = detail::__mkl_int_array(ldC,groupCount);
+  const std::vector<MKL_INT> groupSize_ = detail::__mkl_int_array(groupSize,groupCount);
+  cblas_sgemm_batch(order, transA, transB, M_.data(), N_.data(), K_.data(), alpha, A, ldA_.data(), B, ldB_.data(),
+                    beta, C, ldC_.data(), groupCount, groupSize_.data());
+}
+
+inline void gemm_batch (
+  const CBLAS_LAYOUT& order,
+  const CBLAS_TRANSPOSE* transA,
+  const CBLAS_TRANSPOSE* transB,
+  const size_t* M,
+  const size_t* N,
+  const size_t* K,
+  const double* alpha,
+  const double** A,
+  const size_t* ldA,
+  const double** B,
+  const size_t* ldB,
+  const double* beta,
+        double** C,
+  const size_t* ldC,
+  const size_t& groupCount,
+  const size_t* groupSize)
+{
+  const std::vector<MKL_INT> M_ = detail::__mkl_int_array(M,groupCount);
+  const std::vector<MKL_INT> N_ = detail::__mkl_int_array(N,groupCount);
+  const std::vector<MKL_INT> K_ = detail::__mkl_int_array(K,groupCount);
+  const std::vector<MKL_INT> ldA_ = detail::__mkl_int_array(ldA,groupCount);
+  const std::vector<MKL_INT> ldB_ = detail::__mkl_int_array(ldB,groupCount);
+  const std::vector<MKL_INT> ldC_ = detail::__mkl_int_array(ldC,groupCount);
+  const std::vector<MKL_INT> groupSize_ = detail::__mkl_int_array(groupSize,groupCount);
+  cblas_dgemm_batch(order, transA, transB, M_.data(), N_.data(), K_.data(), alpha, A, ldA_.data(), B, ldB_.data(),
+                    beta, C, ldC_.data(), groupCount, groupSize_.data());
+}
+
+inline void gemm_batch (
+  const CBLAS_LAYOUT& order,
+  const CBLAS_TRANSPOSE* transA,
+  const CBLAS_TRANSPOSE* transB,
+  const size_t* M,
+  const size_t* N,
+  const size_t* K,
+  const std::complex<float>* alpha,
+  const std::complex<float>** A,
+  const size_t* ldA,
+  const std::complex<float>** B,
+  const size_t* ldB,
+  const std::complex<float>* beta,
+        std::complex<float>** C,
+  const size_t* ldC,
+  const size_t& groupCount,
+  const size_t* groupSize)
+{
+  const std::vector<MKL_INT> M_ = detail::__mkl_int_array(M,groupCount);
+  const std::vector<MKL_INT> N_ = detail::__mkl_int_array(N,groupCount);
+  const std::vector<MKL_INT> K_ = detail::__mkl_int_array(K,groupCount);
+  const std::vector<MKL_INT> ldA_ = detail::__mkl_int_array(ldA,groupCount);
+  const std::vector<MKL_INT> ldB_ = detail::__mkl_int_array(ldB,groupCount);
+  const std::vector<MKL_INT> ldC_ = detail::__mkl_int_array(ldC,groupCount);
+  const std::vector<MKL_INT> groupSize_ = detail::__mkl_int_array(groupSize,groupCount);
+  cblas_cgemm_batch(order, transA, transB, M_.data(), N_.data(), K_.data(), alpha,
+                    reinterpret_cast<const void**>(A), ldA_.data(), reinterpret_cast<const void**>(B), ldB_.data(),
+                    beta, reinterpret_cast<void**>(C), ldC_.data(), groupCount, groupSize_.data());
+}
+
+inline void gemm_batch (
+  const CBLAS_LAYOUT& order,
+  const CBLAS_TRANSPOSE* transA,
+  const CBLAS_TRANSPOSE* transB,
+  const size_t* M,
+  const size_t* N,
+  const size_t* K,
+  const std::complex<double>* alpha,
+  const std::complex<double>** A,
+  const size_t* ldA,
+  const std::complex<double>** B,
+  const size_t* ldB,
+  const std::complex<double>* beta,
+        std::complex<double>** C,
+  const size_t* ldC,
+  const size_t& groupCount,
+  const size_t* groupSize)
+{
+  const std::vector<MKL_INT> M_ = detail::__mkl_int_array(M,groupCount);
+  const std::vector<MKL_INT> N_ = detail::__mkl_int_array(N,groupCount);
+  const std::vector<MKL_INT> K_ = detail::__mkl_int_array(K,groupCount);
+  const std::vector<MKL_INT> ldA_ = detail::__mkl_int_array(ldA,groupCount);
+  const std::vector<MKL_INT> ldB_ = detail::__mkl_int_array(ldB,groupCount);
+  const std::vector<MKL_INT> ldC_ = detail::__mkl_int_array(ldC,groupCount);
+  const std::vector<MKL_INT> groupSize_ = detail::__mkl_int_array(groupSize,groupCount);
+  cblas_zgemm_batch(order, transA, transB, M_.data(), N_.data(), K_.data(), alpha,
+                    reinterpret_cast<const void**>(A), ldA_.data(), reinterpret_cast<const void**>(B), ldB_.data(),
+                    beta, reinterpret_cast<void**>(C), ldC_.data(), groupCount, groupSize_.data());
+}
+
+#endif // _BTAS_CBLAS_GEMM_BATCH
+
+} // namespace btas
+
+#endif // __BTAS_BLAS_GEMM_BATCH_IMPL_H
@@ -0,0 +1,141 @@
+#ifndef __BTAS_BLAS_GEMM_BATCH_STRIDED_IMPL_H
+#define __BTAS_BLAS_GEMM_BATCH_STRIDED_IMPL_H
+
+#include <BTAS_assert.h>
+
+#include <blas/gemm_impl.h>
+
+// cblas_?gemm_batch_strided is available since Intel MKL 2020 update 2,
+// otherwise, batch of gemm is called in a loop.
+
+#if defined(__MKL_CBLAS__) && defined(INTEL_MKL_VERSION) && (INTEL_MKL_VERSION >= 20200002)
+#define _BTAS_CBLAS_GEMM_BATCH_STRIDED
+#endif
+
+namespace btas {
+
+/// generic gemm_batch_strided function, C[i*strideC] = alpha * op(A[i*strideA]) * op(B[i*strideB]) + beta * C[i*strideC]
+template<typename T>
+void gemm_batch_strided (
+  const CBLAS_LAYOUT& order,
+  const CBLAS_TRANSPOSE& transA,
+  const CBLAS_TRANSPOSE& transB,
+  const size_t& M,
+  const size_t& N,
+  const size_t& K,
+  const T& alpha,
+  const T* A,
+  const size_t& ldA,
+  const size_t& strideA,
+  const T* B,
+  const size_t& ldB,
+  const size_t& strideB,
+  const T& beta,
+        T* C,
+  const size_t& ldC,
+  const size_t& strideC,
+  const size_t& batchSize)
+{
+  for(size_t i = 0; i < batchSize; ++i)
+    gemm(order, transA, transB, M, N, K, alpha, A+i*strideA, ldA, B+i*strideB, ldB, beta, C+i*strideC, ldC);
+}
+
+#ifdef _BTAS_CBLAS_GEMM_BATCH_STRIDED
+
+inline void gemm_batch_strided (
+  const CBLAS_LAYOUT& order,
+  const CBLAS_TRANSPOSE& transA,
+  const CBLAS_TRANSPOSE& transB,
+  const size_t& M,
+  const size_t& N,
+  const size_t& K,
+  const float& alpha,
+  const float* A,
+  const size_t& ldA,
+  const size_t& strideA,
+  const float* B,
+  const size_t& ldB,
+  const size_t& strideB,
+  const float& beta,
+        float* C,
+  const size_t& ldC,
+  const size_t& strideC,
+  const size_t& batchSize)
+{
+  cblas_sgemm_batch_strided(order, transA, transB, M, N, K, alpha, A, ldA, strideA, B, ldB, strideB, beta, C, ldC, strideC, batchSize);
+}
+
+inline void gemm_batch_strided (
+  const CBLAS_LAYOUT& order,
+  const CBLAS_TRANSPOSE& transA,
+  const CBLAS_TRANSPOSE& transB,
+  const size_t& M,
+  const size_t& N,
+  const size_t& K,
+  const double& alpha,
+  const double* A,
+  const size_t& ldA,
+  const size_t& strideA,
+  const double* B,
+  const size_t& ldB,
+  const size_t& strideB,
+  const double& beta,
+        double* C,
+  const size_t& ldC,
+  const size_t& strideC,
+  const size_t& batchSize)
+{
+  cblas_dgemm_batch_strided(order, transA, transB, M, N, K, alpha, A, ldA, strideA, B, ldB, strideB, beta, C, ldC, strideC, batchSize);
+}
+
+inline void gemm_batch_strided (
+  const CBLAS_LAYOUT& order,
+  const CBLAS_TRANSPOSE& transA,
+  const CBLAS_TRANSPOSE& transB,
+  const size_t& M,
+  const size_t& N,
+  const size_t& K,
+  const std::complex<float>& alpha,
+  const std::complex<float>* A,
+  const size_t& ldA,
+  const size_t& strideA,
+  const std::complex<float>* B,
+  const size_t& ldB,
+  const size_t& strideB,
+  const std::complex<float>& beta,
+        std::complex<float>* C,
+  const size_t& ldC,
+  const size_t& strideC,
+  const size_t& batchSize)
+{
+  cblas_cgemm_batch_strided(order, transA, transB, M, N, K, &alpha, A, ldA, strideA, B, ldB, strideB, &beta, C, ldC, strideC, batchSize);
+}
+
+inline void gemm_batch_strided (
+  const CBLAS_LAYOUT& order,
+  const CBLAS_TRANSPOSE& transA,
+  const CBLAS_TRANSPOSE& transB,
+  const size_t& M,
+  const size_t& N,
+  const size_t& K,
+  const std::complex<double>& alpha,
+  const std::complex<double>* A,
+  const size_t& ldA,
+  const size_t& strideA,
+  const std::complex<double>* B,
+  const size_t& ldB,
+  const size_t& strideB,
+  const std::complex<double>& beta,
+        std::complex<double>* C,
+  const size_t& ldC,
+  const size_t& strideC,
+  const size_t& batchSize)
+{
+  cblas_zgemm_batch_strided(order, transA, transB, M, N, K, &alpha, A, ldA, strideA, B, ldB, strideB, &beta, C, ldC, strideC, batchSize);
+}
+
+#endif // _BTAS_CBLAS_GEMM_BATCH_STRIDED
+
+} // namespace btas
+
+#endif // __BTAS_BLAS_GEMM_BATCH_STRIDED_IMPL_H
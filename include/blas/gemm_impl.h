@@ -3,8 +3,38 @@
 
 #include <BTAS_assert.h>
 
+#include <blas/generic_impl.h>
+
+// complex GEMM by the 3M algorithm (cblas_?gemm3m), which uses 3 real matrix multiplications instead of 4.
+// it is opt-in since the accuracy is slightly worse than the conventional algorithm, i.e.
+// the error is bounded by norms of real and imaginary parts separately, and is used only if M*N*K >= _BTAS_GEMM3M_THRESHOLD,
+// since additions of matrices are not paid off for small matrices.
+#if defined(_BTAS_USE_GEMM3M) && defined(_BTAS_CBLAS_HAS_GEMM3M)
+#define _BTAS_GEMM3M_ENABLED
+#endif
+
+#ifndef _BTAS_GEMM3M_THRESHOLD
+#define _BTAS_GEMM3M_THRESHOLD 1000000
+#endif
+
 namespace btas {
 
+namespace detail {
+
+/// return true if complex GEMM of M x N x K is carried out by the 3M algorithm
+inline bool __use_gemm3m (const size_t& M, const size_t& N, const size_t& K)
+{
+#ifdef _BTAS_GEMM3M_ENABLED
+  return static_cast<double>(M)*N*K >= static_cast<double>(_BTAS_GEMM3M_THRESHOLD);
+#else
+  (void)M; (void)N; (void)K;
+  return false;
+#endif
+}
+
+} // namespace detail
+
+/// generic gemm function, blocked and threaded (see detail::__generic_gemm)
 template<typename T>
 void gemm (
   const CBLAS_LAYOUT& order,
@@ -22,7 +52,13 @@ void gemm (
         T* C,
   const size_t& ldC)
 {
-  BTAS_assert(false, "gemm is not implemented.");
+  // column-major C = op(A) * op(B) is computed as row-major C^T = op(B)^T * op(A)^T
+  if(order == CblasRowMajor)
+    detail::__generic_gemm(transA != CblasNoTrans, transA == CblasConjTrans, transB != CblasNoTrans, transB == CblasConjTrans,
+                           M, N, K, alpha, A, ldA, B, ldB, beta, C, ldC);
+  else
+    detail::__generic_gemm(transB != CblasNoTrans, transB == CblasConjTrans, transA != CblasNoTrans, transA == CblasConjTrans,
+                           N, M, K, alpha, B, ldB, A, ldA, beta, C, ldC);
 }
 
 inline void gemm (
@@ -79,6 +115,12 @@ inline void gemm (
         std::complex<float>* C,
   const size_t& ldC)
 {
+#ifdef _BTAS_GEMM3M_ENABLED
+  if(detail::__use_gemm3m(M, N, K)) {
+    cblas_cgemm3m(order, transA, transB, M, N, K, &alpha, A, ldA, B, ldB, &beta, C, ldC);
+    return;
+  }
+#endif
   cblas_cgemm(order, transA, transB, M, N, K, &alpha, A, ldA, B, ldB, &beta, C, ldC);
 }
 
@@ -98,6 +140,12 @@ inline void gemm (
         std::complex<double>* C,
   const size_t& ldC)
 {
+#ifdef _BTAS_GEMM3M_ENABLED
+  if(detail::__use_gemm3m(M, N, K)) {
+    cblas_zgemm3m(order, transA, transB, M, N, K, &alpha, A, ldA, B, ldB, &beta, C, ldC);
+    return;
+  }
+#endif
   cblas_zgemm(order, transA, transB, M, N, K, &alpha, A, ldA, B, ldB, &beta, C, ldC);
 }
 
@@ -3,8 +3,11 @@
 
 #include <BTAS_assert.h>
 
+#include <blas/generic_impl.h>
+
 namespace btas {
 
+/// generic gemv function (see detail::__generic_gemv)
 template<typename T>
 void gemv (
   const CBLAS_LAYOUT& order,
@@ -20,7 +23,11 @@ void gemv (
         T* Y,
   const size_t& incY)
 {
-  BTAS_assert(false, "gemv is not implemented.");
+  // column-major A (M x N) is row-major A^T (N x M)
+  if(order == CblasRowMajor)
+    detail::__generic_gemv(transA != CblasNoTrans, transA == CblasConjTrans, M, N, alpha, A, ldA, X, incX, beta, Y, incY);
+  else
+    detail::__generic_gemv(transA == CblasNoTrans, transA == CblasConjTrans, N, M, alpha, A, ldA, X, incX, beta, Y, incY);
 }
 
 inline void gemv (
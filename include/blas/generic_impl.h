@@ -0,0 +1,360 @@
+#ifndef __BTAS_BLAS_GENERIC_IMPL_H
+#define __BTAS_BLAS_GENERIC_IMPL_H
+
+#include <vector>
+#include <complex>
+#include <algorithm> // std::min, std::fill
+
+#include <parallel.h>
+
+// Generic BLAS kernels for value types w/o BLAS library, e.g. long double, __float128, double-double or dual numbers.
+// T needs only T(0), T(1), +, * and ==, and std::conj is used for ConjTrans if T is std::complex.
+// GEMM is blocked in the same way as GotoBLAS/BLIS, i.e.
+//   jc : NC columns of B and C
+//   pc : KC-depth panel of B, packed in NR-wide slivers (shared by all threads)
+//   ic : MC rows of A and C, packed in MR-high slivers (one per thread)
+//   jr, ir : MR x NR micro-kernel, accumulated in registers
+
+/// block sizes of generic GEMM, tuned for 16-byte value types (e.g. long double) in 32 KB L1 and 256 KB L2 caches
+#ifndef _BTAS_GENERIC_GEMM_MC
+#define _BTAS_GENERIC_GEMM_MC 64ul
+#endif
+
+#ifndef _BTAS_GENERIC_GEMM_KC
+#define _BTAS_GENERIC_GEMM_KC 128ul
+#endif
+
+#ifndef _BTAS_GENERIC_GEMM_NC
+#define _BTAS_GENERIC_GEMM_NC 1024ul
+#endif
+
+/// min. number of multiply-adds to run generic kernels on multiple threads
+#ifndef _BTAS_GENERIC_PARALLEL_THRESHOLD
+#define _BTAS_GENERIC_PARALLEL_THRESHOLD 65536ul
+#endif
+
+namespace btas {
+
+namespace detail {
+
+/// register block (MR x NR) of micro-kernel, 4 x 4 for types held in SSE/AVX registers
+template<typename T>
+struct __generic_gemm_block {
+  static constexpr size_t mr = 4;
+  static constexpr size_t nr = 4;
+};
+
+/// long double is computed on the x87 stack of 8 registers, for which 4 x 4 accumulators spill
+template<>
+struct __generic_gemm_block<long double> {
+  static constexpr size_t mr = 2;
+  static constexpr size_t nr = 2;
+};
+
+template<>
+struct __generic_gemm_block<std::complex<long double>> {
+  static constexpr size_t mr = 2;
+  static constexpr size_t nr = 2;
+};
+
+/// conjugate if T is complex
+template<typename T>
+inline T __generic_conj (const T& x) { return x; }
+
+template<typename T>
+inline std::complex<T> __generic_conj (const std::complex<T>& x) { return std::conj(x); }
+
+/// element (i,j) of op(X) for row-major X
+template<typename T>
+inline T __generic_at (const T* X, size_t ldX, bool trans, bool conj, size_t i, size_t j)
+{
+  const T& x = trans ? X[j*ldX+i] : X[i*ldX+j];
+  return conj ? __generic_conj(x) : x;
+}
+
+/// y = alpha * x + y
+template<typename T>
+void __generic_axpy (size_t N, const T& alpha, const T* X, size_t incX, T* Y, size_t incY)
+{
+  const bool is_parallel = (N >= _BTAS_GENERIC_PARALLEL_THRESHOLD && __max_threads() > 1);
+
+#ifdef _OPENMP
+#pragma omp parallel if(is_parallel)
+#endif
+  {
+    size_t first = 0;
+    size_t last  = N;
+    if(is_parallel) __thread_range(N,first,last);
+
+    if(incX == 1 && incY == 1)
+      for(size_t i = first; i < last; ++i) Y[i] += alpha*X[i];
+    else
+      for(size_t i = first; i < last; ++i) Y[i*incY] += alpha*X[i*incX];
+  }
+}
+
+/// sum of x[i] * y[i] (conj(x[i]) * y[i] if conj), accumulated in 4 partial sums to hide latency
+template<typename T>
+T __generic_dot (size_t N, const T* X, size_t incX, const T* Y, size_t incY, bool conj)
+{
+  const bool is_parallel = (N >= _BTAS_GENERIC_PARALLEL_THRESHOLD && __max_threads() > 1);
+
+  T sum = static_cast<T>(0);
+
+#ifdef _OPENMP
+#pragma omp parallel if(is_parallel)
+#endif
+  {
+    size_t first = 0;
+    size_t last  = N;
+    if(is_parallel) __thread_range(N,first,last);
+
+    T s[4] = { static_cast<T>(0), static_cast<T>(0), static_cast<T>(0), static_cast<T>(0) };
+    size_t i = first;
+    if(conj) {
+      for(; i+4 <= last; i += 4)
+        for(size_t u = 0; u < 4; ++u) s[u] += __generic_conj(X[(i+u)*incX])*Y[(i+u)*incY];
+      for(; i < last; ++i) s[0] += __generic_conj(X[i*incX])*Y[i*incY];
+    }
+    else {
+      for(; i+4 <= last; i += 4)
+        for(size_t u = 0; u < 4; ++u) s[u] += X[(i+u)*incX]*Y[(i+u)*incY];
+      for(; i < last; ++i) s[0] += X[i*incX]*Y[i*incY];
+    }
+    const T s_ = (s[0]+s[1])+(s[2]+s[3]);
+
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+    sum += s_;
+  }
+
+  return sum;
+}
+
+/// y = alpha * op(A) * x + beta * y for row-major A (M x N)
+/// rows of op(A) are split over threads if op(A) = A, and columns otherwise, so that A is read contiguously
+template<typename T>
+void __generic_gemv (bool trans, bool conj, size_t M, size_t N, const T& alpha, const T* A, size_t ldA,
+                     const T* X, size_t incX, const T& beta, T* Y, size_t incY)
+{
+  const size_t ny = trans ? N : M;
+  const size_t nx = trans ? M : N;
+  const bool is_parallel = (M*N >= _BTAS_GENERIC_PARALLEL_THRESHOLD && __max_threads() > 1);
+
+#ifdef _OPENMP
+#pragma omp parallel if(is_parallel)
+#endif
+  {
+    size_t first = 0;
+    size_t last  = ny;
+    if(is_parallel) __thread_range(ny,first,last);
+
+    for(size_t i = first; i < last; ++i) {
+      if(beta == static_cast<T>(0))
+        Y[i*incY] = static_cast<T>(0);
+      else if(beta != static_cast<T>(1))
+        Y[i*incY] *= beta;
+    }
+
+    if(!trans) {
+      // y[i] += alpha * sum_j op(A)[i,j] * x[j]
+      for(size_t i = first; i < last; ++i) {
+        const T* a = A+i*ldA;
+        T s[4] = { static_cast<T>(0), static_cast<T>(0), static_cast<T>(0), static_cast<T>(0) };
+        size_t j = 0;
+        for(; j+4 <= nx; j += 4)
+          for(size_t u = 0; u < 4; ++u) s[u] += (conj ? __generic_conj(a[j+u]) : a[j+u])*X[(j+u)*incX];
+        for(; j < nx; ++j) s[0] += (conj ? __generic_conj(a[j]) : a[j])*X[j*incX];
+        Y[i*incY] += alpha*((s[0]+s[1])+(s[2]+s[3]));
+      }
+    }
+    else {
+      // y[j] += alpha * sum_i A[i,j] * x[i], each thread has columns [first,last)
+      for(size_t i = 0; i < nx; ++i) {
+        const T* a = A+i*ldA;
+        const T ax = alpha*X[i*incX];
+        if(conj)
+          for(size_t j = first; j < last; ++j) Y[j*incY] += __generic_conj(a[j])*ax;
+        else
+          for(size_t j = first; j < last; ++j) Y[j*incY] += a[j]*ax;
+      }
+    }
+  }
+}
+
+/// A += alpha * x * y^T (y^H if conj) for A (M x N) of row-major if row, and column-major otherwise
+/// rows of A are split over threads if row-major, and columns otherwise
+template<typename T>
+void __generic_ger (bool row, bool conj, size_t M, size_t N, const T& alpha, const T* X, size_t incX,
+                    const T* Y, size_t incY, T* A, size_t ldA)
+{
+  const size_t nouter = row ? M : N;
+  const size_t ninner = row ? N : M;
+  const bool is_parallel = (M*N >= _BTAS_GENERIC_PARALLEL_THRESHOLD && __max_threads() > 1);
+
+#ifdef _OPENMP
+#pragma omp parallel if(is_parallel)
+#endif
+  {
+    size_t first = 0;
+    size_t last  = nouter;
+    if(is_parallel) __thread_range(nouter,first,last);
+
+    for(size_t o = first; o < last; ++o) {
+      T* a = A+o*ldA;
+      if(row) {
+        const T ax = alpha*X[o*incX];
+        for(size_t j = 0; j < ninner; ++j) a[j] += ax*(conj ? __generic_conj(Y[j*incY]) : Y[j*incY]);
+      }
+      else {
+        const T ay = alpha*(conj ? __generic_conj(Y[o*incY]) : Y[o*incY]);
+        for(size_t i = 0; i < ninner; ++i) a[i] += X[i*incX]*ay;
+      }
+    }
+  }
+}
+
+/// pack mc x kc block of op(A) into MR-high slivers, padded w/ zeros, i.e. Ap[ir][p][0:MR]
+template<typename T>
+void __generic_pack_a (const T* A, size_t ldA, bool trans, bool conj, size_t ic, size_t pc, size_t mc, size_t kc, T* Ap)
+{
+  const size_t mr = __generic_gemm_block<T>::mr;
+  for(size_t ir = 0; ir < mc; ir += mr) {
+    const size_t m = std::min(mr,mc-ir);
+    for(size_t p = 0; p < kc; ++p) {
+      size_t i = 0;
+      for(; i < m; ++i) Ap[i] = __generic_at(A,ldA,trans,conj,ic+ir+i,pc+p);
+      for(; i < mr; ++i) Ap[i] = static_cast<T>(0);
+      Ap += mr;
+    }
+  }
+}
+
+/// pack kc x nc panel of op(B) into NR-wide slivers, padded w/ zeros, i.e. Bp[jr][p][0:NR]
+/// slivers [first,last) are packed by the calling thread
+template<typename T>
+void __generic_pack_b (const T* B, size_t ldB, bool trans, bool conj, size_t pc, size_t jc, size_t kc, size_t nc,
+                       size_t first, size_t last, T* Bp)
+{
+  const size_t nr = __generic_gemm_block<T>::nr;
+  for(size_t s = first; s < last; ++s) {
+    const size_t jr = s*nr;
+    const size_t n = std::min(nr,nc-jr);
+    T* b = Bp+s*nr*kc;
+    for(size_t p = 0; p < kc; ++p) {
+      size_t j = 0;
+      for(; j < n; ++j) b[j] = __generic_at(B,ldB,trans,conj,pc+p,jc+jr+j);
+      for(; j < nr; ++j) b[j] = static_cast<T>(0);
+      b += nr;
+    }
+  }
+}
+
+/// micro-kernel, C[0:m,0:n] += alpha * Ap * Bp, where Ap is MR x kc and Bp is kc x NR
+template<typename T>
+inline void __generic_gemm_kernel (size_t kc, const T& alpha, const T* Ap, const T* Bp, T* C, size_t ldC, size_t m, size_t n)
+{
+  const size_t mr = __generic_gemm_block<T>::mr;
+  const size_t nr = __generic_gemm_block<T>::nr;
+
+  T c[__generic_gemm_block<T>::mr][__generic_gemm_block<T>::nr];
+  for(size_t i = 0; i < mr; ++i)
+    for(size_t j = 0; j < nr; ++j) c[i][j] = static_cast<T>(0);
+
+  for(size_t p = 0; p < kc; ++p, Ap += mr, Bp += nr)
+    for(size_t i = 0; i < mr; ++i)
+      for(size_t j = 0; j < nr; ++j) c[i][j] += Ap[i]*Bp[j];
+
+  for(size_t i = 0; i < m; ++i)
+    for(size_t j = 0; j < n; ++j) C[i*ldC+j] += alpha*c[i][j];
+}
+
+/// C = alpha * op(A) * op(B) + beta * C for row-major A, B and C
+template<typename T>
+void __generic_gemm (bool transA, bool conjA, bool transB, bool conjB, size_t M, size_t N, size_t K,
+                     const T& alpha, const T* A, size_t ldA, const T* B, size_t ldB, const T& beta, T* C, size_t ldC)
+{
+  const size_t mr = __generic_gemm_block<T>::mr;
+  const size_t nr = __generic_gemm_block<T>::nr;
+  const size_t MC = (_BTAS_GENERIC_GEMM_MC+mr-1)/mr*mr;
+  const size_t KC = _BTAS_GENERIC_GEMM_KC;
+  const size_t NC = (_BTAS_GENERIC_GEMM_NC+nr-1)/nr*nr;
+
+  const bool is_parallel = (M*N*K >= _BTAS_GENERIC_PARALLEL_THRESHOLD && __max_threads() > 1);
+  const bool is_zero = (alpha == static_cast<T>(0) || K == 0);
+
+  // shared panel of B
+  std::vector<T> Bp(is_zero ? 0 : std::min(KC,K)*std::min(NC,(N+nr-1)/nr*nr));
+
+#ifdef _OPENMP
+#pragma omp parallel if(is_parallel)
+#endif
+  {
+    size_t first = 0;
+    size_t last  = M;
+    if(is_parallel) __thread_range(M,first,last);
+
+    // C = beta * C
+    for(size_t i = first; i < last; ++i) {
+      T* c = C+i*ldC;
+      if(beta == static_cast<T>(0))
+        std::fill(c,c+N,static_cast<T>(0));
+      else if(beta != static_cast<T>(1))
+        for(size_t j = 0; j < N; ++j) c[j] *= beta;
+    }
+
+    if(!is_zero) {
+      std::vector<T> Ap(MC*std::min(KC,K));
+
+      for(size_t jc = 0; jc < N; jc += NC) {
+        const size_t nc = std::min(NC,N-jc);
+        const size_t nslivers = (nc+nr-1)/nr;
+
+        for(size_t pc = 0; pc < K; pc += KC) {
+          const size_t kc = std::min(KC,K-pc);
+
+#ifdef _OPENMP
+#pragma omp barrier
+#endif
+          size_t sfirst = 0;
+          size_t slast  = nslivers;
+          if(is_parallel) __thread_range(nslivers,sfirst,slast);
+          __generic_pack_b(B,ldB,transB,conjB,pc,jc,kc,nc,sfirst,slast,Bp.data());
+#ifdef _OPENMP
+#pragma omp barrier
+#endif
+
+          // blocks of (ic, jr) are split over threads, s.t. small M is still parallelized
+          const size_t nblocks_m = (M+MC-1)/MC;
+          const size_t nblocks = nblocks_m*nslivers;
+          size_t bfirst = 0;
+          size_t blast  = nblocks;
+          if(is_parallel) __thread_range(nblocks,bfirst,blast);
+
+          size_t packed = nblocks_m; // ic-block in Ap
+          for(size_t b = bfirst; b < blast; ++b) {
+            const size_t ib = b/nslivers;
+            const size_t s  = b%nslivers;
+            const size_t ic = ib*MC;
+            const size_t mc = std::min(MC,M-ic);
+            if(packed != ib) {
+              __generic_pack_a(A,ldA,transA,conjA,ic,pc,mc,kc,Ap.data());
+              packed = ib;
+            }
+            const size_t jr = s*nr;
+            const size_t n = std::min(nr,nc-jr);
+            for(size_t ir = 0; ir < mc; ir += mr)
+              __generic_gemm_kernel(kc,alpha,Ap.data()+ir*kc,Bp.data()+s*nr*kc,C+(ic+ir)*ldC+jc+jr,ldC,std::min(mr,mc-ir),n);
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace detail
+
+} // namespace btas
+
+#endif // __BTAS_BLAS_GENERIC_IMPL_H
@@ -3,8 +3,11 @@
 
 #include <BTAS_assert.h>
 
+#include <blas/generic_impl.h>
+
 namespace btas {
 
+/// generic geru function (see detail::__generic_ger)
 template<typename T>
 void geru (
   const CBLAS_LAYOUT& order,
@@ -18,9 +21,10 @@ void geru (
         T* A,
   const size_t& ldA)
 {
-  BTAS_assert(false, "geru is not implemented.");
+  detail::__generic_ger(order == CblasRowMajor, false, M, N, alpha, X, incX, Y, incY, A, ldA);
 }
 
+/// generic gerc function (see detail::__generic_ger)
 template<typename T>
 void gerc (
   const CBLAS_LAYOUT& order,
@@ -34,7 +38,7 @@ void gerc (
         T* A,
   const size_t& ldA)
 {
-  BTAS_assert(false, "gerc is not implemented.");
+  detail::__generic_ger(order == CblasRowMajor, true, M, N, alpha, X, incX, Y, incY, A, ldA);
 }
 
 inline void ger (
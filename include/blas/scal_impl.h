@@ -5,14 +5,15 @@
 
 namespace btas {
 
-template<typename Scalar, typename T, typename U>
+/// generic scal function, alpha must have the same type as x
+template<typename T>
 void scal (
   const size_t& N,
-  const Scalar& alpha,
+  const T& alpha,
         T* X,
   const size_t& incX)
 {
-  BTAS_assert(false, "scal is not implemented.");
+  for(size_t i = 0; i < N; ++i) X[i*incX] *= alpha;
 }
 
 inline void scal (
@@ -1,12 +1,8 @@
 #ifndef __BTAS_HEADER_INCLUDED
 #define __BTAS_HEADER_INCLUDED
 
-#include <complex>
-
-#define lapack_complex_float  std::complex<float>
-#define lapack_complex_double std::complex<double>
-
-#include <mkl.h>
+// BLAS/LAPACK backend is selected by _BTAS_USE_MKL (default), _BTAS_USE_OPENBLAS, _BTAS_USE_BLIS or _BTAS_USE_REFERENCE
+#include <backend.h>
 
 // Dense tensor class
 #include <Tensor.hpp>
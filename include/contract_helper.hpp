@@ -1,25 +1,293 @@
 #ifndef __BTAS_CONTRACT_HELPER_HPP
 #define __BTAS_CONTRACT_HELPER_HPP
 
+#include <set>
+#include <array>
+#include <map>
+#include <vector>
+#include <limits>
+#include <ostream>
+#include <cassert>
+#include <algorithm> // std::equal, std::reverse, std::min, std::swap, std::sort, std::find
+
+#include <BTAS_assert.h>
+#include <blas.h>
+
+#include <permute.hpp>
+#include <TensorWrapper.hpp>
+#include <Workspace.hpp>
+
 namespace btas {
 
+/// Layout of contraction c = a * b by a single GEMM, i.e. which of a, b and c are permuted, and trans flags
+/// a is used as (free,contracted), or (contracted,free) if transposed, b is used as (contracted,free), or (free,contracted) if transposed
+struct contract_layout {
+
+  std::vector<size_t> pmuta; ///< permutation of a, empty if a is used as is
+
+  std::vector<size_t> pmutb; ///< permutation of b, empty if b is used as is
+
+  std::vector<size_t> pmutc; ///< permutation of a*b into c, empty if a*b is written into c directly
+
+  bool is_a_trans; ///< trans flag of a
+
+  bool is_b_trans; ///< trans flag of b
+
+  bool is_c_swapped; ///< true if a*b is computed as (b^T * a^T)^T, i.e. free indices of b come first
+
+  double bytes; ///< estimated bytes moved by permutations
+
+  contract_layout () : is_a_trans(false), is_b_trans(false), is_c_swapped(false), bytes(0.0) { }
+
+};
+
+/// print the layout for logging, e.g. "a{0,2,1} b{-} c{-} (N,T) 6.72e+03 bytes", (N,T)^T if swapped
+inline std::ostream& operator<< (std::ostream& ost, const contract_layout& layout)
+{
+  const std::vector<size_t>* pmut[] = { &layout.pmuta, &layout.pmutb, &layout.pmutc };
+  const char* name[] = { "a{", "b{", "c{" };
+  for(size_t i = 0; i < 3; ++i) {
+    ost << name[i];
+    if(pmut[i]->empty()) ost << "-";
+    for(size_t j = 0; j < pmut[i]->size(); ++j) ost << (j > 0 ? "," : "") << (*pmut[i])[j];
+    ost << "} ";
+  }
+  ost << "(" << (layout.is_a_trans ? "T" : "N") << "," << (layout.is_b_trans ? "T" : "N") << ")" << (layout.is_c_swapped ? "^T " : " ") << layout.bytes << " bytes";
+  return ost;
+}
+
+namespace detail {
+
+/// candidate of operand layout, either used as is (transposed or not) or permuted
+struct __operand_layout {
+  std::vector<size_t> order; ///< order of indices after permutation
+  std::vector<size_t> free; ///< order of free indices
+  bool is_trans;
+  bool is_permuted;
+};
+
+/// enumerate candidates of operand x, whose free indices are f (in order of x) or fc (in order of c), and contracted indices are k
+/// \param first_k true if (contracted,free) is not transposed, i.e. b
+inline void __make_operand_layouts (
+  size_t rank, const std::vector<size_t>& f, const std::vector<size_t>& fc, const std::vector<size_t>& k,
+  bool first_k, std::vector<__operand_layout>& cand)
+{
+  cand.clear();
+
+  __operand_layout fk; // (free,contracted)
+  fk.order = f; fk.order.insert(fk.order.end(),k.begin(),k.end());
+  fk.free = f;
+
+  __operand_layout kf; // (contracted,free)
+  kf.order = k; kf.order.insert(kf.order.end(),f.begin(),f.end());
+  kf.free = f;
+
+  bool is_fk = true; for(size_t i = 0; i < rank; ++i) if(fk.order[i] != i) { is_fk = false; break; }
+  bool is_kf = true; for(size_t i = 0; i < rank; ++i) if(kf.order[i] != i) { is_kf = false; break; }
+
+  if(is_fk) { fk.is_trans = first_k; fk.is_permuted = false; cand.push_back(fk); }
+  if(is_kf) { kf.is_trans = !first_k; kf.is_permuted = false; cand.push_back(kf); }
+
+  // permuted into the order of free indices in c
+  __operand_layout pc;
+  pc.order = first_k ? k : fc;
+  pc.order.insert(pc.order.end(),(first_k ? fc : k).begin(),(first_k ? fc : k).end());
+  pc.free = fc;
+  pc.is_trans = false;
+  pc.is_permuted = true;
+  bool is_identity = true; for(size_t i = 0; i < rank; ++i) if(pc.order[i] != i) { is_identity = false; break; }
+  if(!is_identity) cand.push_back(pc);
+}
+
+/// resize index or extent of dynamic rank, or check the rank of std::array
+template<typename T, size_t N>
+void __contract_resize (std::array<T,N>&, size_t n)
+{
+  BTAS_assert(n == N,"contract, detected inconsistent rank of tensor and indices.");
+}
+
+template<typename T>
+void __contract_resize (std::vector<T>& x, size_t n)
+{
+  x.resize(n);
+}
+
+} // namespace detail
+
+/// determine the layout of contraction which moves the fewest bytes, by enumerating
+/// 1) order of contracted indices, either in the order of a or in the order of b,
+/// 2) a and b used as is with trans flags, or permuted into the order of c,
+/// 3) a*b written into c directly, (b^T * a^T)^T written into c directly if free indices of b come first in c, or permuted into c.
+/// \param pmutc permutation from a*b (free indices of a followed by those of b) to c, s.t. c's i-th index is a*b's pmutc[i]-th index
+/// \param elem size of value type in bytes
+template<class ExtentA, class ExtentB, class Index, class IndexC>
+void make_contract_layout (
+  const ExtentA& exta, const Index& idxa,
+  const ExtentB& extb, const Index& idxb,
+  const IndexC& pmutc, size_t elem, contract_layout& layout)
+{
+  assert(idxa.size() == idxb.size());
+
+  const size_t L = exta.size();
+  const size_t M = extb.size();
+  const size_t K = idxa.size();
+  const size_t N = L+M-K-K;
+
+  BTAS_assert(pmutc.size() == N,"make_contract_layout, detected inconsistent size of permutation of c.");
+
+  // fast path: a and b are in matrix form w/ contracted indices in the same order, and c is not permuted
+  {
+    bool is_matrix = true;
+    for(size_t i = 0; i < N && is_matrix; ++i) is_matrix = (pmutc[i] == i);
+    for(size_t i = 1; i < K && is_matrix; ++i) is_matrix = (idxa[i] == idxa[0]+i && idxb[i] == idxb[0]+i);
+    if(is_matrix && K > 0) is_matrix = (idxa[0] == 0 || idxa[0] == L-K) && (idxb[0] == 0 || idxb[0] == M-K);
+    if(is_matrix) {
+      layout = contract_layout();
+      layout.is_a_trans = (K > 0 && idxa[0] != L-K);
+      layout.is_b_trans = (K > 0 && idxb[0] != 0);
+      return;
+    }
+  }
+
+  // free indices in the order of a and b
+  std::vector<bool> is_free_a(L,true); for(size_t i = 0; i < K; ++i) is_free_a[idxa[i]] = false;
+  std::vector<bool> is_free_b(M,true); for(size_t i = 0; i < K; ++i) is_free_b[idxb[i]] = false;
+  std::vector<size_t> fa; for(size_t i = 0; i < L; ++i) if(is_free_a[i]) fa.push_back(i);
+  std::vector<size_t> fb; for(size_t i = 0; i < M; ++i) if(is_free_b[i]) fb.push_back(i);
+  const size_t Na = fa.size();
+
+  // free indices in the order of c
+  std::vector<size_t> fac;
+  std::vector<size_t> fbc;
+  for(size_t i = 0; i < N; ++i) {
+    if(pmutc[i] < Na) fac.push_back(fa[pmutc[i]]);
+    else              fbc.push_back(fb[pmutc[i]-Na]);
+  }
+
+  size_t sizea = 1; for(size_t i = 0; i < L; ++i) sizea *= exta[i];
+  size_t sizeb = 1; for(size_t i = 0; i < M; ++i) sizeb *= extb[i];
+  size_t sizec = 1; for(size_t i = 0; i < Na; ++i) sizec *= exta[fa[i]];
+  for(size_t i = 0; i < fb.size(); ++i) sizec *= extb[fb[i]];
+
+  // contraction pairs in the order of a, and in the order of b
+  std::vector<std::pair<size_t,size_t>> pairs(K);
+  for(size_t i = 0; i < K; ++i) pairs[i] = std::make_pair(idxa[i],idxb[i]);
+
+  const double inf = std::numeric_limits<double>::max();
+  double best_bytes = inf;
+  size_t best_count = 0;
+
+  std::vector<detail::__operand_layout> cand_a;
+  std::vector<detail::__operand_layout> cand_b;
+  std::vector<size_t> pmutc_tmp(N);
+
+  for(size_t order = 0; order < 2; ++order) {
+    if(order == 0)
+      std::sort(pairs.begin(),pairs.end());
+    else
+      std::sort(pairs.begin(),pairs.end(),[] (const std::pair<size_t,size_t>& x, const std::pair<size_t,size_t>& y) { return x.second < y.second; });
+
+    std::vector<size_t> ka(K);
+    std::vector<size_t> kb(K);
+    for(size_t i = 0; i < K; ++i) { ka[i] = pairs[i].first; kb[i] = pairs[i].second; }
+
+    detail::__make_operand_layouts(L,fa,fac,ka,false,cand_a);
+    detail::__make_operand_layouts(M,fb,fbc,kb,true, cand_b);
+
+    for(size_t ia = 0; ia < cand_a.size(); ++ia) {
+      for(size_t ib = 0; ib < cand_b.size(); ++ib) {
+        const detail::__operand_layout& la = cand_a[ia];
+        const detail::__operand_layout& lb = cand_b[ib];
+
+        // a*b has free indices in order of (la.free, lb.free), or (lb.free, la.free) if swapped
+        for(size_t swap = 0; swap < ((Na > 0 && Na < N) ? 2 : 1); ++swap) {
+          const size_t offa = swap ? N-Na : 0;
+          const size_t offb = swap ? 0 : Na;
+          bool is_c_permuted = false;
+          for(size_t i = 0; i < N; ++i) {
+            if(pmutc[i] < Na)
+              pmutc_tmp[i] = offa+(std::find(la.free.begin(),la.free.end(),fa[pmutc[i]])-la.free.begin());
+            else
+              pmutc_tmp[i] = offb+(std::find(lb.free.begin(),lb.free.end(),fb[pmutc[i]-Na])-lb.free.begin());
+            if(pmutc_tmp[i] != i) is_c_permuted = true;
+          }
+
+          double bytes = 0.0;
+          if(la.is_permuted) bytes += 2.0*sizea*elem;
+          if(lb.is_permuted) bytes += 2.0*sizeb*elem;
+          if(is_c_permuted)  bytes += 2.0*sizec*elem;
+          size_t count = la.is_permuted+lb.is_permuted+is_c_permuted;
+
+          if(bytes < best_bytes || (bytes == best_bytes && count < best_count)) {
+            best_bytes = bytes;
+            best_count = count;
+            layout.pmuta.clear(); if(la.is_permuted) layout.pmuta = la.order;
+            layout.pmutb.clear(); if(lb.is_permuted) layout.pmutb = lb.order;
+            layout.pmutc.clear(); if(is_c_permuted)  layout.pmutc = pmutc_tmp;
+            layout.is_a_trans = la.is_trans;
+            layout.is_b_trans = lb.is_trans;
+            layout.is_c_swapped = (swap > 0);
+            layout.bytes = bytes;
+          }
+        }
+      }
+    }
+  }
+}
+
+/// determine permutations and trans flags to carry out contraction by a single BLAS call (see blasCall)
+/// the operand to be permuted is chosen by make_contract_layout, c is not permuted
+/// \param pmuta permutation of 'a', which is empty if 'a' is used as is
+/// \param pmutb permutation of 'b', which is empty if 'b' is used as is
+/// NOTE: trans flags follow blasWrapper_, i.e. if 'a' is fully contracted, is_b_trans is for gemv(transb,b,a,c)
+template<class ExtentA, class ExtentB, class Index>
+void make_contract_flags (
+  const ExtentA& exta, const Index& idxa,
+  const ExtentB& extb, const Index& idxb,
+  std::vector<size_t>& pmuta, bool& is_a_trans,
+  std::vector<size_t>& pmutb, bool& is_b_trans)
+{
+  const size_t N = exta.size()+extb.size()-2*idxa.size();
+  std::vector<size_t> pmutc(N);
+  for(size_t i = 0; i < N; ++i) pmutc[i] = i;
+
+  contract_layout layout;
+  make_contract_layout(exta,idxa,extb,idxb,pmutc,1ul,layout);
+  assert(layout.pmutc.empty() && !layout.is_c_swapped);
+
+  pmuta.swap(layout.pmuta); is_a_trans = layout.is_a_trans;
+  pmutb.swap(layout.pmutb); is_b_trans = layout.is_b_trans;
+
+  // GEMVT case: gemv(Trans,B,A,C) for (contracted,free) of b
+  if(exta.size() == idxa.size()) is_b_trans = !is_b_trans;
+}
+
 /// helper class to determine flags to call contract function
+/// permuted a and/or b are taken from the thread-local Workspace, which are released when the helper is destructed
 template<class TensorA, class TensorB, class Index>
 class contract_helper {
 
 private:
 
-  const TensorA* refa_;
+  typedef typename TensorA::value_type value_type;
+
+  typedef TensorBase<value_type,TensorA::rank(),TensorA::layout()> base_a_;
+
+  typedef TensorBase<value_type,TensorB::rank(),TensorB::layout()> base_b_;
+
+  Workspace::Scope scope_;
+
+  const base_a_* refa_;
 
   bool is_a_trans_;
 
-  TensorA tmpa_;
+  TensorWrapper<value_type*,TensorA::rank(),TensorA::layout()> tmpa_;
 
-  const TensorB* refb_;
+  const base_b_* refb_;
 
   bool is_b_trans_;
 
-  TensorB tmpb_;
+  TensorWrapper<value_type*,TensorB::rank(),TensorB::layout()> tmpb_;
 
   // some default constructors have deleted
 
@@ -36,92 +304,406 @@ public:
   CBLAS_TRANSPOSE transb () const { return is_b_trans_ ? CblasTrans : CblasNoTrans; }
 
   /// release the reference to tensor 'a'
-  const TensorA& get_a () const { return *refa_; }
+  const base_a_& get_a () const { return *refa_; }
 
   /// release the reference to tensor 'b'
-  const TensorB& get_b () const { return *refb_; }
+  const base_b_& get_b () const { return *refb_; }
 
   /// constructor
   /// tuning a contraction job to determine trans flags and/or permute tensors upon construction
   contract_helper (const TensorA& a, const Index& idxa, const TensorB& b, const Index& idxb)
   : refa_(&a), is_a_trans_(false), refb_(&b), is_b_trans_(false)
   {
-    assert(idxa.size() == idxb.size());
-
-    const size_t M = a.rank();
-    const size_t N = b.rank();
-    const size_t K = idxa.size();
-
-    // make set for index search
-    std::set<size_t> idxa_set(idxa.begin(),idxa.end());
-    std::set<size_t> idxb_set(idxb.begin(),idxb.end());
-
-    if(M == K) {
-      // GEMVT case: gemv(Trans,B,A,C)
-      is_b_trans_ = !is_b_trans_;
-      if(!std::equal(idxa.begin(),idxa.end(),idxa_set.begin())) {
-        permute(a,idxa,tmpa_);
-        refa_ = &tmpa_;
-      }
+    std::vector<size_t> pmuta;
+    std::vector<size_t> pmutb;
+    make_contract_flags(a.extent(),idxa,b.extent(),idxb,pmuta,is_a_trans_,pmutb,is_b_trans_);
+
+    if(!pmuta.empty()) {
+      tmpa_.reset(scope_.allocate<value_type>(a.size()),make_permute(a.extent(),pmuta));
+      PermutePlan<value_type,TensorA::rank(),TensorA::layout()>::get(a.extent(),pmuta).execute(a.data(),tmpa_.data());
+      refa_ = &tmpa_;
+    }
+
+    if(!pmutb.empty()) {
+      tmpb_.reset(scope_.allocate<value_type>(b.size()),make_permute(b.extent(),pmutb));
+      PermutePlan<value_type,TensorB::rank(),TensorB::layout()>::get(b.extent(),pmutb).execute(b.data(),tmpb_.data());
+      refb_ = &tmpb_;
+    }
+  }
+
+};
+
+// ==================================================================================================== 
+
+/// flops equivalent to move one byte in memory, used by the cost model to compare permutation and GEMM
+#ifndef _BTAS_COST_FLOPS_PER_BYTE
+#define _BTAS_COST_FLOPS_PER_BYTE 16.0
+#endif
+
+/// GEMM dimension at which a half of the peak performance is achieved, used by the cost model
+#ifndef _BTAS_COST_GEMM_HALF_DIM
+#define _BTAS_COST_GEMM_HALF_DIM 16.0
+#endif
+
+namespace detail {
+
+/// estimated cost of GEMM in flops, small dimensions are penalized as 2*(m+h)*(n+h)*(k+h)
+inline double __gemm_cost (size_t m, size_t n, size_t k)
+{
+  const double h = _BTAS_COST_GEMM_HALF_DIM;
+  return 2.0*(m+h)*(n+h)*(k+h);
+}
+
+/// estimated cost of permutation in flops, x is read and y is written once
+inline double __permute_cost (size_t size, size_t elem)
+{
+  return _BTAS_COST_FLOPS_PER_BYTE*2.0*size*elem;
+}
+
+/// view of a row-major tensor as a strided batch of matrices
+/// indices labeled 0 and 1 are fused to two matrix blocks, those labeled 2 are fused to a batch index
+struct __matrix_view {
+
+  bool is_trans; ///< true if the block of label 1 is outer
+
+  size_t ext[2]; ///< fused extents of the blocks of label 0 and 1
+
+  size_t ld; ///< leading dimension
+
+  size_t stride; ///< stride of batch index (0 if not found)
+
+};
+
+/// make __matrix_view from extent and labels, indices of extent 1 are ignored
+/// \return false if the tensor cannot be viewed as a batch of matrices w/o permutation
+inline bool __make_matrix_view (const std::vector<size_t>& ext, const std::vector<size_t>& label, __matrix_view& mv)
+{
+  const size_t rank = ext.size();
+
+  std::vector<size_t> str(rank);
+  for(size_t i = rank, s = 1; i > 0; --i) { str[i-1] = s; s *= ext[i-1]; }
+
+  mv.is_trans = false;
+  mv.ext[0] = 1;
+  mv.ext[1] = 1;
+  mv.ld = 1;
+  mv.stride = 0;
+
+  // runs of the same label, each label must form a single run
+  size_t run_label[3];
+  size_t run_last [3];
+  size_t nrun = 0;
+  for(size_t i = 0; i < rank; ++i) {
+    if(ext[i] == 1) continue;
+    if(nrun == 0 || run_label[nrun-1] != label[i]) {
+      for(size_t j = 0; j < nrun; ++j) if(run_label[j] == label[i]) return false;
+      run_label[nrun] = label[i];
+      ++nrun;
+    }
+    run_last[nrun-1] = i;
+    if(label[i] < 2) mv.ext[label[i]] *= ext[i];
+  }
+
+  size_t outer = 3;
+  size_t inner = 3;
+  for(size_t j = 0; j < nrun; ++j) {
+    if(run_label[j] == 2)
+      mv.stride = str[run_last[j]];
+    else if(outer == 3)
+      outer = j;
+    else
+      inner = j;
+  }
+
+  if(inner != 3) {
+    // two blocks, the inner one must be contiguous
+    if(str[run_last[inner]] != 1) return false;
+    mv.is_trans = (run_label[outer] == 1);
+    mv.ld = str[run_last[outer]];
+  }
+  else if(outer != 3) {
+    // single block: (ext[0] x 1) matrix for label 0, (1 x ext[1]) matrix for label 1 if contiguous
+    const size_t l = run_label[outer];
+    if(l == 1 && str[run_last[outer]] == 1) {
+      mv.ld = mv.ext[1];
     }
     else {
-      // GEMV or GEMM cases:
-      size_t r = 0;
-      for(; r < K; ++r) if(idxa[r] != r+M-K) break;
-      if(r < K) {
-        size_t l = 0;
-        for(; l < K; ++l) if(idxa[l] != l) break;
-        if(l < K) {
-          typename TensorA::index_type pmuta;
-          size_t n = 0;
-          for(size_t i = 0; i < a.rank(); ++i)
-            if(idxa_set.find(i) == idxa_set.end())
-              pmuta[n++] = i;
-          for(size_t i = 0; i < idxa.size(); ++i)
-              pmuta[n++] = idxa[i];
-          permute(a,pmuta,tmpa_);
-          refa_ = &tmpa_;
-        }
-        else {
-          is_a_trans_ = !is_a_trans_;
-        }
-      }
+      mv.is_trans = (l == 1);
+      mv.ld = str[run_last[outer]];
     }
+  }
 
-    if(N == K) {
-      // GEMV case: gemv(NoTrans,A,B,C)
-      if(!std::equal(idxb.begin(),idxb.end(),idxb_set.begin())) {
-        permute(b,idxa,tmpb_);
-        refb_ = &tmpb_;
-      }
+  return true;
+}
+
+/// view of a row-major tensor as a batch of matrices, where batch indices are not necessarily fused
+struct __batch_view {
+
+  bool is_trans; ///< true if the block of label 1 is outer
+
+  size_t ext[2]; ///< fused extents of the blocks of label 0 and 1
+
+  size_t ld; ///< leading dimension
+
+  std::vector<size_t> hstr; ///< strides of batch indices
+
+};
+
+/// make __batch_view from extent and labels, indices of extent 1 are ignored in matrix blocks
+/// \param label 0 or 1 for matrix blocks, 2 for batch indices
+/// \param order position of each index in its block (or in batch indices), matrix blocks must be in this order
+/// \return false if the tensor cannot be viewed as a batch of matrices w/o permutation
+inline bool __make_batch_view (
+  const std::vector<size_t>& ext, const std::vector<size_t>& label, const std::vector<size_t>& order, size_t nbatch, __batch_view& bv)
+{
+  const size_t rank = ext.size();
+
+  std::vector<size_t> str(rank);
+  for(size_t i = rank, s = 1; i > 0; --i) { str[i-1] = s; s *= ext[i-1]; }
+
+  bv.is_trans = false;
+  bv.ext[0] = 1;
+  bv.ext[1] = 1;
+  bv.ld = 1;
+  bv.hstr.assign(nbatch,0);
+
+  // runs of the same label w/o batch indices, each label must form a single run of fused indices
+  size_t run_label[2];
+  size_t run_last [2];
+  size_t nrun = 0;
+  size_t prev = rank;
+  for(size_t i = 0; i < rank; ++i) {
+    if(label[i] == 2) { bv.hstr[order[i]] = str[i]; continue; }
+    if(ext[i] == 1) continue;
+    if(nrun == 0 || run_label[nrun-1] != label[i]) {
+      if(nrun == 2 || (nrun == 1 && run_label[0] == label[i])) return false;
+      run_label[nrun] = label[i];
+      ++nrun;
     }
     else {
-      // GEMVT or GEMM cases:
-      size_t l = 0;
-      for(; l < K; ++l) if(idxb[l] != l) break;
-      if(l < K) {
-        size_t r = 0;
-        for(; r < K; ++r) if(idxb[r] != r+N-K) break;
-        if(r < K) {
-          typename TensorB::index_type pmutb;
-          size_t n = 0;
-          for(size_t i = 0; i < idxb.size(); ++i)
-              pmutb[n++] = idxb[i];
-          for(size_t i = 0; i < b.rank(); ++i)
-            if(idxb_set.find(i) == idxb_set.end())
-              pmutb[n++] = i;
-          permute(b,pmutb,tmpb_);
-          refb_ = &tmpb_;
-        }
-        else {
-          is_b_trans_ = !is_b_trans_;
+      // fused with the previous index of the same block
+      if(str[prev] != str[i]*ext[i] || order[prev] > order[i]) return false;
+    }
+    run_last[nrun-1] = i;
+    prev = i;
+    bv.ext[label[i]] *= ext[i];
+  }
+
+  if(nrun == 2) {
+    // two blocks, the inner one must be contiguous
+    if(str[run_last[1]] != 1) return false;
+    bv.is_trans = (run_label[0] == 1);
+    bv.ld = str[run_last[0]];
+  }
+  else if(nrun == 1) {
+    // single block: (ext[0] x 1) matrix for label 0, (1 x ext[1]) matrix for label 1 if contiguous
+    const size_t l = run_label[0];
+    if(l == 1 && str[run_last[0]] == 1) {
+      bv.ld = bv.ext[1];
+    }
+    else {
+      bv.is_trans = (l == 1);
+      bv.ld = str[run_last[0]];
+    }
+  }
+
+  return true;
+}
+
+} // namespace detail
+
+/// helper class to carry out contraction as a strided batch of GEMMs w/o permutation
+/// e.g. a[i,k,j,l] * b[l,m] -> c[i,k,j,m] cannot be a single GEMM w/o permuting a,
+/// but it is a batch of GEMMs over (i,k), i.e. c[ik][j,m] = a[ik][j,l] * b[l,m].
+/// a contiguous group of free indices of either a or b is tested as a batch index,
+/// and the batched GEMM is enabled if it is cheaper than permutation + GEMM by the cost model.
+template<CBLAS_LAYOUT Layout>
+class contract_batch_helper {
+
+public:
+
+  /// default, batched GEMM is disabled
+  contract_batch_helper ()
+  : is_enabled_(false), cost_(0.0), cost_permute_(0.0)
+  { }
+
+  /// constructor
+  /// \param elem size of value type in bytes
+  template<class ExtentA, class ExtentB, class Index>
+  contract_batch_helper (const ExtentA& exta, const Index& idxa, const ExtentB& extb, const Index& idxb, size_t elem)
+  : is_enabled_(false), cost_(0.0), cost_permute_(0.0)
+  {
+    // NOTE: col-major is analyzed as row-major with reversed indices, which is c^T = b^T * a^T
+    if(Layout == CblasRowMajor)
+      this->analyze_(exta,idxa,extb,idxb,elem);
+    else
+      this->analyze_(extb,idxb,exta,idxa,elem);
+  }
+
+  /// return true if batched GEMM is chosen
+  bool enabled () const { return is_enabled_; }
+
+  /// return estimated cost of batched GEMM
+  double cost () const { return cost_; }
+
+  /// return estimated cost of permutation + GEMM
+  double cost_permute () const { return cost_permute_; }
+
+  /// carry out contraction, c = alpha * a * b + beta * c
+  template<typename T>
+  void call (const T& alpha, const T* pa, const T* pb, const T& beta, T* pc) const
+  {
+    BTAS_assert(is_enabled_,"contract_batch_helper::call, batched GEMM is not enabled.");
+    if(Layout == CblasColMajor) std::swap(pa,pb);
+    gemm_batch_strided(CblasRowMajor,transa_,transb_,m_,n_,k_,alpha,pa,lda_,stra_,pb,ldb_,strb_,beta,pc,ldc_,strc_,batch_);
+  }
+
+private:
+
+  /// analyze contraction in row-major order, i.e. indices of col-major tensors are reversed and a and b are swapped
+  template<class ExtentA, class ExtentB, class Index>
+  void analyze_ (const ExtentA& exta_, const Index& idxa_, const ExtentB& extb_, const Index& idxb_, size_t elem)
+  {
+    const size_t L = exta_.size();
+    const size_t M = extb_.size();
+    const size_t K = idxa_.size();
+
+    // extents and contraction pairs in row-major order
+    std::vector<size_t> exta(exta_.begin(),exta_.end());
+    std::vector<size_t> extb(extb_.begin(),extb_.end());
+    std::vector<size_t> pair(L,M); // pair[i] = contracted index of b, or M if free
+    for(size_t i = 0; i < K; ++i) pair[idxa_[i]] = idxb_[i];
+    std::vector<bool> freeb(M,true);
+    for(size_t i = 0; i < K; ++i) freeb[idxb_[i]] = false;
+
+    if(Layout == CblasColMajor) {
+      std::reverse(exta.begin(),exta.end());
+      std::reverse(extb.begin(),extb.end());
+      std::reverse(pair.begin(),pair.end());
+      std::reverse(freeb.begin(),freeb.end());
+      for(size_t i = 0; i < L; ++i) if(pair[i] < M) pair[i] = M-1-pair[i];
+    }
+
+    // extent of c: free indices of a followed by free indices of b
+    std::vector<size_t> extc;
+    for(size_t i = 0; i < L; ++i) if(pair[i] == M) extc.push_back(exta[i]);
+    for(size_t i = 0; i < M; ++i) if(freeb[i]) extc.push_back(extb[i]);
+
+    size_t sizea = 1; for(size_t i = 0; i < L; ++i) sizea *= exta[i];
+    size_t sizeb = 1; for(size_t i = 0; i < M; ++i) sizeb *= extb[i];
+    size_t sizek = 1; for(size_t i = 0; i < L; ++i) if(pair[i] < M) sizek *= exta[i];
+
+    // labels w/o batch index: (free,contracted) for a, (contracted,free) for b, (a,b) for c
+    std::vector<size_t> laba(L);
+    for(size_t i = 0; i < L; ++i) laba[i] = (pair[i] < M) ? 1 : 0;
+    std::vector<size_t> labb(M);
+    for(size_t i = 0; i < M; ++i) labb[i] = freeb[i] ? 1 : 0;
+    std::vector<size_t> labc(extc.size(),0);
+    for(size_t i = extc.size()-(M-K); i < extc.size(); ++i) labc[i] = 1;
+
+    // cost of permutation + GEMM
+    detail::__matrix_view mva;
+    detail::__matrix_view mvb;
+    const bool is_a_matrix = detail::__make_matrix_view(exta,laba,mva);
+    const bool is_b_matrix = detail::__make_matrix_view(extb,labb,mvb);
+    if(is_a_matrix && is_b_matrix && this->is_paired_(exta,laba,extb,labb,pair)) return;
+
+    cost_permute_ = detail::__gemm_cost(sizea/sizek,sizeb/sizek,sizek);
+    if(!is_a_matrix) cost_permute_ += detail::__permute_cost(sizea,elem);
+    if(!is_b_matrix) cost_permute_ += detail::__permute_cost(sizeb,elem);
+    if( is_a_matrix && is_b_matrix) cost_permute_ += detail::__permute_cost(std::min(sizea,sizeb),elem);
+
+    // test contiguous groups of free indices [first,last) of a or b as a batch index
+    for(size_t which = 0; which < 2; ++which) {
+      const size_t rank = (which == 0) ? L : M;
+      for(size_t first = 0; first < rank; ++first) {
+        for(size_t last = first+1; last <= rank; ++last) {
+          const size_t i = last-1;
+          if((which == 0) ? (pair[i] < M) : !freeb[i]) break;
+
+          std::vector<size_t> laba_(laba);
+          std::vector<size_t> labb_(labb);
+          std::vector<size_t> labc_(labc);
+          // position of the batch group in c
+          const size_t offset = (which == 0) ? 0 : L-K;
+          size_t ic = offset;
+          for(size_t j = 0; j < first; ++j) if((which == 0) ? (pair[j] == M) : freeb[j]) ++ic;
+          for(size_t j = first; j < last; ++j, ++ic) {
+            if(which == 0) laba_[j] = 2; else labb_[j] = 2;
+            labc_[ic] = 2;
+          }
+
+          detail::__matrix_view mva_;
+          detail::__matrix_view mvb_;
+          detail::__matrix_view mvc_;
+          if(!detail::__make_matrix_view(exta,laba_,mva_)) continue;
+          if(!detail::__make_matrix_view(extb,labb_,mvb_)) continue;
+          if(!detail::__make_matrix_view(extc,labc_,mvc_) || mvc_.is_trans) continue;
+          if(!this->is_paired_(exta,laba_,extb,labb_,pair)) continue;
+
+          const size_t batch = (sizea/mva_.ext[0]/mva_.ext[1])*(sizeb/mvb_.ext[0]/mvb_.ext[1]);
+          const double cost = batch*detail::__gemm_cost(mva_.ext[0],mvb_.ext[1],mva_.ext[1]);
+          if(cost >= cost_permute_ || (is_enabled_ && cost >= cost_)) continue;
+
+          is_enabled_ = true;
+          cost_ = cost;
+          transa_ = mva_.is_trans ? CblasTrans : CblasNoTrans;
+          transb_ = mvb_.is_trans ? CblasTrans : CblasNoTrans;
+          m_ = mva_.ext[0];
+          n_ = mvb_.ext[1];
+          k_ = mva_.ext[1];
+          lda_ = mva_.ld;
+          ldb_ = mvb_.ld;
+          ldc_ = mvc_.ld;
+          stra_ = mva_.stride;
+          strb_ = mvb_.stride;
+          strc_ = mvc_.stride;
+          batch_ = batch;
         }
       }
     }
   }
 
+  /// check contracted indices of a and b appear in the same order
+  bool is_paired_ (
+    const std::vector<size_t>& exta, const std::vector<size_t>& laba,
+    const std::vector<size_t>& extb, const std::vector<size_t>& labb, const std::vector<size_t>& pair) const
+  {
+    std::vector<size_t> ka;
+    for(size_t i = 0; i < exta.size(); ++i) if(laba[i] == 1 && exta[i] > 1) ka.push_back(pair[i]);
+    size_t t = 0;
+    for(size_t i = 0; i < extb.size(); ++i) {
+      if(labb[i] != 0 || extb[i] == 1) continue;
+      if(t == ka.size() || ka[t] != i) return false;
+      ++t;
+    }
+    return (t == ka.size());
+  }
+
+  //  Members
+
+  bool is_enabled_; ///< true if batched GEMM is chosen
+
+  double cost_; ///< estimated cost of batched GEMM
+
+  double cost_permute_; ///< estimated cost of permutation + GEMM
+
+  CBLAS_TRANSPOSE transa_;
+
+  CBLAS_TRANSPOSE transb_;
+
+  size_t m_, n_, k_; ///< GEMM dimensions for each batch
+
+  size_t lda_, ldb_, ldc_; ///< leading dimensions
+
+  size_t stra_, strb_, strc_; ///< strides of batch
+
+  size_t batch_; ///< number of batches
+
 };
 
+// ==================================================================================================== 
+
 /// function to calculate contraction indices from tensor subscrit symbols
 template<class SymbolA, class SymbolB, class Index, class SymbolAxB>
 void parse_contract_symbols (const SymbolA& symba, const SymbolB& symbb, Index& idxa, Index& idxb, SymbolAxB& symbaxb)
@@ -129,12 +711,12 @@ void parse_contract_symbols (const SymbolA& symba, const SymbolB& symbb, Index&
   std::map<typename SymbolA::value_type,size_t> symba_map;
   for(size_t i = 0; i < symba.size(); ++i)
     symba_map.insert(std::make_pair(symba[i],i));
-  assert(symba_map.size() != symba.size()); // FAILs when duplicate symbols are found.
+  assert(symba_map.size() == symba.size()); // FAILs when duplicate symbols are found.
 
   std::map<typename SymbolB::value_type,size_t> symbb_map;
   for(size_t i = 0; i < symbb.size(); ++i)
     symbb_map.insert(std::make_pair(symbb[i],i));
-  assert(symbb_map.size() != symbb.size()); // FAILs when duplicate symbols are found.
+  assert(symbb_map.size() == symbb.size()); // FAILs when duplicate symbols are found.
 
   std::vector<size_t> idxa_tmp;
   std::vector<size_t> idxb_tmp;
@@ -0,0 +1,176 @@
+#ifndef __BTAS_GESVD_RANDOMIZED_HPP
+#define __BTAS_GESVD_RANDOMIZED_HPP
+
+#include <algorithm> // std::min
+#include <numeric> // std::accumulate
+#include <random>
+#include <complex>
+
+#include <BTAS_assert.h>
+#include <remove_complex.h>
+#include <Tensor.hpp>
+#include <TensorBlas.hpp>
+#include <TensorLapack.hpp>
+#include <Workspace.hpp>
+
+namespace btas {
+
+namespace detail {
+
+/// fill x by random numbers of the standard normal distribution
+template<typename T, class Generator>
+void __gaussian (size_t n, T* x, Generator& gen)
+{
+  std::normal_distribution<T> dist;
+  for(size_t i = 0; i < n; ++i) x[i] = dist(gen);
+}
+
+/// fill x by random numbers of the standard normal distribution, for both real and imaginary parts
+template<typename T, class Generator>
+void __gaussian (size_t n, std::complex<T>* x, Generator& gen)
+{
+  std::normal_distribution<T> dist;
+  for(size_t i = 0; i < n; ++i) { T re = dist(gen); T im = dist(gen); x[i] = std::complex<T>(re,im); }
+}
+
+/// orthonormalize columns of m x l matrix y (m >= l) in place, by QR decomposition
+template<typename T, CBLAS_LAYOUT Layout>
+void __orthonormalize_columns (size_t m, size_t l, T* y)
+{
+  size_t ldy = (Layout == CblasRowMajor) ? l : m;
+  Workspace::Scope scope;
+  T* tau = scope.allocate<T>(l);
+  geqrf(Layout,m,l,y,ldy,tau);
+  orgqr(Layout,m,l,l,y,ldy,tau);
+}
+
+/// orthonormalize rows of l x n matrix x (l <= n) in place, by LQ decomposition
+template<typename T, CBLAS_LAYOUT Layout>
+void __orthonormalize_rows (size_t l, size_t n, T* x)
+{
+  size_t ldx = (Layout == CblasRowMajor) ? n : l;
+  Workspace::Scope scope;
+  T* tau = scope.allocate<T>(l);
+  gelqf(Layout,l,n,x,ldx,tau);
+  orglq(Layout,l,n,l,x,ldx,tau);
+}
+
+} // namespace detail
+
+/// Solve truncated SVD by randomized range finder (Halko, Martinsson and Tropp, SIAM Rev. 53, 217 (2011)) : a ~ u * diag(s) * vt
+/// a is given only by its actions (matrix-free), e.g. a two-site wavefunction which is not formed explicitly
+/// \param mult_a callable as mult_a(x,y), computes y({i,j},r) = a({i,j},{k,l}) * conj(x(r,{k,l})), i.e. y = a * x^H
+/// \param mult_ah callable as mult_ah(y,x), computes x(r,{k,l}) = conj(y({i,j},r)) * a({i,j},{k,l}), i.e. x = y^H * a
+/// \param aExt extent of a
+/// \param rank number of singular values to be computed
+/// \param oversampling number of extra samples of the range of a, which improves accuracy
+/// \param power_iterations number of power iterations, which improves accuracy if singular values decay slowly
+/// \param seed seed of the random test matrix
+/// NOTE: x and y are passed as Tensor<T,N,Layout> and Tensor<T,M,Layout>, which are empty upon the first call and have the right extent afterwards,
+///       so that both of mult_a and mult_ah can be implemented by contract, e.g. contract(1.0,a,{k,l},x,{k,l},0.0,y) for real a
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class MultA, class MultAH, class AllocS, class AllocU, class AllocVT>
+void gesvd_randomized (
+        MultA mult_a,
+        MultAH mult_ah,
+  const typename Tensor<T,M+N-2,Layout>::extent_type& aExt,
+        Tensor<typename remove_complex<T>::type,1,Layout,AllocS>& s,
+        Tensor<T,M,Layout,AllocU>& u,
+        Tensor<T,N,Layout,AllocVT>& vt,
+  const size_t& rank,
+  const size_t& oversampling = 10,
+  const size_t& power_iterations = 2,
+  const unsigned long& seed = 5489ul)
+{
+  size_t aRows = std::accumulate(aExt.begin(),aExt.begin()+M-1,1ul,std::multiplies<size_t>());
+  size_t aCols = std::accumulate(aExt.begin()+M-1,aExt.end(),  1ul,std::multiplies<size_t>());
+
+  BTAS_assert(rank > 0,"gesvd_randomized, rank must be positive.");
+
+  // number of samples, which cannot exceed the dimension of a
+  size_t l = std::min(rank+oversampling,std::min(aRows,aCols));
+
+  typename Tensor<T,N,Layout>::extent_type xExtent;
+  xExtent[0] = l;
+  for(size_t i = 1; i < N; ++i) xExtent[i] = aExt[i+M-2];
+
+  // random test matrix
+  Tensor<T,N,Layout> x;
+  x.resize_uninitialized(xExtent);
+  std::mt19937 gen(seed);
+  detail::__gaussian(x.size(),x.data(),gen);
+
+  // range finder : y = orth(a * x^H)
+  Tensor<T,M,Layout> y;
+  mult_a(static_cast<const Tensor<T,N,Layout>&>(x),y);
+  BTAS_assert(y.size() == aRows*l,"gesvd_randomized, mult_a gave inconsistent size of y.");
+  detail::__orthonormalize_columns<T,Layout>(aRows,l,y.data());
+
+  // power iterations : x = orth(y^H * a), y = orth(a * x^H)
+  for(size_t iter = 0; iter < power_iterations; ++iter) {
+    mult_ah(static_cast<const Tensor<T,M,Layout>&>(y),x);
+    BTAS_assert(x.size() == l*aCols,"gesvd_randomized, mult_ah gave inconsistent size of x.");
+    detail::__orthonormalize_rows<T,Layout>(l,aCols,x.data());
+    mult_a(static_cast<const Tensor<T,N,Layout>&>(x),y);
+    BTAS_assert(y.size() == aRows*l,"gesvd_randomized, mult_a gave inconsistent size of y.");
+    detail::__orthonormalize_columns<T,Layout>(aRows,l,y.data());
+  }
+
+  // projection of a onto the range, x = y^H * a, which is decomposed by small SVD : x = ux * diag(s) * vt
+  mult_ah(static_cast<const Tensor<T,M,Layout>&>(y),x);
+  BTAS_assert(x.size() == l*aCols,"gesvd_randomized, mult_ah gave inconsistent size of x.");
+
+  Tensor<T,2,Layout> ux;
+  gesvd_truncated(x,s,ux,vt,SVDTruncation{std::min(rank,l),0.0,0.0,false});
+
+  // u = y * ux
+  typename Tensor<T,M,Layout>::extent_type uExtent;
+  for(size_t i = 0; i < M-1; ++i) uExtent[i] = aExt[i];
+  uExtent[M-1] = ux.extent(1);
+
+  u.resize_uninitialized(uExtent);
+  gemm(CblasNoTrans,CblasNoTrans,static_cast<T>(1),y,ux,static_cast<T>(0),u);
+}
+
+/// Solve truncated SVD by randomized range finder : a ~ u * diag(s) * vt
+/// this is much faster than gesvd if rank is far below the dimension of a, and singular values decay fast enough
+/// \param rank number of singular values to be computed
+/// \param oversampling number of extra samples of the range of a, which improves accuracy
+/// \param power_iterations number of power iterations, which improves accuracy if singular values decay slowly
+/// \param seed seed of the random test matrix
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class AllocS, class AllocU, class AllocVT>
+void gesvd_randomized (
+  const TensorBase<T,M+N-2,Layout>& a,
+        Tensor<typename remove_complex<T>::type,1,Layout,AllocS>& s,
+        Tensor<T,M,Layout,AllocU>& u,
+        Tensor<T,N,Layout,AllocVT>& vt,
+  const size_t& rank,
+  const size_t& oversampling = 10,
+  const size_t& power_iterations = 2,
+  const unsigned long& seed = 5489ul)
+{
+  // y = a * x^H
+  auto mult_a = [&a] (const Tensor<T,N,Layout>& x, Tensor<T,M,Layout>& y)
+  {
+    typename Tensor<T,M,Layout>::extent_type yExtent;
+    for(size_t i = 0; i < M-1; ++i) yExtent[i] = a.extent(i);
+    yExtent[M-1] = x.extent(0);
+    y.resize_uninitialized(yExtent);
+    gemm(CblasNoTrans,CblasConjTrans,static_cast<T>(1),a,x,static_cast<T>(0),y);
+  };
+
+  // x = y^H * a
+  auto mult_ah = [&a] (const Tensor<T,M,Layout>& y, Tensor<T,N,Layout>& x)
+  {
+    typename Tensor<T,N,Layout>::extent_type xExtent;
+    xExtent[0] = y.extent(M-1);
+    for(size_t i = 1; i < N; ++i) xExtent[i] = a.extent(i+M-2);
+    x.resize_uninitialized(xExtent);
+    gemm(CblasConjTrans,CblasNoTrans,static_cast<T>(1),y,a,static_cast<T>(0),x);
+  };
+
+  gesvd_randomized(mult_a,mult_ah,a.extent(),s,u,vt,rank,oversampling,power_iterations,seed);
+}
+
+} // namespace btas
+
+#endif // __BTAS_GESVD_RANDOMIZED_HPP
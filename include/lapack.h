@@ -1,9 +1,10 @@
 #ifndef __BTAS_LAPACK_HEADER_INCLUDED
 #define __BTAS_LAPACK_HEADER_INCLUDED
 
-#include <mkl.h>
+#include <backend.h>
 
 #include <lapack/gesvd_impl.h>
+#include <lapack/gesdd_impl.h>
 #include <lapack/geqrf_impl.h>
 #include <lapack/orgqr_impl.h>
 #include <lapack/gelqf_impl.h>
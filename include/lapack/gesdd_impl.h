@@ -0,0 +1,93 @@
+#ifndef __BTAS_LAPACK_GESDD_IMPL_H
+#define __BTAS_LAPACK_GESDD_IMPL_H
+
+#include <BTAS_assert.h>
+
+namespace btas {
+
+/// SVD by divide and conquer, which returns info of LAPACK (info > 0 : failed to converge)
+template<typename T>
+lapack_int gesdd (
+  const int& order,
+  const char& jobz,
+  const size_t& M,
+  const size_t& N,
+        T* A,
+  const size_t& ldA,
+        T* S,
+        T* U,
+  const size_t& ldU,
+        T* VT,
+  const size_t& ldVT)
+{
+  BTAS_assert(false, "gesdd is not implemented.");
+  return -1;
+}
+
+inline lapack_int gesdd (
+  const int& order,
+  const char& jobz,
+  const size_t& M,
+  const size_t& N,
+        float* A,
+  const size_t& ldA,
+        float* S,
+        float* U,
+  const size_t& ldU,
+        float* VT,
+  const size_t& ldVT)
+{
+  return LAPACKE_sgesdd(order, jobz, M, N, A, ldA, S, U, ldU, VT, ldVT);
+}
+
+inline lapack_int gesdd (
+  const int& order,
+  const char& jobz,
+  const size_t& M,
+  const size_t& N,
+        double* A,
+  const size_t& ldA,
+        double* S,
+        double* U,
+  const size_t& ldU,
+        double* VT,
+  const size_t& ldVT)
+{
+  return LAPACKE_dgesdd(order, jobz, M, N, A, ldA, S, U, ldU, VT, ldVT);
+}
+
+inline lapack_int gesdd (
+  const int& order,
+  const char& jobz,
+  const size_t& M,
+  const size_t& N,
+        std::complex<float>* A,
+  const size_t& ldA,
+        float* S,
+        std::complex<float>* U,
+  const size_t& ldU,
+        std::complex<float>* VT,
+  const size_t& ldVT)
+{
+  return LAPACKE_cgesdd(order, jobz, M, N, A, ldA, S, U, ldU, VT, ldVT);
+}
+
+inline lapack_int gesdd (
+  const int& order,
+  const char& jobz,
+  const size_t& M,
+  const size_t& N,
+        std::complex<double>* A,
+  const size_t& ldA,
+        double* S,
+        std::complex<double>* U,
+  const size_t& ldU,
+        std::complex<double>* VT,
+  const size_t& ldVT)
+{
+  return LAPACKE_zgesdd(order, jobz, M, N, A, ldA, S, U, ldU, VT, ldVT);
+}
+
+} // namespace btas
+
+#endif // __BTAS_LAPACK_GESDD_IMPL_H
@@ -2,6 +2,7 @@
 #define __BTAS_LAPACK_GESVD_IMPL_H
 
 #include <BTAS_assert.h>
+#include <Workspace.hpp>
 
 namespace btas {
 
@@ -38,9 +39,9 @@ inline void gesvd (
   const size_t& ldVT)
 {
   size_t K = (M < N) ? M : N;
-  float* superb = new float [K - 1];
+  Workspace::Scope scope;
+  float* superb = scope.allocate<float>(K);
   LAPACKE_sgesvd(order, jobu, jobvt, M, N, A, ldA, S, U, ldU, VT, ldVT, superb);
-  delete [] superb;
 }
 
 inline void gesvd (
@@ -58,9 +59,9 @@ inline void gesvd (
   const size_t& ldVT)
 {
   size_t K = (M < N) ? M : N;
-  double *superb = new double [K - 1];
+  Workspace::Scope scope;
+  double* superb = scope.allocate<double>(K);
   LAPACKE_dgesvd(order, jobu, jobvt, M, N, A, ldA, S, U, ldU, VT, ldVT, superb);
-  delete [] superb;
 }
 
 inline void gesvd (
@@ -78,9 +79,9 @@ inline void gesvd (
   const size_t& ldVT)
 {
   size_t K = (M < N) ? M : N;
-  float* superb = new float [K - 1];
+  Workspace::Scope scope;
+  float* superb = scope.allocate<float>(K);
   LAPACKE_cgesvd(order, jobu, jobvt, M, N, A, ldA, S, U, ldU, VT, ldVT, superb);
-  delete [] superb;
 }
 
 inline void gesvd (
@@ -98,9 +99,9 @@ inline void gesvd (
   const size_t& ldVT)
 {
   size_t K = (M < N) ? M : N;
-  double *superb = new double [K - 1];
+  Workspace::Scope scope;
+  double* superb = scope.allocate<double>(K);
   LAPACKE_zgesvd(order, jobu, jobvt, M, N, A, ldA, S, U, ldU, VT, ldVT, superb);
-  delete [] superb;
 }
 
 } // namespace btas
@@ -0,0 +1,43 @@
+#ifndef __BTAS_PARALLEL_H
+#define __BTAS_PARALLEL_H
+
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace btas {
+
+namespace detail {
+
+/// max. number of threads to be used in a parallel region (1 if OpenMP is disabled)
+inline size_t __max_threads ()
+{
+#ifdef _OPENMP
+  return (omp_in_parallel() ? 1ul : static_cast<size_t>(omp_get_max_threads()));
+#else
+  return 1ul;
+#endif
+}
+
+/// static partition of [0,n) for the calling thread, must be called inside a parallel region
+/// NOTE: the partition is contiguous and deterministic, so that the same thread always touches the same range
+inline void __thread_range (size_t n, size_t& first, size_t& last)
+{
+#ifdef _OPENMP
+  const size_t nt = static_cast<size_t>(omp_get_num_threads());
+  const size_t it = static_cast<size_t>(omp_get_thread_num());
+#else
+  const size_t nt = 1ul;
+  const size_t it = 0ul;
+#endif
+  first = n*it/nt;
+  last  = n*(it+1)/nt;
+}
+
+} // namespace detail
+
+} // namespace btas
+
+#endif // __BTAS_PARALLEL_H
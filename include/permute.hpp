@@ -3,10 +3,18 @@
 
 #include <array>
 #include <vector>
+#include <algorithm> // std::equal
+#include <utility> // std::move
+#include <type_traits> // std::enable_if, std::is_same
 
 #include <Tensor.hpp>
 #include <TensorView.hpp>
-#include <reindex.hpp>
+#include <PermutePlan.hpp>
+
+/// min. size of tensor in bytes to permute self in place (see permute_inplace)
+#ifndef _BTAS_PERMUTE_INPLACE_THRESHOLD
+#define _BTAS_PERMUTE_INPLACE_THRESHOLD 8589934592ul
+#endif
 
 namespace btas {
 
@@ -63,12 +71,14 @@ std::vector<T> make_permute (const std::vector<T>& a_, const std::vector<size_t>
 // ---------------------------------------------------------------------------------------------------- 
 
 /// Specialized for TensorBase (Tensor<T,N>, TensorWrapper<T*,N>, and TensorWrapper<const T*,N>)
-template<typename T, size_t N, CBLAS_LAYOUT Layout, class Index>
+template<typename T, size_t N, CBLAS_LAYOUT Layout, class Index, class = typename std::enable_if<
+  !std::is_same<Index,typename TensorBase<T,N,Layout>::index_type>::value>::type>
 Tensor<typename std::remove_const<T>::type,N,Layout> make_permute (const TensorBase<T,N,Layout>& x, const Index& idx)
 {
   typedef typename std::remove_const<T>::type value_t;
-  Tensor<value_t,N,Layout> y(make_permute(x.extent(),idx));
-  reindex<value_t,N,Layout>(x.data(),y.data(),make_permute(x.stride(),idx),y.extent());
+  Tensor<value_t,N,Layout> y;
+  y.resize_uninitialized(make_permute(x.extent(),idx));
+  PermutePlan<value_t,N,Layout>::get(x.extent(),idx).execute(x.data(),y.data());
   return y;
 }
 
@@ -77,15 +87,17 @@ template<typename T, size_t N, CBLAS_LAYOUT Layout>
 Tensor<typename std::remove_const<T>::type,N,Layout> make_permute (const TensorBase<T,N,Layout>& x, const typename TensorBase<T,N,Layout>::index_type& idx)
 {
   typedef typename std::remove_const<T>::type value_t;
-  Tensor<value_t,N,Layout> y(make_permute(x.extent(),idx));
-  reindex<value_t,N,Layout>(x.data(),y.data(),make_permute(x.stride(),idx),y.extent());
+  Tensor<value_t,N,Layout> y;
+  y.resize_uninitialized(make_permute(x.extent(),idx));
+  PermutePlan<value_t,N,Layout>::get(x.extent(),idx).execute(x.data(),y.data());
   return y;
 }
 
 // ---------------------------------------------------------------------------------------------------- 
 
 /// Specialized for TensorView
-template<class Iter, size_t N, CBLAS_LAYOUT Layout, class Index>
+template<class Iter, size_t N, CBLAS_LAYOUT Layout, class Index, class = typename std::enable_if<
+  !std::is_same<Index,typename TensorView<Iter,N,Layout>::index_type>::value>::type>
 TensorView<typename TensorView<Iter,N,Layout>::const_iterator,N,Layout> make_permute (const TensorView<Iter,N,Layout>& x, const Index& idx)
 {
   return TensorView<typename TensorView<Iter,N,Layout>::const_iterator,N,Layout>(x.begin(),make_permute(x.extent(),idx),make_permute(x.stride(),idx));
@@ -100,24 +112,114 @@ TensorView<typename TensorView<Iter,N,Layout>::const_iterator,N,Layout> make_per
 
 // ---------------------------------------------------------------------------------------------------- 
 
+/// permute self in place, w/o full-size temporary (only for resizable object; Tensor<T,N>)
+/// this is slower than permute(x,idx), but the extra memory is only a bitmap of x.size() bits
+template<typename T, size_t N, CBLAS_LAYOUT Layout, class Index, class AllocX>
+void permute_inplace (Tensor<T,N,Layout,AllocX>& x, const Index& idx)
+{
+  PermutePlan<T,N,Layout>::get(x.extent(),idx).execute_inplace(x.data());
+  // NOTE: resize to the same size never reallocates
+  x.resize(make_permute(x.extent(),idx));
+}
+
 /// permute self (only for resizable object; Tensor<T,N>)
-template<typename T, size_t N, CBLAS_LAYOUT Layout, class Index>
-void permute (Tensor<T,N,Layout>& x, const Index& idx)
+/// if x is larger than _BTAS_PERMUTE_INPLACE_THRESHOLD bytes, permute_inplace is called instead
+template<typename T, size_t N, CBLAS_LAYOUT Layout, class Index, class AllocX, class = typename std::enable_if<
+  !std::is_same<Index,typename Tensor<T,N,Layout>::index_type>::value>::type>
+void permute (Tensor<T,N,Layout,AllocX>& x, const Index& idx)
 {
-  Tensor<T,N,Layout> y(make_permute(x.extent(),idx));
-  reindex<T,N,Layout>(x.data(),y.data(),make_permute(x.stride(),idx),y.extent());
+  if(x.size()*sizeof(T) >= _BTAS_PERMUTE_INPLACE_THRESHOLD) {
+    permute_inplace(x,idx);
+    return;
+  }
+  Tensor<T,N,Layout,AllocX> y;
+  y.resize_uninitialized(make_permute(x.extent(),idx));
+  PermutePlan<T,N,Layout>::get(x.extent(),idx).execute(x.data(),y.data());
   x.swap(y);
 }
 
 /// permute self (only for resizable object; Tensor<T,N>)
-template<typename T, size_t N, CBLAS_LAYOUT Layout>
-void permute (Tensor<T,N,Layout>& x, const typename Tensor<T,N,Layout>::index_type& idx)
+/// if x is larger than _BTAS_PERMUTE_INPLACE_THRESHOLD bytes, permute_inplace is called instead
+template<typename T, size_t N, CBLAS_LAYOUT Layout, class AllocX>
+void permute (Tensor<T,N,Layout,AllocX>& x, const typename Tensor<T,N,Layout>::index_type& idx)
 {
-  Tensor<T,N,Layout> y(make_permute(x.extent(),idx));
-  reindex<T,N,Layout>(x.data(),y.data(),make_permute(x.stride(),idx),y.extent());
+  if(x.size()*sizeof(T) >= _BTAS_PERMUTE_INPLACE_THRESHOLD) {
+    permute_inplace(x,idx);
+    return;
+  }
+  Tensor<T,N,Layout,AllocX> y;
+  y.resize_uninitialized(make_permute(x.extent(),idx));
+  PermutePlan<T,N,Layout>::get(x.extent(),idx).execute(x.data(),y.data());
   x.swap(y);
 }
 
+/// permute x into y (only for resizable object; Tensor<T,N>)
+template<typename T, size_t N, CBLAS_LAYOUT Layout, class Index, class AllocY>
+void permute (const TensorBase<T,N,Layout>& x, const Index& idx, Tensor<typename std::remove_const<T>::type,N,Layout,AllocY>& y)
+{
+  typedef typename std::remove_const<T>::type value_t;
+  y.resize_uninitialized(make_permute(x.extent(),idx));
+  PermutePlan<value_t,N,Layout>::get(x.extent(),idx).execute(x.data(),y.data());
+}
+
+/// permute x into y, where x is consumed and becomes empty (only for resizable object; Tensor<T,N>)
+/// if x is larger than _BTAS_PERMUTE_INPLACE_THRESHOLD bytes, x is permuted in place and its data are moved to y,
+/// otherwise x is permuted into y (w/o reallocation if y is large enough) and then deallocated
+template<typename T, size_t N, CBLAS_LAYOUT Layout, class Index, class AllocX>
+void permute (Tensor<T,N,Layout,AllocX>&& x, const Index& idx, Tensor<T,N,Layout,AllocX>& y)
+{
+  if(x.size()*sizeof(T) >= _BTAS_PERMUTE_INPLACE_THRESHOLD) {
+    permute_inplace(x,idx);
+    y = std::move(x);
+    return;
+  }
+  y.resize_uninitialized(make_permute(x.extent(),idx));
+  PermutePlan<T,N,Layout>::get(x.extent(),idx).execute(x.data(),y.data());
+  x = Tensor<T,N,Layout,AllocX>();
+}
+
+// ---------------------------------------------------------------------------------------------------- 
+
+/// make permutation index from index symbols, s.t. y's i-th symbol is x's idx[i]-th symbol
+template<class SymbolX, class SymbolY, class Index>
+void make_permute_index (const SymbolX& symbx, const SymbolY& symby, Index& idx)
+{
+  BTAS_assert(symbx.size() == symby.size() && symby.size() == idx.size(),"make_permute_index, detected inconsistent size of argument.");
+  for(size_t i = 0; i < symby.size(); ++i) {
+    size_t j = 0;
+    for(; j < symbx.size(); ++j) if(symbx[j] == symby[i]) break;
+    BTAS_assert(j < symbx.size(),"make_permute_index, symbol is not found.");
+    idx[i] = j;
+  }
+}
+
+// ---------------------------------------------------------------------------------------------------- 
+
+/// scaled-accumulate permutation, y = alpha * P(x) + beta * y, where P(x) is permute of x by idx
+/// this is carried out in a single pass by the same kernels as permute, w/o temporary of P(x)
+/// NOTE: y is not read if beta == 0
+template<typename T, typename U, size_t N, CBLAS_LAYOUT Layout, class Index, class = typename std::enable_if<
+  std::is_same<typename std::remove_const<U>::type,T>::value>::type>
+void permute_axpby (const T& alpha, const TensorBase<U,N,Layout>& x, const Index& idx, const T& beta, TensorBase<T,N,Layout>& y)
+{
+  const auto ext_y = make_permute(x.extent(),idx);
+  BTAS_assert(std::equal(ext_y.begin(),ext_y.end(),y.extent().begin()),"permute_axpby, detected inconsistent extents (x vs y).");
+  PermutePlan<T,N,Layout>::get(x.extent(),idx).execute(alpha,x.data(),beta,y.data());
+}
+
+/// scaled-accumulate permutation for TensorView, y = alpha * P(x) + beta * y
+/// x can be a non-contiguous view (e.g. slice), which is read through its stride(hack)
+template<typename T, typename U, size_t N, CBLAS_LAYOUT Layout, class Index, class = typename std::enable_if<
+  std::is_same<typename std::remove_const<U>::type,T>::value>::type>
+void permute_axpby (const T& alpha, const TensorView<U*,N,Layout>& x, const Index& idx, const T& beta, TensorBase<T,N,Layout>& y)
+{
+  const auto ext_y = make_permute(x.extent(),idx);
+  BTAS_assert(std::equal(ext_y.begin(),ext_y.end(),y.extent().begin()),"permute_axpby, detected inconsistent extents (x vs y).");
+  if(x.empty()) return;
+  const auto first = x.begin();
+  PermutePlan<T,N,Layout>(x.extent(),first.stride_hack(),idx).execute(alpha,first.base(),beta,y.data());
+}
+
 } // namespace btas
 
 #endif // __BTAS_PERMUTE_HPP
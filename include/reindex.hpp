@@ -1,6 +1,22 @@
 #ifndef __BTAS_REINDEX_HPP
 #define __BTAS_REINDEX_HPP
 
+#include <vector>
+#include <algorithm> // std::min, std::max, std::swap, std::reverse, std::fill, std::copy, std::sort
+
+#include <parallel.h>
+#include <transpose_kernel.hpp>
+
+/// L1 data cache size in bytes, used to determine the tile size of blocked reindex
+#ifndef _BTAS_L1_CACHE_SIZE
+#define _BTAS_L1_CACHE_SIZE 32768ul
+#endif
+
+/// min. number of elements to split reindex over threads
+#ifndef _BTAS_PERMUTE_PARALLEL_THRESHOLD
+#define _BTAS_PERMUTE_PARALLEL_THRESHOLD 65536ul
+#endif
+
 namespace btas {
 
 /// Generic ND loop to carry out tensor reindex
@@ -92,11 +108,11 @@ private:
   static void __loop_impl (const size_t& i, const size_t& m, const T*& px_, T*& py_, size_t addr_x, const Ext_& str_x, const Ext_& ext_y)
   {
     if(i == m) {
-      for(size_t i = 0; i < ext_y[m]; ++i, ++py_) *py_ = px_[addr_x+i*str_x[m]];
+      for(size_t j = 0; j < ext_y[m]; ++j, ++py_) *py_ = px_[addr_x+j*str_x[m]];
     }
     else {
-      for(size_t i = 0; i < ext_y[i]; ++i)
-        Nd_loop_reindex<0ul,CblasRowMajor>::__loop_impl(i+1,m,px_,py_,addr_x+i*str_x[i],str_x,ext_y);
+      for(size_t j = 0; j < ext_y[i]; ++j)
+        Nd_loop_reindex<0ul,CblasRowMajor>::__loop_impl(i+1,m,px_,py_,addr_x+j*str_x[i],str_x,ext_y);
     }
   }
 };
@@ -119,24 +135,339 @@ private:
   static void __loop_impl (const size_t& i, const size_t& m, const T*& px_, T*& py_, size_t addr_x, const Ext_& str_x, const Ext_& ext_y)
   {
     if(i == 0) {
-      for(size_t i = 0; i < ext_y[0]; ++i, ++py_) *py_ = px_[addr_x+i*str_x[0]];
+      for(size_t j = 0; j < ext_y[0]; ++j, ++py_) *py_ = px_[addr_x+j*str_x[0]];
     }
     else {
-      for(size_t i = 0; i < ext_y[i]; ++i)
-        Nd_loop_reindex<0ul,CblasColMajor>::__loop_impl(i-1,m,px_,py_,addr_x+i*str_x[i],str_x,ext_y);
+      for(size_t j = 0; j < ext_y[i]; ++j)
+        Nd_loop_reindex<0ul,CblasColMajor>::__loop_impl(i-1,m,px_,py_,addr_x+j*str_x[i],str_x,ext_y);
     }
   }
 };
 
 // ---------------------------------------------------------------------------------------------------- 
 
+namespace detail {
+
+/// loop index for reindex kernels, stored in place for rank <= 16 so that no heap allocation occurs
+class __loop_index {
+
+public:
+
+  explicit __loop_index (size_t rank) : p_(buf_)
+  {
+    if(rank > 16) { heap_.resize(rank); p_ = heap_.data(); }
+    std::fill(p_,p_+rank,0ul);
+  }
+
+  __loop_index (const __loop_index&) = delete;
+
+  size_t& operator[] (size_t i) { return p_[i]; }
+
+private:
+
+  size_t buf_[16];
+
+  std::vector<size_t> heap_;
+
+  size_t* p_;
+
+};
+
+/// tile size for blocked reindex
+/// the largest power of 2 (>= 4) s.t. tiles of x and y (b x b each) fit in a half of L1 cache
+constexpr size_t __reindex_block_size (size_t elem, size_t b = 256ul)
+{
+  return (b <= 4ul || 2ul*b*b*elem <= _BTAS_L1_CACHE_SIZE/2) ? b : __reindex_block_size(elem,b/2);
+}
+
+/// blocked reindex, used when the fastest index of y is not the fastest index of x
+/// NOTE: all arrays are given in row-major order (i.e. the last index runs fastest in y),
+///       p is the index which runs fastest in x, i.e. str_x[p] == 1.
+/// two fast indices, p and the last, are tiled so that both x and y are accessed within L1 cache,
+/// the other (outer) indices are looped as a flat odometer.
+/// each tile is transposed by SIMD micro-kernels if available (see transpose_kernel.hpp).
+/// work items (outer index x row-blocks of p) are statically distributed over threads.
+/// op is an element-wise operation to store x into y, e.g. __axpby_op for y = alpha*x + beta*y,
+/// SIMD micro-kernels are used only for plain copy (__assign_op).
+template<typename T, class Ext_, class Op_ = __assign_op>
+void __reindex_tiled (const T* px_, T* py_, const Ext_& ext, const Ext_& str_x, const Ext_& str_y, size_t p, const Op_& op = Op_())
+{
+  const size_t rank = ext.size();
+  const size_t q = rank-1;
+  const size_t bs = __reindex_block_size(sizeof(T));
+
+  size_t nouter = 1;
+  for(size_t i = 0; i < q; ++i) if(i != p) nouter *= ext[i];
+
+  const size_t npb = (ext[p]+bs-1)/bs;
+  const size_t nitems = nouter*npb;
+
+  const size_t sxp = str_x[p]; const size_t syp = str_y[p];
+  const size_t sxq = str_x[q];
+
+  const bool is_parallel = (nitems > 1 && nouter*ext[p]*ext[q] >= _BTAS_PERMUTE_PARALLEL_THRESHOLD && __max_threads() > 1);
+
+#ifdef _OPENMP
+#pragma omp parallel if(is_parallel)
+#endif
+  {
+    size_t first = 0;
+    size_t last  = nitems;
+    if(is_parallel) __thread_range(nitems,first,last);
+
+    if(first < last) {
+      // decode the first item to outer index and offsets
+      __loop_index idx(rank);
+      size_t addr_x = 0;
+      size_t addr_y = 0;
+      size_t ipb = first%npb;
+      size_t ord = first/npb;
+      for(size_t i = q; i-- > 0;) {
+        if(i == p) continue;
+        idx[i] = ord%ext[i]; ord /= ext[i];
+        addr_x += idx[i]*str_x[i];
+        addr_y += idx[i]*str_y[i];
+      }
+
+      for(size_t item = first; item < last; ++item) {
+        const size_t pb = ipb*bs;
+        const size_t pe = std::min(pb+bs,ext[p]);
+        for(size_t qb = 0; qb < ext[q]; qb += bs) {
+          const size_t qe = std::min(qb+bs,ext[q]);
+          // tile: y is written contiguously, x is read with stride sxq
+          __transpose_tile(px_+addr_x+pb*sxp+qb*sxq,sxq,py_+addr_y+pb*syp+qb,syp,pe-pb,qe-qb,op);
+        }
+        if(++ipb < npb) continue;
+        ipb = 0;
+        // increment outer index, skipping p and q
+        for(size_t i = q; i-- > 0;) {
+          if(i == p) continue;
+          addr_x += str_x[i];
+          addr_y += str_y[i];
+          if(++idx[i] < ext[i]) break;
+          addr_x -= ext[i]*str_x[i];
+          addr_y -= ext[i]*str_y[i];
+          idx[i] = 0;
+        }
+      }
+    }
+  }
+}
+
+/// strided copy, used when the fastest index of y is also the fastest index of x
+/// NOTE: all arrays are given in row-major order, i.e. str_y[rank-1] == 1 (and usually str_x[rank-1] == 1).
+/// the last index is copied as a contiguous block, the other (outer) indices are looped as a flat odometer,
+/// which are statically distributed over threads.
+template<typename T, class Ext_, class Op_ = __assign_op>
+void __reindex_strided (const T* px_, T* py_, const Ext_& ext, const Ext_& str_x, const Ext_& str_y, const Op_& op = Op_())
+{
+  const size_t rank = ext.size();
+  const size_t q = rank-1;
+  const size_t n = ext[q];
+  const size_t sxq = str_x[q];
+
+  size_t nouter = 1;
+  for(size_t i = 0; i < q; ++i) nouter *= ext[i];
+
+  const bool is_parallel = (nouter > 1 && nouter*n >= _BTAS_PERMUTE_PARALLEL_THRESHOLD && __max_threads() > 1);
+
+#ifdef _OPENMP
+#pragma omp parallel if(is_parallel)
+#endif
+  {
+    size_t first = 0;
+    size_t last  = nouter;
+    if(is_parallel) __thread_range(nouter,first,last);
+
+    if(first < last) {
+      // decode the first item to outer index and offsets
+      __loop_index idx(rank);
+      size_t addr_x = 0;
+      size_t addr_y = 0;
+      size_t ord = first;
+      for(size_t i = q; i-- > 0;) {
+        idx[i] = ord%ext[i]; ord /= ext[i];
+        addr_x += idx[i]*str_x[i];
+        addr_y += idx[i]*str_y[i];
+      }
+
+      for(size_t item = first; item < last; ++item) {
+        __copy_block(px_+addr_x,sxq,py_+addr_y,n,op);
+        // increment outer index
+        for(size_t i = q; i-- > 0;) {
+          addr_x += str_x[i];
+          addr_y += str_y[i];
+          if(++idx[i] < ext[i]) break;
+          addr_x -= ext[i]*str_x[i];
+          addr_y -= ext[i]*str_y[i];
+          idx[i] = 0;
+        }
+      }
+    }
+  }
+}
+
+/// reindex by Nd_loop_reindex, the slowest index of y is statically distributed over threads
+template<size_t N, CBLAS_LAYOUT Layout, typename T, class Ext_>
+void __reindex_loop (const T* px_, T* py_, const Ext_& str_x, const Ext_& ext_y)
+{
+  const size_t rank = ext_y.size();
+
+  size_t size = (rank > 0) ? 1 : 0;
+  for(size_t i = 0; i < rank; ++i) size *= ext_y[i];
+  if(size == 0) return;
+
+  // slowest index of y
+  const size_t s = (Layout == CblasRowMajor) ? 0 : rank-1;
+
+  if(ext_y[s] < 2 || size < _BTAS_PERMUTE_PARALLEL_THRESHOLD || __max_threads() == 1) {
+    Nd_loop_reindex<N,Layout>::loop(px_,py_,0,str_x,ext_y);
+    return;
+  }
+
+  const size_t str_y_s = size/ext_y[s];
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    size_t first;
+    size_t last;
+    __thread_range(ext_y[s],first,last);
+    if(first < last) {
+      Ext_ ext(ext_y); ext[s] = last-first;
+      const T* px = px_+first*str_x[s];
+            T* py = py_+first*str_y_s;
+      Nd_loop_reindex<N,Layout>::loop(px,py,0,str_x,ext);
+    }
+  }
+}
+
+/// in-place transpose of a square (n x n) matrix
+/// upper-triangular tiles are swapped with their lower-triangular counterparts,
+/// tile rows are distributed over threads dynamically since the work is triangular.
+template<typename T>
+void __reindex_inplace_square (T* px_, size_t n)
+{
+  const size_t bs = __reindex_block_size(sizeof(T));
+  const size_t nb = (n+bs-1)/bs;
+
+  const bool is_parallel = (nb > 1 && n*n >= _BTAS_PERMUTE_PARALLEL_THRESHOLD && __max_threads() > 1);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if(is_parallel)
+#endif
+  for(size_t ib = 0; ib < nb; ++ib) {
+    const size_t ie = std::min(ib*bs+bs,n);
+    for(size_t jb = ib*bs; jb < n; jb += bs) {
+      const size_t je = std::min(jb+bs,n);
+      for(size_t i = ib*bs; i < ie; ++i)
+        for(size_t j = std::max(jb,i+1); j < je; ++j) std::swap(px_[i*n+j],px_[j*n+i]);
+    }
+  }
+}
+
+/// in-place reindex by cycle-following
+/// NOTE: all arrays are given in row-major order, and str_y is the contiguous stride of y in the same order.
+/// elements are moved in units of nu contiguous elements (nu > 1 if the fastest index is untouched),
+/// the unit at ordinal iy of y comes from the unit at ordinal ix of x, which is followed as a permutation cycle.
+/// visited units are recorded by a bitmap, i.e. the extra memory is size/nu bits + a unit buffer.
+/// this trades speed for memory: each step is a random access and the source is found by rank-1 divisions,
+/// thus it is several times slower than the blocked reindex w/ a full-size temporary, and is used only when memory is short.
+template<typename T, class Ext_>
+void __reindex_inplace_cycle (T* px_, const Ext_& ext, const Ext_& str_x, const Ext_& str_y, size_t nu)
+{
+  const size_t rank = ext.size();
+
+  size_t size = 1;
+  for(size_t i = 0; i < rank; ++i) size *= ext[i];
+  const size_t nunit = size/nu;
+
+  // strides in units sorted in the order of y, the untouched fastest index is dropped if nu > 1
+  const size_t urank = (nu > 1) ? rank-1 : rank;
+  if(urank == 0) return;
+
+  std::vector<size_t> order(urank);
+  for(size_t i = 0; i < urank; ++i) order[i] = i;
+  std::sort(order.begin(),order.end(),[&str_y] (size_t i, size_t j) { return str_y[i] > str_y[j]; });
+
+  std::vector<size_t> str_ux(urank);
+  std::vector<size_t> str_uy(urank);
+  for(size_t i = 0; i < urank; ++i) {
+    str_ux[i] = str_x[order[i]]/nu;
+    str_uy[i] = str_y[order[i]]/nu;
+  }
+
+  // unit ordinal of y -> unit ordinal of x
+  // since str_uy is contiguous, each index is given by a division w/o modulo, and the fastest one (str_uy == 1) by the remainder
+  auto source = [&] (size_t iy) {
+    size_t ix = 0;
+    for(size_t i = 0; i < urank-1; ++i) {
+      const size_t k = iy/str_uy[i];
+      iy -= k*str_uy[i];
+      ix += k*str_ux[i];
+    }
+    return ix+iy*str_ux[urank-1];
+  };
+
+  std::vector<bool> visited(nunit,false);
+  std::vector<T> buf(nu);
+
+  for(size_t start = 0; start < nunit; ++start) {
+    if(visited[start]) continue;
+    visited[start] = true;
+    size_t iy = start;
+    size_t ix = source(iy);
+    if(ix == start) continue;
+    std::copy(px_+start*nu,px_+start*nu+nu,buf.begin());
+    while(ix != start) {
+      std::copy(px_+ix*nu,px_+ix*nu+nu,px_+iy*nu);
+      visited[ix] = true;
+      iy = ix;
+      ix = source(iy);
+    }
+    std::copy(buf.begin(),buf.end(),px_+iy*nu);
+  }
+}
+
+} // namespace detail
+
 /// carry out reindex (i.e. permute) for "any-rank" tensor
 /// multiple loop is expanded at compile time
 /// with -O2 level, this gives exactly the same speed as explicit multi-loop
+/// if the fastest index of y is not contiguous in x, the blocked (tiled) loop is used instead
+/// if the tensor is larger than _BTAS_PERMUTE_PARALLEL_THRESHOLD, loops are split over OpenMP threads
 template<typename T, size_t N, CBLAS_LAYOUT Layout, class Ext_>
 void reindex (const T* px_, T* py_, const Ext_& str_x, const Ext_& ext_y)
 {
-  Nd_loop_reindex<N,Layout>::loop(px_,py_,0,str_x,ext_y);
+  const size_t rank = ext_y.size();
+  const size_t q = (Layout == CblasRowMajor) ? rank-1 : 0;
+
+  // find the index which runs fastest in x
+  size_t p = rank;
+  if(rank > 1 && str_x[q] != 1)
+    for(size_t i = 0; i < rank; ++i) if(str_x[i] == 1) { p = i; break; }
+
+  // fastest index is untouched, or x has no contiguous index (e.g. tie)
+  if(p == rank) {
+    detail::__reindex_loop<N,Layout>(px_,py_,str_x,ext_y);
+    return;
+  }
+
+  // NOTE: col-major is carried out as row-major with reversed indices
+  Ext_ ext(ext_y);
+  Ext_ str(str_x);
+  if(Layout == CblasColMajor) {
+    std::reverse(ext.begin(),ext.end());
+    std::reverse(str.begin(),str.end());
+    p = rank-1-p;
+  }
+
+  Ext_ str_y(ext);
+  str_y[rank-1] = 1;
+  for(size_t i = rank-1; i > 0; --i) str_y[i-1] = ext[i]*str_y[i];
+
+  detail::__reindex_tiled(px_,py_,ext,str,str_y,p);
 }
 
 } // namespace btas
@@ -2,6 +2,7 @@
 #define __BTAS_REMOVE_COMPLEX_H
 
 #include <complex>
+#include <type_traits>
 
 namespace btas {
 
@@ -9,6 +10,10 @@ template<typename T> struct remove_complex { typedef T type; };
 
 template<typename T> struct remove_complex<std::complex<T>> { typedef T type; };
 
+template<typename T> struct is_complex : std::false_type { };
+
+template<typename T> struct is_complex<std::complex<T>> : std::true_type { };
+
 } // namespace btas
 
 #endif // __BTAS_REMOVE_COMPLEX_H
@@ -1,28 +1,184 @@
 #ifndef __BTAS_RESHAPE_HPP
 #define __BTAS_RESHAPE_HPP
 
+#include <array>
+#include <vector>
+#include <initializer_list>
+#include <utility> // std::move
+
+#include <BTAS_assert.h>
 #include <Tensor.hpp>
+#include <TensorWrapper.hpp>
 #include <TensorBlas.hpp>
 
 namespace btas {
 
-// reshape
+namespace detail {
+
+/// return number of elements of extent
+template<class Extent>
+size_t __extent_size (const Extent& ext)
+{
+  if(ext.size() == 0) return 0ul;
+  size_t n = 1;
+  for(size_t i = 0; i < ext.size(); ++i) n *= ext[i];
+  return n;
+}
+
+/// make extent of fused indices, where groups must be consecutive and cover all indices in order, e.g. {{0,1},{2},{3,4}}
+template<class Extent, size_t K>
+std::array<size_t,K> __fuse_extent (const Extent& ext, const std::initializer_list<size_t> (&groups)[K])
+{
+  std::array<size_t,K> fused;
+  size_t next = 0;
+  for(size_t k = 0; k < K; ++k) {
+    BTAS_assert(groups[k].size() > 0,"fuse_indices, detected empty group of indices.");
+    fused[k] = 1;
+    for(const size_t& i : groups[k]) {
+      BTAS_assert(i == next,"fuse_indices, indices must be consecutive in order (permute beforehand otherwise).");
+      fused[k] *= ext[next++];
+    }
+  }
+  BTAS_assert(next == ext.size(),"fuse_indices, groups must cover all indices.");
+  return fused;
+}
+
+/// make extent which i-th index is split into sub-indices of extent sub
+template<size_t M, size_t K>
+std::array<size_t,M+K-1> __split_extent (const std::array<size_t,M>& ext, size_t i, const size_t (&sub)[K])
+{
+  BTAS_assert(i < M,"split_index, index is out of range.");
+  size_t n = 1;
+  for(size_t k = 0; k < K; ++k) n *= sub[k];
+  BTAS_assert(n == ext[i],"split_index, detected inconsistent extent of sub-indices.");
+  std::array<size_t,M+K-1> split;
+  size_t j = 0;
+  for(size_t l = 0; l < i; ++l) split[j++] = ext[l];
+  for(size_t k = 0; k < K; ++k) split[j++] = sub[k];
+  for(size_t l = i+1; l < M; ++l) split[j++] = ext[l];
+  return split;
+}
+
+} // namespace detail
 
+// ----------------------------------------------------------------------------------------------------
+
+// reshape (copy)
+
+/// return a copy of x w/ new extent of the same size
 template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout>
-Tensor<T,N,Layout> reshape (const Tensor<T,M,Layout>& x, const typename Tensor<T,N,Layout>::extent_type& newext_)
+Tensor<T,N,Layout> reshape (const TensorBase<T,M,Layout>& x, const std::array<size_t,N>& newext_)
 {
-  Tensor<T,N,Layout> tmp_(newext_); copy(x,tmp_,true);
+  BTAS_assert(detail::__extent_size(newext_) == x.size(),"reshape, detected inconsistent size of new extent.");
+  Tensor<T,N,Layout> tmp_;
+  tmp_.resize_uninitialized(newext_);
+  copy(x.size(),x.data(),1,tmp_.data(),1);
   return tmp_;
 }
 
-template<typename T, size_t N, CBLAS_LAYOUT Layout, typename... Args>
-Tensor<T,sizeof...(Args),Layout> reshape (const Tensor<T,N,Layout>& x, const Args&... args)
+/// return a copy of x w/ new extent of the same size (dynamic rank)
+template<typename T, size_t M, CBLAS_LAYOUT Layout>
+Tensor<T,0ul,Layout> reshape (const TensorBase<T,M,Layout>& x, const std::vector<size_t>& newext_)
 {
-  Tensor<T,sizeof...(Args),Layout> tmp_(args...);
-  copy(x,tmp_,true);
+  BTAS_assert(detail::__extent_size(newext_) == x.size(),"reshape, detected inconsistent size of new extent.");
+  Tensor<T,0ul,Layout> tmp_;
+  tmp_.resize_uninitialized(newext_);
+  copy(x.size(),x.data(),1,tmp_.data(),1);
   return tmp_;
 }
 
+/// return a copy of x w/ new extent given by variadic arguments list
+template<typename T, size_t M, CBLAS_LAYOUT Layout, typename... Args>
+Tensor<T,sizeof...(Args),Layout> reshape (const TensorBase<T,M,Layout>& x, const Args&... args)
+{
+  return reshape(x,shape(args...));
+}
+
+// reshape (move)
+
+/// return x w/ new extent of the same size, which takes over data of x w/o copy (x becomes empty)
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class Alloc>
+Tensor<T,N,Layout,Alloc> reshape (Tensor<T,M,Layout,Alloc>&& x, const std::array<size_t,N>& newext_)
+{
+  return Tensor<T,N,Layout,Alloc>(std::move(x),newext_);
+}
+
+/// return x w/ new extent of the same size, which takes over data of x w/o copy (dynamic rank)
+template<typename T, size_t M, CBLAS_LAYOUT Layout, class Alloc>
+Tensor<T,0ul,Layout,Alloc> reshape (Tensor<T,M,Layout,Alloc>&& x, const std::vector<size_t>& newext_)
+{
+  return Tensor<T,0ul,Layout,Alloc>(std::move(x),newext_);
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// reshape_view (w/o copy)
+
+/// return a view of x w/ new extent of the same size, which shares data w/ x
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout>
+TensorWrapper<T*,N,Layout> reshape_view (TensorBase<T,M,Layout>& x, const std::array<size_t,N>& newext_)
+{
+  BTAS_assert(detail::__extent_size(newext_) == x.size(),"reshape_view, detected inconsistent size of new extent.");
+  return TensorWrapper<T*,N,Layout>(x.data(),newext_);
+}
+
+/// return a const view of x w/ new extent of the same size, which shares data w/ x
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout>
+TensorWrapper<const T*,N,Layout> reshape_view (const TensorBase<T,M,Layout>& x, const std::array<size_t,N>& newext_)
+{
+  BTAS_assert(detail::__extent_size(newext_) == x.size(),"reshape_view, detected inconsistent size of new extent.");
+  return TensorWrapper<const T*,N,Layout>(x.data(),newext_);
+}
+
+/// return a view of x w/ new extent of the same size (dynamic rank)
+template<typename T, size_t M, CBLAS_LAYOUT Layout>
+TensorWrapper<T*,0ul,Layout> reshape_view (TensorBase<T,M,Layout>& x, const std::vector<size_t>& newext_)
+{
+  BTAS_assert(detail::__extent_size(newext_) == x.size(),"reshape_view, detected inconsistent size of new extent.");
+  return TensorWrapper<T*,0ul,Layout>(x.data(),newext_);
+}
+
+/// return a const view of x w/ new extent of the same size (dynamic rank)
+template<typename T, size_t M, CBLAS_LAYOUT Layout>
+TensorWrapper<const T*,0ul,Layout> reshape_view (const TensorBase<T,M,Layout>& x, const std::vector<size_t>& newext_)
+{
+  BTAS_assert(detail::__extent_size(newext_) == x.size(),"reshape_view, detected inconsistent size of new extent.");
+  return TensorWrapper<const T*,0ul,Layout>(x.data(),newext_);
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// fuse_indices and split_index (w/o copy)
+// NOTE: only consecutive indices can be fused since data are not moved, in either of row-major and column-major
+
+/// return a view of x w/ groups of consecutive indices fused, e.g. fuse_indices(x,{{0,1},{2,3}}) gives x(i*j,k*l)
+template<typename T, size_t M, CBLAS_LAYOUT Layout, size_t K>
+TensorWrapper<T*,K,Layout> fuse_indices (TensorBase<T,M,Layout>& x, const std::initializer_list<size_t> (&groups)[K])
+{
+  return TensorWrapper<T*,K,Layout>(x.data(),detail::__fuse_extent(x.extent(),groups));
+}
+
+/// return a const view of x w/ groups of consecutive indices fused
+template<typename T, size_t M, CBLAS_LAYOUT Layout, size_t K>
+TensorWrapper<const T*,K,Layout> fuse_indices (const TensorBase<T,M,Layout>& x, const std::initializer_list<size_t> (&groups)[K])
+{
+  return TensorWrapper<const T*,K,Layout>(x.data(),detail::__fuse_extent(x.extent(),groups));
+}
+
+/// return a view of x w/ i-th index split into sub-indices, e.g. split_index(x,1,{a,b}) gives x(i,j/b,j%b,k) in row-major
+template<typename T, size_t M, CBLAS_LAYOUT Layout, size_t K>
+TensorWrapper<T*,M+K-1,Layout> split_index (TensorBase<T,M,Layout>& x, size_t i, const size_t (&sub)[K])
+{
+  return TensorWrapper<T*,M+K-1,Layout>(x.data(),detail::__split_extent(x.extent(),i,sub));
+}
+
+/// return a const view of x w/ i-th index split into sub-indices
+template<typename T, size_t M, CBLAS_LAYOUT Layout, size_t K>
+TensorWrapper<const T*,M+K-1,Layout> split_index (const TensorBase<T,M,Layout>& x, size_t i, const size_t (&sub)[K])
+{
+  return TensorWrapper<const T*,M+K-1,Layout>(x.data(),detail::__split_extent(x.extent(),i,sub));
+}
+
 } // namespace btas
 
 #endif // __BTAS_RESHAPE_HPP
@@ -0,0 +1,218 @@
+#ifndef __BTAS_SYMBOLS_HPP
+#define __BTAS_SYMBOLS_HPP
+
+#include <array>
+#include <type_traits> // std::conditional
+
+#include <TensorStride.hpp> // CBLAS_TRANSPOSE
+
+namespace btas {
+
+/// Index symbols given at compile time, e.g. contract(alpha,a,symbols<'i','p','j'>(),b,symbols<'p','k'>(),beta,c,symbols<'i','j','k'>())
+/// For contract(), contraction indices, permutation of the result and trans flags are resolved at compile time.
+template<char... Cs>
+struct symbols {
+
+  typedef char value_type;
+
+  static constexpr size_t size () { return sizeof...(Cs); }
+
+  /// convert to runtime symbols
+  static std::array<char,sizeof...(Cs)> array () { return {{ Cs... }}; }
+
+};
+
+/// Sequence of indices given at compile time
+template<size_t... Is>
+struct index_seq {
+
+  static constexpr size_t size () { return sizeof...(Is); }
+
+  /// convert to runtime index
+  static std::array<size_t,sizeof...(Is)> array () { return {{ Is... }}; }
+
+};
+
+namespace detail {
+
+/// position of C in Cs..., which is sizeof...(Cs) if not found
+template<char C, char... Cs> struct __symbol_find;
+
+template<char C>
+struct __symbol_find<C> { static constexpr size_t value = 0; };
+
+template<char C, char C0, char... Cs>
+struct __symbol_find<C,C0,Cs...> { static constexpr size_t value = (C == C0) ? 0 : 1+__symbol_find<C,Cs...>::value; };
+
+/// true if symbols are not duplicated
+template<char... Cs> struct __symbol_unique;
+
+template<>
+struct __symbol_unique<> { static constexpr bool value = true; };
+
+template<char C0, char... Cs>
+struct __symbol_unique<C0,Cs...> { static constexpr bool value = (__symbol_find<C0,Cs...>::value == sizeof...(Cs)) && __symbol_unique<Cs...>::value; };
+
+template<class Seq, size_t I> struct __index_push;
+
+template<size_t... Is, size_t I>
+struct __index_push<index_seq<Is...>,I> { typedef index_seq<Is...,I> type; };
+
+template<class Symb, char C> struct __symbol_push;
+
+template<char... Cs, char C>
+struct __symbol_push<symbols<Cs...>,C> { typedef symbols<Cs...,C> type; };
+
+template<class SymbX, class SymbY> struct __symbol_cat;
+
+template<char... Xs, char... Ys>
+struct __symbol_cat<symbols<Xs...>,symbols<Ys...>> { typedef symbols<Xs...,Ys...> type; };
+
+/// scan symbols of x against symbols of y
+/// \typedef idxx positions of x's symbols found in y
+/// \typedef idxy positions in y of x's symbols found in y
+/// \typedef freex x's symbols not found in y
+template<class SymbY, size_t I, class IdxX, class IdxY, class FreeX, char... Xs> struct __symbol_scan;
+
+template<char... Ys, size_t I, class IdxX, class IdxY, class FreeX>
+struct __symbol_scan<symbols<Ys...>,I,IdxX,IdxY,FreeX> {
+  typedef IdxX idxx;
+  typedef IdxY idxy;
+  typedef FreeX freex;
+};
+
+template<char... Ys, size_t I, class IdxX, class IdxY, class FreeX, char X, char... Xs>
+struct __symbol_scan<symbols<Ys...>,I,IdxX,IdxY,FreeX,X,Xs...> {
+  static constexpr size_t J = __symbol_find<X,Ys...>::value;
+  static constexpr bool found = (J < sizeof...(Ys));
+  typedef __symbol_scan<symbols<Ys...>,I+1,
+    typename std::conditional<found,typename __index_push<IdxX,I>::type,IdxX>::type,
+    typename std::conditional<found,typename __index_push<IdxY,J>::type,IdxY>::type,
+    typename std::conditional<found,FreeX,typename __symbol_push<FreeX,X>::type>::type,Xs...> next_;
+  typedef typename next_::idxx idxx;
+  typedef typename next_::idxy idxy;
+  typedef typename next_::freex freex;
+};
+
+/// true if all of Is... are less than Size
+template<size_t Size, size_t... Is> struct __index_less;
+
+template<size_t Size>
+struct __index_less<Size> { static constexpr bool value = true; };
+
+template<size_t Size, size_t I0, size_t... Is>
+struct __index_less<Size,I0,Is...> { static constexpr bool value = (I0 < Size) && __index_less<Size,Is...>::value; };
+
+/// positions of Cs... in symbols X
+template<class SymbX, char... Cs> struct __symbol_index;
+
+template<char... Xs, char... Cs>
+struct __symbol_index<symbols<Xs...>,Cs...> {
+  typedef index_seq<__symbol_find<Cs,Xs...>::value...> type;
+  static constexpr bool found = __index_less<sizeof...(Xs),__symbol_find<Cs,Xs...>::value...>::value;
+};
+
+/// true if Is... = { First, First+1, ... }
+template<size_t First, size_t... Is> struct __index_contiguous;
+
+template<size_t First>
+struct __index_contiguous<First> { static constexpr bool value = true; };
+
+template<size_t First, size_t I0, size_t... Is>
+struct __index_contiguous<First,I0,Is...> { static constexpr bool value = (I0 == First) && __index_contiguous<First+1,Is...>::value; };
+
+template<size_t First, class Seq> struct __index_is_range;
+
+template<size_t First, size_t... Is>
+struct __index_is_range<First,index_seq<Is...>> { static constexpr bool value = __index_contiguous<First,Is...>::value; };
+
+/// true if Is... = { First, First+1, ... } modulo Mod
+template<size_t First, size_t Mod, size_t... Is> struct __index_cyclic;
+
+template<size_t First, size_t Mod>
+struct __index_cyclic<First,Mod> { static constexpr bool value = true; };
+
+template<size_t First, size_t Mod, size_t I0, size_t... Is>
+struct __index_cyclic<First,Mod,I0,Is...> { static constexpr bool value = (I0 == First%Mod) && __index_cyclic<First+1,Mod,Is...>::value; };
+
+template<size_t First, size_t Mod, class Seq> struct __index_is_cyclic;
+
+template<size_t First, size_t Mod, size_t... Is>
+struct __index_is_cyclic<First,Mod,index_seq<Is...>> { static constexpr bool value = __index_cyclic<First,Mod,Is...>::value; };
+
+/// number of Cs... found in both symbols X and Y
+template<class SymbX, class SymbY, char... Cs> struct __symbol_count;
+
+template<char... Xs, char... Ys>
+struct __symbol_count<symbols<Xs...>,symbols<Ys...>> { static constexpr size_t value = 0; };
+
+template<char... Xs, char... Ys, char C0, char... Cs>
+struct __symbol_count<symbols<Xs...>,symbols<Ys...>,C0,Cs...> {
+  static constexpr size_t value = ((__symbol_find<C0,Xs...>::value < sizeof...(Xs) && __symbol_find<C0,Ys...>::value < sizeof...(Ys)) ? 1 : 0)
+                                + __symbol_count<symbols<Xs...>,symbols<Ys...>,Cs...>::value;
+};
+
+} // namespace detail
+
+/// Contraction c = a * b analyzed at compile time from index symbols
+/// \typedef idxa, idxb contraction indices of a and b
+/// \typedef symbaxb index symbols of a*b, i.e. free indices of a followed by free indices of b
+/// \typedef pmutc permutation from a*b to c, s.t. c's i-th index is a*b's pmutc[i]-th index
+/// \typedef extc position of c's index in extents of a followed by extents of b
+/// is_matrix is true if a and b are contracted by a single GEMM w/o permutation, with trans flags transa and transb
+/// is_c_swapped is true if c is written directly as (b^T * a^T)^T
+/// H is the number of batch (Hadamard) indices which appear in a, b and c (counted in K as well), for which is_matrix is false
+template<class SymbA, class SymbB, class SymbC> struct contract_symbols;
+
+template<char... As, char... Bs, char... Cs>
+struct contract_symbols<symbols<As...>,symbols<Bs...>,symbols<Cs...>> {
+
+  typedef detail::__symbol_scan<symbols<Bs...>,0,index_seq<>,index_seq<>,symbols<>,As...> scan_a_;
+  typedef detail::__symbol_scan<symbols<As...>,0,index_seq<>,index_seq<>,symbols<>,Bs...> scan_b_;
+
+  typedef typename scan_a_::idxx idxa;
+  typedef typename scan_a_::idxy idxb;
+
+  typedef typename detail::__symbol_cat<typename scan_a_::freex,typename scan_b_::freex>::type symbaxb;
+
+  typedef detail::__symbol_index<symbaxb,Cs...> pmutc_;
+  typedef typename pmutc_::type pmutc;
+
+  static constexpr size_t L = sizeof...(As);
+  static constexpr size_t M = sizeof...(Bs);
+  static constexpr size_t N = sizeof...(Cs);
+  static constexpr size_t H = detail::__symbol_count<symbols<As...>,symbols<Bs...>,Cs...>::value;
+  static constexpr size_t K = idxa::size();
+
+  static_assert(detail::__symbol_unique<As...>::value,"contract_symbols, detected duplicate symbols in a.");
+  static_assert(detail::__symbol_unique<Bs...>::value,"contract_symbols, detected duplicate symbols in b.");
+  static_assert(detail::__symbol_unique<Cs...>::value,"contract_symbols, detected duplicate symbols in c.");
+  static_assert(H > 0 || (symbaxb::size() == N && pmutc_::found),"contract_symbols, symbols of c must be the free symbols of a and b.");
+
+  /// position of c's index in extents of a followed by extents of b
+  typedef index_seq<(detail::__symbol_find<Cs,As...>::value < sizeof...(As) ? detail::__symbol_find<Cs,As...>::value
+                                                                          : sizeof...(As)+detail::__symbol_find<Cs,Bs...>::value)...> extc;
+
+  /// true if a*b must be permuted into c
+  static constexpr bool is_c_permuted = !detail::__index_is_range<0,pmutc>::value;
+
+  /// number of free indices of a
+  static constexpr size_t Na = L-K;
+
+  /// true if c has free indices of b followed by those of a, s.t. c = (b^T * a^T)^T w/o permutation
+  static constexpr bool is_c_swapped = (Na > 0 && Na < N) && detail::__index_is_cyclic<Na,(N > 0 ? N : 1),pmutc>::value;
+
+  // a is either (free, contracted) or (contracted, free), and b has contracted indices in the same order at either end
+  static constexpr bool is_idxb_ordered = detail::__index_is_range<0,idxb>::value || detail::__index_is_range<M-K,idxb>::value;
+
+  static constexpr bool is_matrix = (H == 0) && (detail::__index_is_range<L-K,idxa>::value || detail::__index_is_range<0,idxa>::value) && is_idxb_ordered;
+
+  static constexpr CBLAS_TRANSPOSE transa = detail::__index_is_range<L-K,idxa>::value ? CblasNoTrans : CblasTrans;
+
+  static constexpr CBLAS_TRANSPOSE transb = detail::__index_is_range<0,idxb>::value ? CblasNoTrans : CblasTrans;
+
+};
+
+} // namespace btas
+
+#endif // __BTAS_SYMBOLS_HPP
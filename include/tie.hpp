@@ -12,8 +12,8 @@ namespace btas {
 /// tie index, i.e. x[i,j,k,j] -> y[i,j,k]
 /// x[i,j,k,l], idx = {0,1,2,1} -> y[i,j,k] : x[i,j,k,j]
 /// x[i,j,k,l], idx = {0,2,1,2} -> y[i,k,l] : x[i,l,k,l]
-template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class Index>
-void tie (const Tensor<T,M,Layout>& x, const Index& idx, Tensor<T,N,Layout>& y)
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class Index, class AllocX, class AllocY>
+void tie (const Tensor<T,M,Layout,AllocX>& x, const Index& idx, Tensor<T,N,Layout,AllocY>& y)
 {
 #ifdef _DEBUG
   assert(idx.size() == x.rank());
@@ -34,7 +34,7 @@ void tie (const Tensor<T,M,Layout>& x, const Index& idx, Tensor<T,N,Layout>& y)
     strY[idx[i]] += x.stride(i);
   }
 
-  y.resize(extY); reindex(x.data(),y.data(),strY,extY);
+  y.resize_uninitialized(extY); reindex<T,N,Layout>(x.data(),y.data(),strY,extY);
 }
 
 } // namespace btas
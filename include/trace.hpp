@@ -0,0 +1,262 @@
+#ifndef __BTAS_TRACE_HPP
+#define __BTAS_TRACE_HPP
+
+#include <vector>
+#include <utility> // std::pair
+#include <algorithm> // std::fill, std::reverse
+#include <type_traits> // std::enable_if
+
+#include <BTAS_assert.h>
+#include <parallel.h>
+#include <reindex.hpp> // _BTAS_PERMUTE_PARALLEL_THRESHOLD
+#include <Tensor.hpp>
+#include <TensorView.hpp>
+#include <contract_helper.hpp> // detail::__contract_resize
+
+namespace btas {
+
+/// pairs of indices to be traced, e.g. {{0,2},{1,3}}
+typedef std::vector<std::pair<size_t,size_t>> trace_pairs;
+
+namespace detail {
+
+/// analyzed partial trace, y[j] = sum_t x[offset(j)+toff[t]]
+/// indices of y are stored in the order of memory (innermost last), s.t. y is dense
+struct __trace_layout {
+  std::vector<size_t> exty; ///< extents of y in the order of memory
+  std::vector<size_t> strx; ///< strides of x for indices of y
+  std::vector<size_t> toff; ///< offsets of x for all traced indices
+  size_t sizey;
+};
+
+/// analyze partial trace of x, which has extent ext and (possibly non-dense) stride str
+/// \param extyout extent of y in the order of indices, i.e. free indices of x in the same order
+template<CBLAS_LAYOUT Layout, class Extent, class Stride, class ExtentY>
+void __make_trace_layout (const Extent& ext, const Stride& str, const trace_pairs& pairs, ExtentY& extyout, __trace_layout& t)
+{
+  const size_t rank = ext.size();
+  std::vector<bool> traced(rank,false);
+
+  // extents and strides of traced indices
+  std::vector<size_t> extt;
+  std::vector<size_t> strt;
+  for(size_t p = 0; p < pairs.size(); ++p) {
+    const size_t i = pairs[p].first;
+    const size_t j = pairs[p].second;
+    BTAS_assert(i < rank && j < rank && i != j,"partial_trace, detected out of range index pair.");
+    BTAS_assert(!traced[i] && !traced[j],"partial_trace, index is traced more than once.");
+    BTAS_assert(ext[i] == ext[j],"partial_trace, indices to be traced have different size.");
+    traced[i] = traced[j] = true;
+    extt.push_back(ext[i]);
+    strt.push_back(str[i]+str[j]);
+  }
+
+  __contract_resize(extyout,rank-2*pairs.size());
+  t.exty.clear();
+  t.strx.clear();
+  t.sizey = 1;
+  for(size_t i = 0, n = 0; i < rank; ++i) {
+    if(traced[i]) continue;
+    extyout[n++] = ext[i];
+    t.exty.push_back(ext[i]);
+    t.strx.push_back(str[i]);
+    t.sizey *= ext[i];
+  }
+  if(Layout == CblasColMajor) {
+    std::reverse(t.exty.begin(),t.exty.end());
+    std::reverse(t.strx.begin(),t.strx.end());
+  }
+  // y of rank 0 is a single element
+  if(t.exty.empty()) {
+    t.exty.push_back(1);
+    t.strx.push_back(0);
+  }
+
+  // offsets of traced indices, i.e. diagonal elements
+  size_t nt = 1;
+  for(size_t p = 0; p < extt.size(); ++p) nt *= extt[p];
+  t.toff.resize(nt);
+  std::vector<size_t> idx(extt.size(),0);
+  for(size_t k = 0, off = 0; k < nt; ++k) {
+    t.toff[k] = off;
+    for(size_t p = extt.size(); p > 0; --p) {
+      off += strt[p-1];
+      if(++idx[p-1] < extt[p-1]) break;
+      off -= idx[p-1]*strt[p-1];
+      idx[p-1] = 0;
+    }
+  }
+}
+
+/// y of rank 0 is stored in extent {1} if y has dynamic rank
+template<typename T, size_t N>
+void __trace_extent_scalar (std::array<T,N>&) { }
+
+template<typename T>
+void __trace_extent_scalar (std::vector<T>& x) { if(x.empty()) x.assign(1,1); }
+
+/// y = alpha * Tr(x) + beta * y, in a single strided pass over x
+/// rows of y (innermost index) are split over threads, and each row is accumulated over traced indices,
+/// which is vectorized if the innermost index of y is contiguous in x
+/// if y is a single element (e.g. full trace), traced indices are split over threads instead
+template<typename T>
+void __partial_trace (const T& alpha, const T* px, const __trace_layout& t, const T& beta, T* py)
+{
+  const size_t rank = t.exty.size();
+  const size_t n0 = t.exty[rank-1];
+  const size_t s0 = t.strx[rank-1];
+  const size_t nrows = t.sizey/n0;
+  const size_t nt = t.toff.size();
+
+  if(t.sizey == 0) return;
+
+  const bool is_parallel = (t.sizey*nt >= _BTAS_PERMUTE_PARALLEL_THRESHOLD && detail::__max_threads() > 1);
+
+  if(t.sizey == 1) {
+    // full trace
+    T sum = static_cast<T>(0);
+#ifdef _OPENMP
+#pragma omp parallel if(is_parallel)
+#endif
+    {
+      size_t first = 0;
+      size_t last  = nt;
+      if(is_parallel) detail::__thread_range(nt,first,last);
+
+      T sum_ = static_cast<T>(0);
+      for(size_t k = first; k < last; ++k) sum_ += px[t.toff[k]];
+
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+      sum += sum_;
+    }
+    py[0] = (beta == static_cast<T>(0)) ? alpha*sum : alpha*sum+beta*py[0];
+    return;
+  }
+
+#ifdef _OPENMP
+#pragma omp parallel if(is_parallel && nrows > 1)
+#endif
+  {
+    size_t first = 0;
+    size_t last  = nrows;
+    if(is_parallel && nrows > 1) detail::__thread_range(nrows,first,last);
+
+    std::vector<T> acc(n0);
+    for(size_t r = first; r < last; ++r) {
+      // offset of r-th row in x
+      size_t offx = 0;
+      for(size_t i = rank-1, ord = r; i > 0; --i) {
+        offx += (ord%t.exty[i-1])*t.strx[i-1];
+        ord /= t.exty[i-1];
+      }
+
+      std::fill(acc.begin(),acc.end(),static_cast<T>(0));
+      if(s0 == 1) {
+        for(size_t k = 0; k < nt; ++k) {
+          const T* x = px+offx+t.toff[k];
+          for(size_t j = 0; j < n0; ++j) acc[j] += x[j];
+        }
+      }
+      else {
+        for(size_t k = 0; k < nt; ++k) {
+          const T* x = px+offx+t.toff[k];
+          for(size_t j = 0; j < n0; ++j) acc[j] += x[j*s0];
+        }
+      }
+
+      T* y = py+r*n0;
+      if(beta == static_cast<T>(0))
+        for(size_t j = 0; j < n0; ++j) y[j] = alpha*acc[j];
+      else
+        for(size_t j = 0; j < n0; ++j) y[j] = alpha*acc[j]+beta*y[j];
+    }
+  }
+}
+
+} // namespace detail
+
+/// scaled-accumulate partial trace, y = alpha * Tr(x) + beta * y, where paired indices of x are summed up
+/// x[i,j,k,l], pairs = {{1,3}} -> y[i,k] = sum_j x[i,j,k,j]
+/// x[i,j,k,l], pairs = {{0,2},{1,3}} -> y = sum_{i,j} x[i,j,i,j], stored in y of extent {1} if y has dynamic rank
+/// free indices of x are kept in y in the same order, w/o a temporary of the generalized diagonal as by tie()
+template<typename T, size_t M, size_t N, CBLAS_LAYOUT Layout, class AllocY>
+void partial_trace (const T& alpha, const TensorBase<T,M,Layout>& x, const trace_pairs& pairs, const T& beta, Tensor<T,N,Layout,AllocY>& y)
+{
+  typename Tensor<T,N,Layout>::extent_type exty;
+  detail::__trace_layout t;
+  detail::__make_trace_layout<Layout>(x.extent(),x.stride(),pairs,exty,t);
+  detail::__trace_extent_scalar(exty);
+
+  if(y.empty())
+    y.resize(exty,static_cast<T>(0));
+  else
+    BTAS_assert(std::equal(exty.begin(),exty.end(),y.extent().begin()),"partial_trace, detected inconsistent extents (x vs y).");
+
+  detail::__partial_trace(alpha,x.data(),t,beta,y.data());
+}
+
+/// scaled-accumulate partial trace for TensorView, y = alpha * Tr(x) + beta * y
+/// x can be a non-contiguous view (e.g. slice), which is read through its stride(hack)
+template<typename T, typename U, size_t M, size_t N, CBLAS_LAYOUT Layout, class AllocY, class = typename std::enable_if<
+  std::is_same<typename std::remove_const<U>::type,T>::value>::type>
+void partial_trace (const T& alpha, const TensorView<U*,M,Layout>& x, const trace_pairs& pairs, const T& beta, Tensor<T,N,Layout,AllocY>& y)
+{
+  const auto first = x.begin();
+  typename Tensor<T,N,Layout>::extent_type exty;
+  detail::__trace_layout t;
+  detail::__make_trace_layout<Layout>(x.extent(),first.stride_hack(),pairs,exty,t);
+  detail::__trace_extent_scalar(exty);
+
+  if(y.empty())
+    y.resize(exty,static_cast<T>(0));
+  else
+    BTAS_assert(std::equal(exty.begin(),exty.end(),y.extent().begin()),"partial_trace, detected inconsistent extents (x vs y).");
+
+  if(x.empty()) return;
+  detail::__partial_trace(alpha,first.base(),t,beta,y.data());
+}
+
+/// partial trace, y = Tr(x) over paired indices, e.g. partial_trace(x,{{0,2}},y)
+template<class TensorX, typename T, size_t N, CBLAS_LAYOUT Layout, class AllocY>
+void partial_trace (const TensorX& x, const trace_pairs& pairs, Tensor<T,N,Layout,AllocY>& y)
+{
+  y.clear();
+  partial_trace(static_cast<T>(1),x,pairs,static_cast<T>(0),y);
+}
+
+/// full trace, all indices of x must be paired, e.g. trace(x,{{0,1}}) for a matrix
+template<typename T, size_t M, CBLAS_LAYOUT Layout>
+T trace (const TensorBase<T,M,Layout>& x, const trace_pairs& pairs)
+{
+  BTAS_assert(2*pairs.size() == x.extent().size(),"trace, all indices must be paired.");
+  std::vector<size_t> exty;
+  detail::__trace_layout t;
+  detail::__make_trace_layout<Layout>(x.extent(),x.stride(),pairs,exty,t);
+
+  T value = static_cast<T>(0);
+  detail::__partial_trace(static_cast<T>(1),x.data(),t,static_cast<T>(0),&value);
+  return value;
+}
+
+/// full trace for TensorView
+template<typename U, size_t M, CBLAS_LAYOUT Layout>
+typename std::remove_const<U>::type trace (const TensorView<U*,M,Layout>& x, const trace_pairs& pairs)
+{
+  typedef typename std::remove_const<U>::type T;
+  BTAS_assert(2*pairs.size() == x.extent().size(),"trace, all indices must be paired.");
+  T value = static_cast<T>(0);
+  if(x.empty()) return value;
+
+  const auto first = x.begin();
+  std::vector<size_t> exty;
+  detail::__trace_layout t;
+  detail::__make_trace_layout<Layout>(x.extent(),first.stride_hack(),pairs,exty,t);
+  detail::__partial_trace(static_cast<T>(1),first.base(),t,static_cast<T>(0),&value);
+  return value;
+}
+
+} // namespace btas
+
+#endif // __BTAS_TRACE_HPP
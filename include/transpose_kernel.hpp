@@ -0,0 +1,349 @@
+#ifndef __BTAS_TRANSPOSE_KERNEL_HPP
+#define __BTAS_TRANSPOSE_KERNEL_HPP
+
+#include <complex>
+#include <algorithm> // std::copy
+
+// SIMD kernels are compiled with function-level target attributes and selected at run time,
+// so that the same binary runs on both AVX2 and AVX-512 nodes.
+// define _BTAS_DISABLE_SIMD to use the scalar loop only.
+#if !defined(_BTAS_DISABLE_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define _BTAS_SIMD_TRANSPOSE
+#include <immintrin.h>
+#endif
+
+namespace btas {
+
+namespace detail {
+
+/// element-wise operation for reindex: y = x
+struct __assign_op {
+  template<typename T>
+  void operator() (T& y, const T& x) const { y = x; }
+};
+
+/// element-wise operation for reindex: y = alpha*x
+template<typename T>
+struct __scal_op {
+  T alpha;
+  void operator() (T& y, const T& x) const { y = alpha*x; }
+};
+
+/// element-wise operation for reindex: y = alpha*x + beta*y
+template<typename T>
+struct __axpby_op {
+  T alpha;
+  T beta;
+  void operator() (T& y, const T& x) const { y = alpha*x+beta*y; }
+};
+
+/// element-wise operation for reindex: y = conj(x), which is y = x for real types
+struct __conj_op {
+  template<typename T>
+  void operator() (T& y, const T& x) const { y = x; }
+  template<typename T>
+  void operator() (std::complex<T>& y, const std::complex<T>& x) const { y = std::conj(x); }
+};
+
+// ----------------------------------------------------------------------------------------------------
+
+/// micro-kernel to transpose a square tile of fixed size, y[i*ldy+j] = x[j*ldx+i]
+/// the kernel is selected once by CPU features, size == 0 means no kernel is available
+template<typename T>
+struct __transpose_kernel {
+
+  typedef void (*kernel_type)(const T*, size_t, T*, size_t);
+
+  size_t size;
+
+  kernel_type call;
+
+  static const __transpose_kernel& get ()
+  {
+    static const __transpose_kernel k_ = { 0ul, nullptr };
+    return k_;
+  }
+};
+
+#ifdef _BTAS_SIMD_TRANSPOSE
+
+// ----------------------------------------------------------------------------------------------------
+
+/// 4x4 tile of double (AVX/AVX2)
+__attribute__((target("avx")))
+inline void __transpose_4x4_avx (const double* x, size_t ldx, double* y, size_t ldy)
+{
+  __m256d r0 = _mm256_loadu_pd(x);
+  __m256d r1 = _mm256_loadu_pd(x+ldx);
+  __m256d r2 = _mm256_loadu_pd(x+ldx*2);
+  __m256d r3 = _mm256_loadu_pd(x+ldx*3);
+
+  __m256d t0 = _mm256_unpacklo_pd(r0,r1);
+  __m256d t1 = _mm256_unpackhi_pd(r0,r1);
+  __m256d t2 = _mm256_unpacklo_pd(r2,r3);
+  __m256d t3 = _mm256_unpackhi_pd(r2,r3);
+
+  _mm256_storeu_pd(y,      _mm256_permute2f128_pd(t0,t2,0x20));
+  _mm256_storeu_pd(y+ldy,  _mm256_permute2f128_pd(t1,t3,0x20));
+  _mm256_storeu_pd(y+ldy*2,_mm256_permute2f128_pd(t0,t2,0x31));
+  _mm256_storeu_pd(y+ldy*3,_mm256_permute2f128_pd(t1,t3,0x31));
+}
+
+/// 8x8 tile of double (AVX-512)
+/// NOTE: zero-masking variants w/ full mask are used for shuffles, since the unmasked ones pass _mm512_undefined_pd() as source,
+///       for which GCC 12 warns '__Y' is used uninitialized; both give the same instructions
+__attribute__((target("avx512f")))
+inline void __transpose_8x8_avx512 (const double* x, size_t ldx, double* y, size_t ldy)
+{
+  const __mmask8 k = 0xff;
+
+  __m512d r[8];
+  for(size_t j = 0; j < 8; ++j) r[j] = _mm512_loadu_pd(x+ldx*j);
+
+  // 2x2 blocks in each 128-bit lane
+  __m512d t[8];
+  for(size_t j = 0; j < 4; ++j) {
+    t[2*j  ] = _mm512_maskz_unpacklo_pd(k,r[2*j],r[2*j+1]);
+    t[2*j+1] = _mm512_maskz_unpackhi_pd(k,r[2*j],r[2*j+1]);
+  }
+
+  // gather 128-bit lanes from pairs of rows
+  __m512d u[8];
+  u[0] = _mm512_maskz_shuffle_f64x2(k,t[0],t[2],0x88);
+  u[1] = _mm512_maskz_shuffle_f64x2(k,t[1],t[3],0x88);
+  u[2] = _mm512_maskz_shuffle_f64x2(k,t[0],t[2],0xdd);
+  u[3] = _mm512_maskz_shuffle_f64x2(k,t[1],t[3],0xdd);
+  u[4] = _mm512_maskz_shuffle_f64x2(k,t[4],t[6],0x88);
+  u[5] = _mm512_maskz_shuffle_f64x2(k,t[5],t[7],0x88);
+  u[6] = _mm512_maskz_shuffle_f64x2(k,t[4],t[6],0xdd);
+  u[7] = _mm512_maskz_shuffle_f64x2(k,t[5],t[7],0xdd);
+
+  for(size_t i = 0; i < 4; ++i) {
+    _mm512_storeu_pd(y+ldy*i,    _mm512_maskz_shuffle_f64x2(k,u[i],u[i+4],0x88));
+    _mm512_storeu_pd(y+ldy*(i+4),_mm512_maskz_shuffle_f64x2(k,u[i],u[i+4],0xdd));
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+/// 8x8 tile of float (AVX/AVX2)
+__attribute__((target("avx")))
+inline void __transpose_8x8_avx (const float* x, size_t ldx, float* y, size_t ldy)
+{
+  __m256 r[8];
+  for(size_t j = 0; j < 8; ++j) r[j] = _mm256_loadu_ps(x+ldx*j);
+
+  __m256 t[8];
+  for(size_t j = 0; j < 4; ++j) {
+    t[2*j  ] = _mm256_unpacklo_ps(r[2*j],r[2*j+1]);
+    t[2*j+1] = _mm256_unpackhi_ps(r[2*j],r[2*j+1]);
+  }
+
+  __m256 s[8];
+  for(size_t j = 0; j < 2; ++j) {
+    s[4*j  ] = _mm256_shuffle_ps(t[4*j  ],t[4*j+2],_MM_SHUFFLE(1,0,1,0));
+    s[4*j+1] = _mm256_shuffle_ps(t[4*j  ],t[4*j+2],_MM_SHUFFLE(3,2,3,2));
+    s[4*j+2] = _mm256_shuffle_ps(t[4*j+1],t[4*j+3],_MM_SHUFFLE(1,0,1,0));
+    s[4*j+3] = _mm256_shuffle_ps(t[4*j+1],t[4*j+3],_MM_SHUFFLE(3,2,3,2));
+  }
+
+  for(size_t i = 0; i < 4; ++i) {
+    _mm256_storeu_ps(y+ldy*i,    _mm256_permute2f128_ps(s[i],s[i+4],0x20));
+    _mm256_storeu_ps(y+ldy*(i+4),_mm256_permute2f128_ps(s[i],s[i+4],0x31));
+  }
+}
+
+/// 16x16 tile of float (AVX-512), masked shuffles are used for the same reason as __transpose_8x8_avx512
+__attribute__((target("avx512f")))
+inline void __transpose_16x16_avx512 (const float* x, size_t ldx, float* y, size_t ldy)
+{
+  const __mmask16 k = 0xffff;
+
+  __m512 r[16];
+  for(size_t j = 0; j < 16; ++j) r[j] = _mm512_loadu_ps(x+ldx*j);
+
+  // 2x2 blocks in each 128-bit lane
+  __m512 t[16];
+  for(size_t j = 0; j < 8; ++j) {
+    t[2*j  ] = _mm512_maskz_unpacklo_ps(k,r[2*j],r[2*j+1]);
+    t[2*j+1] = _mm512_maskz_unpackhi_ps(k,r[2*j],r[2*j+1]);
+  }
+
+  // 4x4 blocks in each 128-bit lane
+  __m512 s[16];
+  for(size_t j = 0; j < 4; ++j) {
+    s[4*j  ] = _mm512_maskz_shuffle_ps(k,t[4*j  ],t[4*j+2],_MM_SHUFFLE(1,0,1,0));
+    s[4*j+1] = _mm512_maskz_shuffle_ps(k,t[4*j  ],t[4*j+2],_MM_SHUFFLE(3,2,3,2));
+    s[4*j+2] = _mm512_maskz_shuffle_ps(k,t[4*j+1],t[4*j+3],_MM_SHUFFLE(1,0,1,0));
+    s[4*j+3] = _mm512_maskz_shuffle_ps(k,t[4*j+1],t[4*j+3],_MM_SHUFFLE(3,2,3,2));
+  }
+
+  // gather 128-bit lanes from 4 groups of rows
+  for(size_t i = 0; i < 4; ++i) {
+    __m512 u0 = _mm512_maskz_shuffle_f32x4(k,s[i  ],s[i+4 ],0x88);
+    __m512 u1 = _mm512_maskz_shuffle_f32x4(k,s[i  ],s[i+4 ],0xdd);
+    __m512 v0 = _mm512_maskz_shuffle_f32x4(k,s[i+8],s[i+12],0x88);
+    __m512 v1 = _mm512_maskz_shuffle_f32x4(k,s[i+8],s[i+12],0xdd);
+    _mm512_storeu_ps(y+ldy*i,     _mm512_maskz_shuffle_f32x4(k,u0,v0,0x88));
+    _mm512_storeu_ps(y+ldy*(i+4), _mm512_maskz_shuffle_f32x4(k,u1,v1,0x88));
+    _mm512_storeu_ps(y+ldy*(i+8), _mm512_maskz_shuffle_f32x4(k,u0,v0,0xdd));
+    _mm512_storeu_ps(y+ldy*(i+12),_mm512_maskz_shuffle_f32x4(k,u1,v1,0xdd));
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+/// 2x2 tile of std::complex<double> (AVX/AVX2)
+__attribute__((target("avx")))
+inline void __transpose_2x2_avx (const std::complex<double>* x, size_t ldx, std::complex<double>* y, size_t ldy)
+{
+  __m256d r0 = _mm256_loadu_pd(reinterpret_cast<const double*>(x));
+  __m256d r1 = _mm256_loadu_pd(reinterpret_cast<const double*>(x+ldx));
+
+  _mm256_storeu_pd(reinterpret_cast<double*>(y),    _mm256_permute2f128_pd(r0,r1,0x20));
+  _mm256_storeu_pd(reinterpret_cast<double*>(y+ldy),_mm256_permute2f128_pd(r0,r1,0x31));
+}
+
+/// 4x4 tile of std::complex<double> (AVX-512), masked shuffles are used for the same reason as __transpose_8x8_avx512
+__attribute__((target("avx512f")))
+inline void __transpose_4x4_avx512 (const std::complex<double>* x, size_t ldx, std::complex<double>* y, size_t ldy)
+{
+  const __mmask8 k = 0xff;
+
+  __m512d r0 = _mm512_loadu_pd(reinterpret_cast<const double*>(x));
+  __m512d r1 = _mm512_loadu_pd(reinterpret_cast<const double*>(x+ldx));
+  __m512d r2 = _mm512_loadu_pd(reinterpret_cast<const double*>(x+ldx*2));
+  __m512d r3 = _mm512_loadu_pd(reinterpret_cast<const double*>(x+ldx*3));
+
+  __m512d t0 = _mm512_maskz_shuffle_f64x2(k,r0,r1,0x88);
+  __m512d t1 = _mm512_maskz_shuffle_f64x2(k,r0,r1,0xdd);
+  __m512d t2 = _mm512_maskz_shuffle_f64x2(k,r2,r3,0x88);
+  __m512d t3 = _mm512_maskz_shuffle_f64x2(k,r2,r3,0xdd);
+
+  _mm512_storeu_pd(reinterpret_cast<double*>(y),      _mm512_maskz_shuffle_f64x2(k,t0,t2,0x88));
+  _mm512_storeu_pd(reinterpret_cast<double*>(y+ldy),  _mm512_maskz_shuffle_f64x2(k,t1,t3,0x88));
+  _mm512_storeu_pd(reinterpret_cast<double*>(y+ldy*2),_mm512_maskz_shuffle_f64x2(k,t0,t2,0xdd));
+  _mm512_storeu_pd(reinterpret_cast<double*>(y+ldy*3),_mm512_maskz_shuffle_f64x2(k,t1,t3,0xdd));
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+/// run-time dispatch for double
+template<>
+struct __transpose_kernel<double> {
+
+  typedef void (*kernel_type)(const double*, size_t, double*, size_t);
+
+  size_t size;
+
+  kernel_type call;
+
+  static const __transpose_kernel& get ()
+  {
+    static const __transpose_kernel k_ =
+      __builtin_cpu_supports("avx512f") ? __transpose_kernel { 8ul, __transpose_8x8_avx512 } :
+      __builtin_cpu_supports("avx")     ? __transpose_kernel { 4ul, __transpose_4x4_avx } :
+                                          __transpose_kernel { 0ul, nullptr };
+    return k_;
+  }
+};
+
+/// run-time dispatch for float
+template<>
+struct __transpose_kernel<float> {
+
+  typedef void (*kernel_type)(const float*, size_t, float*, size_t);
+
+  size_t size;
+
+  kernel_type call;
+
+  static const __transpose_kernel& get ()
+  {
+    static const __transpose_kernel k_ =
+      __builtin_cpu_supports("avx512f") ? __transpose_kernel { 16ul, __transpose_16x16_avx512 } :
+      __builtin_cpu_supports("avx")     ? __transpose_kernel {  8ul, __transpose_8x8_avx } :
+                                          __transpose_kernel {  0ul, nullptr };
+    return k_;
+  }
+};
+
+/// run-time dispatch for std::complex<double>
+template<>
+struct __transpose_kernel<std::complex<double>> {
+
+  typedef void (*kernel_type)(const std::complex<double>*, size_t, std::complex<double>*, size_t);
+
+  size_t size;
+
+  kernel_type call;
+
+  static const __transpose_kernel& get ()
+  {
+    static const __transpose_kernel k_ =
+      __builtin_cpu_supports("avx512f") ? __transpose_kernel { 4ul, __transpose_4x4_avx512 } :
+      __builtin_cpu_supports("avx")     ? __transpose_kernel { 2ul, __transpose_2x2_avx } :
+                                          __transpose_kernel { 0ul, nullptr };
+    return k_;
+  }
+};
+
+#endif // _BTAS_SIMD_TRANSPOSE
+
+// ----------------------------------------------------------------------------------------------------
+
+/// copy a contiguous block with an element-wise operation, op(y[j], x[j*incx])
+template<typename T, class Op_>
+void __copy_block (const T* x, size_t incx, T* y, size_t n, const Op_& op)
+{
+  for(size_t j = 0; j < n; ++j) op(y[j],x[j*incx]);
+}
+
+/// copy a contiguous block, y[j] = x[j*incx]
+template<typename T>
+void __copy_block (const T* x, size_t incx, T* y, size_t n, const __assign_op&)
+{
+  if(incx == 1)
+    std::copy(x,x+n,y);
+  else
+    for(size_t j = 0; j < n; ++j) y[j] = x[j*incx];
+}
+
+/// transpose a (np x nq) tile with an element-wise operation, op(y[i*ldy+j], x[j*ldx+i])
+template<typename T, class Op_>
+void __transpose_tile (const T* x, size_t ldx, T* y, size_t ldy, size_t np, size_t nq, const Op_& op)
+{
+  for(size_t i = 0; i < np; ++i)
+    for(size_t j = 0; j < nq; ++j) op(y[i*ldy+j],x[j*ldx+i]);
+}
+
+/// transpose a (np x nq) tile, y[i*ldy+j] = x[j*ldx+i]
+/// full (kb x kb) sub-tiles go through the micro-kernel, the remainders are copied by scalar loop
+template<typename T>
+void __transpose_tile (const T* x, size_t ldx, T* y, size_t ldy, size_t np, size_t nq, const __assign_op& = __assign_op())
+{
+  const __transpose_kernel<T>& kernel = __transpose_kernel<T>::get();
+
+  size_t pk = 0;
+  size_t qk = 0;
+  if(kernel.size > 0) {
+    const size_t kb = kernel.size;
+    pk = np/kb*kb;
+    qk = nq/kb*kb;
+    for(size_t i = 0; i < pk; i += kb)
+      for(size_t j = 0; j < qk; j += kb)
+        kernel.call(x+i+j*ldx,ldx,y+i*ldy+j,ldy);
+    // right edge of the kernel region
+    for(size_t i = 0; i < pk; ++i)
+      for(size_t j = qk; j < nq; ++j) y[i*ldy+j] = x[j*ldx+i];
+  }
+  // bottom edge (or whole tile if no kernel is available)
+  for(size_t i = pk; i < np; ++i)
+    for(size_t j = 0; j < nq; ++j) y[i*ldy+j] = x[j*ldx+i];
+}
+
+} // namespace detail
+
+} // namespace btas
+
+#endif // __BTAS_TRANSPOSE_KERNEL_HPP
@@ -1,9 +1,34 @@
 #!/bin/sh
 
+# usage: ./compile.sh test_xxx.cpp [mkl|openblas|blis|reference]
+# the executable is test_xxx.x for MKL (default), or test_xxx.<backend>.x otherwise
+
 SRC=$1
-EXE=${SRC%.*}.x
+BACKEND=${2:-mkl}
 
-#icpx -D_DEBUG -O3 -std=c++11 -DMKL_ILP64 -I. -I../include ${SRC} -o ${EXE} -qmkl-ilp64=parallel
-g++ -D_DEBUG -O3 -std=c++11 -DMKL_ILP64 -I. -I../include -I/usr/include/mkl ${SRC} -o ${EXE} -lmkl_intel_ilp64 -lmkl_intel_thread -lmkl_core -liomp5 -lpthread -lm -ldl
+case ${BACKEND} in
+mkl)
+  EXE=${SRC%.*}.x
+  #icpx -D_DEBUG -O3 -std=c++11 -qopenmp -DMKL_ILP64 -I. -I../include ${SRC} -o ${EXE} -qmkl-ilp64=parallel
+  g++ -D_DEBUG -O3 -std=c++11 -fopenmp -DMKL_ILP64 -I. -I../include -I/usr/include/mkl ${SRC} -o ${EXE} -lmkl_intel_ilp64 -lmkl_gnu_thread -lmkl_core -lgomp -lpthread -lm -ldl
+  ;;
+openblas)
+  EXE=${SRC%.*}.openblas.x
+  g++ -D_DEBUG -O3 -std=c++11 -fopenmp -D_BTAS_USE_OPENBLAS -I. -I../include ${SRC} -o ${EXE} -lopenblas -llapacke -lgomp -lpthread -lm
+  ;;
+blis)
+  # BLIS built w/ --enable-cblas, and libflame (e.g. AMD AOCL) w/ LAPACKE
+  EXE=${SRC%.*}.blis.x
+  g++ -D_DEBUG -O3 -std=c++11 -fopenmp -D_BTAS_USE_BLIS -I. -I../include -I/usr/include/blis ${SRC} -o ${EXE} -lflame -lblis-mt -lgomp -lpthread -lm
+  ;;
+reference)
+  EXE=${SRC%.*}.reference.x
+  g++ -D_DEBUG -O3 -std=c++11 -fopenmp -D_BTAS_USE_REFERENCE -I. -I../include ${SRC} -o ${EXE} -llapacke -llapack -lcblas -lblas -lgfortran -lm
+  ;;
+*)
+  echo "unknown backend: ${BACKEND} (mkl, openblas, blis or reference)"
+  exit 1
+  ;;
+esac
 
 #
@@ -0,0 +1,18 @@
+#ifndef __BTAS_MAX_DIFF_H_INCLUDED
+#define __BTAS_MAX_DIFF_H_INCLUDED
+
+#include <cmath>
+#include <complex>
+#include <algorithm>
+
+/// max. abs. difference between two tensors, HUGE_VAL if their sizes differ
+template<class TensorX, class TensorY>
+double max_diff (const TensorX& x, const TensorY& y)
+{
+  if(x.size() != y.size()) return HUGE_VAL;
+  double diff = 0.0;
+  for(size_t i = 0; i < x.size(); ++i) diff = std::max(diff,static_cast<double>(std::abs(x.data()[i]-y.data()[i])));
+  return diff;
+}
+
+#endif // __BTAS_MAX_DIFF_H_INCLUDED
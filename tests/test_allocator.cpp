@@ -0,0 +1,161 @@
+#include <iostream>
+#include <iomanip>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <functional>
+#include <limits>
+#include <algorithm>
+
+#include <btas.h>
+#include <max_diff.h>
+#include <time_stamp.h>
+
+/// allocator which gives memory filled by NaN, to emulate stale memory reused by resize_uninitialized
+template<typename T>
+struct stale_allocator : public std::allocator<T> {
+  template<typename U> struct rebind { typedef stale_allocator<U> other; };
+  stale_allocator () noexcept { }
+  template<typename U>
+  stale_allocator (const stale_allocator<U>&) noexcept { }
+  T* allocate (size_t n)
+  {
+    T* p = std::allocator<T>::allocate(n);
+    std::fill(p,p+n,std::numeric_limits<T>::quiet_NaN());
+    return p;
+  }
+};
+
+/// outer product into an empty c (K = 0, i.e. GER), which must not be read since beta = 0
+template<typename T>
+size_t count_nan_outer_product ()
+{
+  using namespace btas;
+  Tensor<T,1> a(shape(6)); a.fill(static_cast<T>(1));
+  Tensor<T,1> b(shape(10)); b.fill(static_cast<T>(2));
+  Tensor<T,2,CblasRowMajor,stale_allocator<T>> c;
+  contract(static_cast<T>(1),a,std::array<size_t,0>(),b,std::array<size_t,0>(),static_cast<T>(0),c);
+  size_t nnan = 0;
+  for(size_t i = 0; i < c.size(); ++i) if(std::isnan(c.data()[i]) || c.data()[i] != static_cast<T>(2)) ++nnan;
+  return nnan;
+}
+
+/// permute and contract tensors w/ Allocator, and compare to those w/ std::allocator
+/// X and Y are larger than a huge page (2 MB), so that huge_page_allocator aligns them to huge pages
+template<class Allocator>
+void check (const char* name, size_t align, std::mt19937& rGen)
+{
+  using namespace btas;
+
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+
+  Tensor<double,3,CblasRowMajor,Allocator> X(60,70,80); X.generate(std::bind(dist,rGen));
+  Tensor<double,3> Xref(X);
+
+  // Y(j,k,i) = X(i,j,k)
+  Tensor<double,3,CblasRowMajor,Allocator> Y;
+  permute(X,shape(1,2,0),Y);
+
+  Tensor<double,3> Yref;
+  permute(Xref,shape(1,2,0),Yref);
+
+  // Z(i,l) = X(i,j,k) * W(j,k,l)
+  Tensor<double,3,CblasRowMajor,Allocator> W(70,80,10); W.generate(std::bind(dist,rGen));
+  Tensor<double,3> Wref(W);
+
+  Tensor<double,2,CblasRowMajor,Allocator> Z;
+  contract(1.0,X,make_array('i','j','k'),W,make_array('j','k','l'),0.0,Z,make_array('i','l'));
+
+  Tensor<double,2> Zref;
+  contract(1.0,Xref,make_array('i','j','k'),Wref,make_array('j','k','l'),0.0,Zref,make_array('i','l'));
+
+  const bool aligned = (reinterpret_cast<std::uintptr_t>(X.data())%align == 0)
+                    && (reinterpret_cast<std::uintptr_t>(Y.data())%align == 0);
+
+  std::cout << std::setw(28) << std::left << name << " : aligned to " << std::setw(7) << align << " " << (aligned ? "yes" : "no ")
+            << ", permute " << max_diff(Y,Yref) << ", contract " << max_diff(Z,Zref) << std::endl;
+}
+
+int main ()
+{
+  using namespace btas;
+
+  std::mt19937 rGen;
+
+  std::cout.setf(std::ios::scientific,std::ios::floatfield);
+  std::cout.precision(2);
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "Tensor<T,N,Layout,Allocator>                      " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  check<aligned_allocator<double>>("aligned_allocator",64,rGen);
+  check<aligned_allocator<double,4096>>("aligned_allocator (4096)",4096,rGen);
+  check<huge_page_allocator<double>>("huge_page_allocator",_BTAS_HUGE_PAGE_SIZE,rGen);
+  check<first_touch_allocator<double>>("first_touch_allocator",_BTAS_PAGE_SIZE,rGen);
+  check<numa_interleave_allocator<double>>("numa_interleave_allocator",_BTAS_PAGE_SIZE,rGen);
+
+  // copy between different allocators and dynamic rank
+  {
+    Tensor<double,0,CblasRowMajor,aligned_allocator<double>> A(std::vector<size_t>{3,4,5}); A.fill(2.0);
+    Tensor<double,0> B(A);
+    Tensor<double,0,CblasRowMajor,huge_page_allocator<double>> C; C = B;
+    std::cout << "copy (dynamic rank)          : " << max_diff(A,C) << std::endl;
+  }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "resize vs resize_uninitialized                    " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  {
+    // initialized data are kept by resize_uninitialized w/o reallocation, and zeroed by resize
+    Tensor<double,2> A(10,10); A.fill(1.0);
+    A.resize_uninitialized(shape(5,20));
+    double s = 0.0; for(size_t i = 0; i < A.size(); ++i) s += A.data()[i];
+    Tensor<double,2> B; B.resize(shape(10,10));
+    double t = 0.0; for(size_t i = 0; i < B.size(); ++i) t += std::fabs(B.data()[i]);
+    std::cout << "kept " << s << " (100), zero " << t << std::endl;
+  }
+
+  std::cout << "outer product into stale memory : wrong elements, double " << count_nan_outer_product<double>()
+            << ", long double " << count_nan_outer_product<long double>() << " (of 60)" << std::endl;
+
+  std::cout.setf(std::ios::fixed,std::ios::floatfield);
+  std::cout.precision(6);
+
+  const size_t n = 1ul << 12; // 128 MB of double
+  const size_t nrep = 5;
+
+  time_stamp ts;
+
+  for(size_t r = 0; r < nrep; ++r) { Tensor<double,2> A; A.resize(shape(n,n)); }
+
+  double t_init = ts.lap()/nrep;
+
+  for(size_t r = 0; r < nrep; ++r) { Tensor<double,2> A; A.resize_uninitialized(shape(n,n)); }
+
+  double t_uninit = ts.lap()/nrep;
+
+  // transpose into a fresh tensor, which is written first by the permutation threads
+  Tensor<double,2> X(n,n); X.fill(1.0);
+
+  ts.lap();
+
+  for(size_t r = 0; r < nrep; ++r) { Tensor<double,2> Y; Y.resize(shape(n,n)); permute(X,shape(1,0),Y); }
+
+  double t_pinit = ts.lap()/nrep;
+
+  for(size_t r = 0; r < nrep; ++r) { Tensor<double,2> Y; permute(X,shape(1,0),Y); }
+
+  double t_puninit = ts.lap()/nrep;
+
+  std::cout << "resize   (" << n << " x " << n << ") : initialized " << t_init << ", uninitialized " << t_uninit << std::endl;
+  std::cout << "permute  (" << n << " x " << n << ") : initialized " << t_pinit << ", uninitialized " << t_puninit << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,505 @@
+#include <iostream>
+#include <iomanip>
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <functional>
+
+#include <btas.h>
+#include <max_diff.h>
+
+/// complex conjugate of a tensor
+template<class TensorX>
+TensorX conj_copy (const TensorX& x)
+{
+  TensorX y(x);
+  for(size_t i = 0; i < y.size(); ++i) y.data()[i] = std::conj(y.data()[i]);
+  return y;
+}
+
+int main ()
+{
+  using namespace btas;
+
+  std::mt19937 rGen;
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+
+  std::cout.setf(std::ios::scientific,std::ios::floatfield);
+  std::cout.precision(2);
+
+  // ----------------------------------------------------------------------------------------------------
+
+  Tensor<double,4> X(6,7,8,9);
+  X.generate(std::bind(dist,rGen));
+
+  Tensor<double,4> Y(8,6,9,7);
+  Y.generate(std::bind(dist,rGen));
+
+  Tensor<double,4> Yref(Y);
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "permute_axpby(alpha,X,idx,beta,Y)                 " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  std::vector<size_t> idx = { 2, 0, 3, 1 };
+
+  permute_axpby(2.0,X,idx,0.5,Y);
+
+  for(size_t i = 0; i < 8; ++i)
+    for(size_t j = 0; j < 6; ++j)
+      for(size_t k = 0; k < 9; ++k)
+        for(size_t l = 0; l < 7; ++l)
+          Yref(i,j,k,l) = 2.0*X(j,l,i,k)+0.5*Yref(i,j,k,l);
+
+  std::cout << "Tensor     : " << max_diff(Y,Yref) << std::endl;
+
+  // permute from a view (slice), X[1:4,2:6,0:7,3:8]
+  Tensor<double,4> Z(8,4,6,5);
+  Z.generate(std::bind(dist,rGen));
+
+  Tensor<double,4> Zref(Z);
+
+  TensorView<const double*,4> V(X.data()+X.ordinal(shape(1,2,0,3)),shape(4,5,8,6),X.stride());
+  permute_axpby(-1.0,V,idx,1.0,Z);
+
+  for(size_t i = 0; i < 8; ++i)
+    for(size_t j = 0; j < 4; ++j)
+      for(size_t k = 0; k < 6; ++k)
+        for(size_t l = 0; l < 5; ++l)
+          Zref(i,j,k,l) -= X(j+1,l+2,i,k+3);
+
+  std::cout << "TensorView : " << max_diff(Z,Zref) << std::endl;
+
+  // ----------------------------------------------------------------------------------------------------
+
+  Tensor<double,4> A(6,5,7,4);
+  A.generate(std::bind(dist,rGen));
+
+  Tensor<double,3> B(4,3,5);
+  B.generate(std::bind(dist,rGen));
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "contract(alpha,A,symba,B,symbb,beta,C,symbc)      " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  // C(i,j,k) = A(i,p,j,q) * B(q,k,p), no permutation of C
+  Tensor<double,3> C;
+  contract(1.0,A,make_array('i','p','j','q'),B,make_array('q','k','p'),0.0,C,make_array('i','j','k'));
+
+  Tensor<double,3> Cref(6,7,3); Cref.fill(0.0);
+  for(size_t i = 0; i < 6; ++i)
+    for(size_t j = 0; j < 7; ++j)
+      for(size_t k = 0; k < 3; ++k)
+        for(size_t p = 0; p < 5; ++p)
+          for(size_t q = 0; q < 4; ++q)
+            Cref(i,j,k) += A(i,p,j,q)*B(q,k,p);
+
+  std::cout << "C(i,j,k) : " << max_diff(C,Cref) << std::endl;
+
+  // D(k,i,j) = 2 * A(i,p,j,q) * B(q,k,p) + 0.5 * D(k,i,j), C is permuted and accumulated by permute_axpby
+  Tensor<double,3> D(3,6,7);
+  D.generate(std::bind(dist,rGen));
+
+  Tensor<double,3> Dref(D);
+  for(size_t i = 0; i < 6; ++i)
+    for(size_t j = 0; j < 7; ++j)
+      for(size_t k = 0; k < 3; ++k)
+        Dref(k,i,j) = 2.0*Cref(i,j,k)+0.5*Dref(k,i,j);
+
+  contract(2.0,A,make_array('i','p','j','q'),B,make_array('q','k','p'),0.5,D,make_array('k','i','j'));
+
+  std::cout << "D(k,i,j) : " << max_diff(D,Dref) << std::endl;
+
+  // E(j,i) = A(i,p,j,q) * F(p,q), GEMV case
+  Tensor<double,2> F(5,4);
+  F.generate(std::bind(dist,rGen));
+
+  Tensor<double,2> E;
+  contract(1.0,A,make_array('i','p','j','q'),F,make_array('p','q'),0.0,E,make_array('j','i'));
+
+  Tensor<double,2> Eref(7,6); Eref.fill(0.0);
+  for(size_t i = 0; i < 6; ++i)
+    for(size_t j = 0; j < 7; ++j)
+      for(size_t p = 0; p < 5; ++p)
+        for(size_t q = 0; q < 4; ++q)
+          Eref(j,i) += A(i,p,j,q)*F(p,q);
+
+  std::cout << "E(j,i)   : " << max_diff(E,Eref) << std::endl;
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "contract by strided batch of GEMMs                " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  // G(i,k,j,m) = P(i,k,j,l) * Q(l,m), batch over (i,k)
+  Tensor<double,4> P(40,30,64,48);
+  P.generate(std::bind(dist,rGen));
+
+  Tensor<double,2> Q(64,56);
+  Q.generate(std::bind(dist,rGen));
+
+  Tensor<double,4> G;
+  contract(1.0,P,make_array('i','k','l','j'),Q,make_array('l','m'),0.0,G,make_array('i','k','j','m'));
+
+  Tensor<double,4> Gref(40,30,48,56); Gref.fill(0.0);
+  for(size_t i = 0; i < 40; ++i)
+    for(size_t k = 0; k < 30; ++k)
+      for(size_t j = 0; j < 48; ++j)
+        for(size_t m = 0; m < 56; ++m)
+          for(size_t l = 0; l < 64; ++l)
+            Gref(i,k,j,m) += P(i,k,l,j)*Q(l,m);
+
+  contract_batch_helper<CblasRowMajor> helperG(P.extent(),shape(2),Q.extent(),shape(0),sizeof(double));
+  std::cout << "G(i,k,j,m) : " << max_diff(G,Gref) << " batched " << (helperG.enabled() ? "yes" : "no")
+            << " (cost " << helperG.cost() << " vs " << helperG.cost_permute() << ")" << std::endl;
+
+  // H(i,j,m) = R(i,k,j,l) * S(k,l,m), one free index interleaved, permutation is needed
+  Tensor<double,4> R(12,10,14,8);
+  R.generate(std::bind(dist,rGen));
+
+  Tensor<double,3> S(10,8,9);
+  S.generate(std::bind(dist,rGen));
+
+  Tensor<double,3> H;
+  contract(1.0,R,make_array('i','k','j','l'),S,make_array('k','l','m'),0.0,H,make_array('i','j','m'));
+
+  Tensor<double,3> Href(12,14,9); Href.fill(0.0);
+  for(size_t i = 0; i < 12; ++i)
+    for(size_t j = 0; j < 14; ++j)
+      for(size_t m = 0; m < 9; ++m)
+        for(size_t k = 0; k < 10; ++k)
+          for(size_t l = 0; l < 8; ++l)
+            Href(i,j,m) += R(i,k,j,l)*S(k,l,m);
+
+  contract_batch_helper<CblasRowMajor> helperH(R.extent(),shape(1,3),S.extent(),shape(0,1),sizeof(double));
+  std::cout << "H(i,j,m)   : " << max_diff(H,Href) << " batched " << (helperH.enabled() ? "yes" : "no") << std::endl;
+
+  // col-major: W(j,i,m) = Uc(j,l,i) * Vc(l,m), batch over i
+  Tensor<double,3,CblasColMajor> Uc(48,64,40);
+  Uc.generate(std::bind(dist,rGen));
+
+  Tensor<double,2,CblasColMajor> Vc(64,56);
+  Vc.generate(std::bind(dist,rGen));
+
+  Tensor<double,3,CblasColMajor> W;
+  contract(1.0,Uc,make_array('j','l','i'),Vc,make_array('l','m'),0.0,W,make_array('j','i','m'));
+
+  Tensor<double,3,CblasColMajor> Wref(48,40,56); Wref.fill(0.0);
+  for(size_t j = 0; j < 48; ++j)
+    for(size_t i = 0; i < 40; ++i)
+      for(size_t m = 0; m < 56; ++m)
+        for(size_t l = 0; l < 64; ++l)
+          Wref(j,i,m) += Uc(j,l,i)*Vc(l,m);
+
+  contract_batch_helper<CblasColMajor> helperW(Uc.extent(),shape(1),Vc.extent(),shape(0),sizeof(double));
+  std::cout << "W(j,i,m)   : " << max_diff(W,Wref) << " batched " << (helperW.enabled() ? "yes" : "no") << std::endl;
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "ContractPlan : repeated contraction of D(k,i,j)   " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  ContractPlan<double,4,3,3> planD(A.extent(),make_array('i','p','j','q'),B.extent(),make_array('q','k','p'),make_array('k','i','j'));
+
+  std::vector<double> work(planD.workspace_size());
+
+  Tensor<double,3> Dp(planD.extent_c()); Dp.fill(0.0);
+  Tensor<double,3> Dc(planD.extent_c()); Dc.fill(0.0);
+  for(size_t iter = 0; iter < 4; ++iter) {
+    planD.execute(1.0,A,B,0.5,Dp,work.data());
+    contract(1.0,A,make_array('i','p','j','q'),B,make_array('q','k','p'),0.5,Dc,make_array('k','i','j'));
+  }
+
+  std::cout << "D(k,i,j) : " << max_diff(Dp,Dc) << " workspace " << planD.workspace_size()
+            << " permuted (" << planD.is_a_permuted() << "," << planD.is_b_permuted() << "," << planD.is_c_permuted() << ")" << std::endl;
+
+  const ContractPlan<double,4,2,4>& planG = ContractPlan<double,4,2,4>::get(P.extent(),make_array('i','k','l','j'),Q.extent(),make_array('l','m'),make_array('i','k','j','m'));
+  const ContractPlan<double,4,2,4>& planG2 = ContractPlan<double,4,2,4>::get(P.extent(),make_array('i','k','l','j'),Q.extent(),make_array('l','m'),make_array('i','k','j','m'));
+
+  Tensor<double,4> Gp;
+  planG.execute(1.0,P,Q,0.0,Gp);
+
+  std::cout << "G(i,k,j,m) : " << max_diff(Gp,Gref) << " batched " << (planG.is_batched() ? "yes" : "no")
+            << " cached " << (&planG == &planG2 ? "yes" : "no") << std::endl;
+
+  // cached plans are released, and created again
+  ContractPlan<double,4,2,4>::clear_cache();
+  ContractPlan<double,4,2,4>::get(P.extent(),make_array('i','k','l','j'),Q.extent(),make_array('l','m'),make_array('i','k','j','m')).execute(1.0,P,Q,0.0,Gp);
+
+  std::cout << "G(i,k,j,m) : " << max_diff(Gp,Gref) << " after clear_cache" << std::endl;
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "make_contract_layout : operand to be permuted     " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  // J(i,j) = S(i,k,l) * T(l,k,j), small S is permuted rather than large T
+  Tensor<double,3> Sm(4,30,40); Sm.generate(std::bind(dist,rGen));
+  Tensor<double,3> Tl(40,30,500); Tl.generate(std::bind(dist,rGen));
+
+  Tensor<double,2> J;
+  contract(1.0,Sm,shape(1,2),Tl,shape(1,0),0.0,J);
+
+  Tensor<double,2> Jref(4,500); Jref.fill(0.0);
+  for(size_t i = 0; i < 4; ++i)
+    for(size_t j = 0; j < 500; ++j)
+      for(size_t k = 0; k < 30; ++k)
+        for(size_t l = 0; l < 40; ++l)
+          Jref(i,j) += Sm(i,k,l)*Tl(l,k,j);
+
+  ContractPlan<double,3,3,2> planJ(Sm.extent(),make_array('i','k','l'),Tl.extent(),make_array('l','k','j'),make_array('i','j'));
+  std::cout << "J(i,j)   : " << max_diff(J,Jref) << " " << planJ.layout() << std::endl;
+
+  // K(j,i,m) = U(i,j,p) * V(p,m), U is permuted rather than K, which is larger
+  Tensor<double,3> Us(20,30,4); Us.generate(std::bind(dist,rGen));
+  Tensor<double,2> Vs(4,100); Vs.generate(std::bind(dist,rGen));
+
+  Tensor<double,3> Ks;
+  contract(1.0,Us,make_array('i','j','p'),Vs,make_array('p','m'),0.0,Ks,make_array('j','i','m'));
+
+  Tensor<double,3> Ksref(30,20,100); Ksref.fill(0.0);
+  for(size_t i = 0; i < 20; ++i)
+    for(size_t j = 0; j < 30; ++j)
+      for(size_t m = 0; m < 100; ++m)
+        for(size_t p = 0; p < 4; ++p)
+          Ksref(j,i,m) += Us(i,j,p)*Vs(p,m);
+
+  ContractPlan<double,3,2,3> planK(Us.extent(),make_array('i','j','p'),Vs.extent(),make_array('p','m'),make_array('j','i','m'));
+  std::cout << "K(j,i,m) : " << max_diff(Ks,Ksref) << " " << planK.layout() << std::endl;
+
+  // M(m,i,j) = U(i,j,p) * V(p,m), free indices of V come first, written as (V^T * U^T)^T w/o permutation
+  Tensor<double,3> Ms;
+  contract(1.0,Us,make_array('i','j','p'),Vs,make_array('p','m'),0.0,Ms,make_array('m','i','j'));
+
+  Tensor<double,3> Msref(100,20,30);
+  for(size_t i = 0; i < 20; ++i)
+    for(size_t j = 0; j < 30; ++j)
+      for(size_t m = 0; m < 100; ++m)
+        Msref(m,i,j) = Ksref(j,i,m);
+
+  ContractPlan<double,3,2,3> planM(Us.extent(),make_array('i','j','p'),Vs.extent(),make_array('p','m'),make_array('m','i','j'));
+  std::cout << "M(m,i,j) : " << max_diff(Ms,Msref) << " " << planM.layout() << std::endl;
+
+  // col-major, W(m,j,i) = Uc(j,l,i) * Vc(l,m)
+  Tensor<double,3,CblasColMajor> Wm;
+  contract(1.0,Uc,make_array('j','l','i'),Vc,make_array('l','m'),0.0,Wm,make_array('m','j','i'));
+
+  double diffWm = 0.0;
+  for(size_t j = 0; j < 48; ++j)
+    for(size_t i = 0; i < 40; ++i)
+      for(size_t m = 0; m < 56; ++m)
+        diffWm = std::max(diffWm,std::fabs(Wm(m,j,i)-Wref(j,i,m)));
+
+  ContractPlan<double,3,2,3,CblasColMajor> planWm(Uc.extent(),make_array('j','l','i'),Vc.extent(),make_array('l','m'),make_array('m','j','i'));
+  std::cout << "W(m,j,i) : " << diffWm << " " << planWm.layout() << std::endl;
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "contract with symbols given at compile time       " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  // C(i,j,k) = A(i,p,j,q) * B(q,k,p), permutation of A and B is needed
+  Tensor<double,3> Cs;
+  contract(1.0,A,symbols<'i','p','j','q'>(),B,symbols<'q','k','p'>(),0.0,Cs,symbols<'i','j','k'>());
+
+  std::cout << "C(i,j,k) : " << max_diff(Cs,Cref) << std::endl;
+
+  // D(k,i,j) = 2 * A(i,p,j,q) * B(q,k,p) + 0.5 * D(k,i,j)
+  Tensor<double,3> Ds(3,6,7);
+  Ds.generate(std::bind(dist,rGen));
+  Tensor<double,3> Dsref(Ds);
+  contract(2.0,A,make_array('i','p','j','q'),B,make_array('q','k','p'),0.5,Dsref,make_array('k','i','j'));
+  contract(2.0,A,symbols<'i','p','j','q'>(),B,symbols<'q','k','p'>(),0.5,Ds,symbols<'k','i','j'>());
+
+  std::cout << "D(k,i,j) : " << max_diff(Ds,Dsref) << std::endl;
+
+  // E(i,j) = X(l,k,i) * Y(j,l,k), matrix form with trans flags, GEMM is called directly
+  typedef contract_symbols<symbols<'l','k','i'>,symbols<'j','l','k'>,symbols<'i','j'>> infoE;
+
+  Tensor<double,3> Xs(8,6,5); Xs.generate(std::bind(dist,rGen));
+  Tensor<double,3> Ys(7,8,6); Ys.generate(std::bind(dist,rGen));
+
+  Tensor<double,2> Es;
+  contract(1.0,Xs,symbols<'l','k','i'>(),Ys,symbols<'j','l','k'>(),0.0,Es,symbols<'i','j'>());
+
+  Tensor<double,2> Esref(5,7); Esref.fill(0.0);
+  for(size_t i = 0; i < 5; ++i)
+    for(size_t j = 0; j < 7; ++j)
+      for(size_t l = 0; l < 8; ++l)
+        for(size_t k = 0; k < 6; ++k)
+          Esref(i,j) += Xs(l,k,i)*Ys(j,l,k);
+
+  std::cout << "E(i,j)   : " << max_diff(Es,Esref) << " matrix " << (infoE::is_matrix ? "yes" : "no")
+            << " (" << (infoE::transa == CblasTrans ? "T" : "N") << "," << (infoE::transb == CblasTrans ? "T" : "N") << ")" << std::endl;
+
+  // F(j,i) = X(l,k,i) * Y(j,l,k), written as (Y^T * X^T)^T
+  Tensor<double,2> Fs;
+  contract(1.0,Xs,symbols<'l','k','i'>(),Ys,symbols<'j','l','k'>(),0.0,Fs,symbols<'j','i'>());
+
+  Tensor<double,2> Fsref;
+  permute(Esref,shape(1,0),Fsref);
+
+  std::cout << "F(j,i)   : " << max_diff(Fs,Fsref) << " swapped "
+            << (contract_symbols<symbols<'l','k','i'>,symbols<'j','l','k'>,symbols<'j','i'>>::is_c_swapped ? "yes" : "no") << std::endl;
+
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "contract with batch indices kept in c             " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  // P(i,j,k) = X(i,j,l) * Y(i,l,k), strided batch over i
+  Tensor<double,3> Xh(10,6,8); Xh.generate(std::bind(dist,rGen));
+  Tensor<double,3> Yh(10,8,7); Yh.generate(std::bind(dist,rGen));
+
+  Tensor<double,3> Ph;
+  contract(1.0,Xh,make_array('i','j','l'),Yh,make_array('i','l','k'),0.0,Ph,make_array('i','j','k'));
+
+  Tensor<double,3> Phref(10,6,7); Phref.fill(0.0);
+  for(size_t i = 0; i < 10; ++i)
+    for(size_t j = 0; j < 6; ++j)
+      for(size_t k = 0; k < 7; ++k)
+        for(size_t l = 0; l < 8; ++l)
+          Phref(i,j,k) += Xh(i,j,l)*Yh(i,l,k);
+
+  ContractPlan<double,3,3,3> planP(Xh.extent(),make_array('i','j','l'),Yh.extent(),make_array('i','l','k'),make_array('i','j','k'));
+
+  std::cout << "P(i,j,k) : " << max_diff(Ph,Phref) << " " << planP.kernel() << " " << planP.layout() << std::endl;
+
+  // Q(j,i,k) = X(i,j,l) * Y(i,l,k), batch index i is in the middle of Q, which is still strided w/o permutation
+  Tensor<double,3> Qh;
+  contract(1.0,Xh,symbols<'i','j','l'>(),Yh,symbols<'i','l','k'>(),0.0,Qh,symbols<'j','i','k'>());
+
+  Tensor<double,3> Qhref;
+  permute(Phref,shape(1,0,2),Qhref);
+
+  ContractPlan<double,3,3,3> planQ(Xh.extent(),make_array('i','j','l'),Yh.extent(),make_array('i','l','k'),make_array('j','i','k'));
+
+  std::cout << "Q(j,i,k) : " << max_diff(Qh,Qhref) << " " << planQ.kernel() << " " << planQ.layout() << std::endl;
+
+  // S(i,m,j,k) = U(i,m,j,l) * V(m,i,l,k), batch indices (i,m) are not fused in V, i.e. a loop of GEMMs on views
+  Tensor<double,4> Uh(4,3,6,8); Uh.generate(std::bind(dist,rGen));
+  Tensor<double,4> Vh(3,4,8,7); Vh.generate(std::bind(dist,rGen));
+
+  Tensor<double,4> Sh;
+  contract(1.0,Uh,make_array('i','m','j','l'),Vh,make_array('m','i','l','k'),0.0,Sh,make_array('i','m','j','k'));
+
+  Tensor<double,4> Shref(4,3,6,7); Shref.fill(0.0);
+  for(size_t i = 0; i < 4; ++i)
+    for(size_t m = 0; m < 3; ++m)
+      for(size_t j = 0; j < 6; ++j)
+        for(size_t k = 0; k < 7; ++k)
+          for(size_t l = 0; l < 8; ++l)
+            Shref(i,m,j,k) += Uh(i,m,j,l)*Vh(m,i,l,k);
+
+  ContractPlan<double,4,4,4> planS(Uh.extent(),make_array('i','m','j','l'),Vh.extent(),make_array('m','i','l','k'),make_array('i','m','j','k'));
+
+  std::cout << "S(i,m,j,k) : " << max_diff(Sh,Shref) << " " << planS.kernel() << " " << planS.layout() << std::endl;
+
+  // R(i) = X(i,j,l) * Z(i,j,l), i.e. batch of dots, col-major
+  Tensor<double,3,CblasColMajor> Xc(5,6,8); Xc.generate(std::bind(dist,rGen));
+  Tensor<double,3,CblasColMajor> Zc(6,8,5); Zc.generate(std::bind(dist,rGen));
+
+  Tensor<double,1,CblasColMajor> Rc;
+  contract(2.0,Xc,make_array('i','j','l'),Zc,make_array('j','l','i'),0.0,Rc,make_array('i'));
+
+  double diffR = 0.0;
+  for(size_t i = 0; i < 5; ++i) {
+    double r = 0.0;
+    for(size_t j = 0; j < 6; ++j)
+      for(size_t l = 0; l < 8; ++l)
+        r += 2.0*Xc(i,j,l)*Zc(j,l,i);
+    diffR = std::max(diffR,std::fabs(Rc(i)-r));
+  }
+
+  std::cout << "R(i)     : " << diffR << std::endl;
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "contract with conjugation of a and/or b           " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  typedef std::complex<double> dcomplex;
+
+  auto zgen = [&dist,&rGen] () { return dcomplex(dist(rGen),dist(rGen)); };
+
+  const dcomplex zone(1.0,0.0);
+  const dcomplex zzero(0.0,0.0);
+
+  // Hermitian product, A(i,j) = conj(U(k,i)) * V(k,j), a is transposed, i.e. CblasConjTrans
+  Tensor<dcomplex,2> Uz(9,6); Uz.generate(zgen);
+  Tensor<dcomplex,2> Vz(9,7); Vz.generate(zgen);
+  Tensor<dcomplex,2> Uzc = conj_copy(Uz);
+
+  Tensor<dcomplex,2> Az;
+  contract(zone,Uz,make_array('k','i'),Vz,make_array('k','j'),zzero,Az,make_array('i','j'),ConjA);
+
+  Tensor<dcomplex,2> Azref;
+  contract(zone,Uzc,make_array('k','i'),Vz,make_array('k','j'),zzero,Azref,make_array('i','j'));
+
+  ContractPlan<dcomplex,2,2,2> planAz(Uz.extent(),make_array('k','i'),Vz.extent(),make_array('k','j'),make_array('i','j'),ConjA);
+
+  std::cout << "A(i,j)     : " << max_diff(Az,Azref) << " conj in workspace " << (planAz.is_a_conj() ? "yes" : "no") << std::endl;
+
+  // same by symbols at compile time, which calls GEMM directly
+  Tensor<dcomplex,2> Azs;
+  contract(zone,Uz,symbols<'k','i'>(),Vz,symbols<'k','j'>(),zzero,Azs,symbols<'i','j'>(),ConjA);
+
+  std::cout << "A(i,j)     : " << max_diff(Azs,Azref) << " (symbols)" << std::endl;
+
+  // B(i,j) = conj(W(i,k)) * conj(V(k,j)), neither is transposed, i.e. both are conjugated in workspace
+  Tensor<dcomplex,2> Wz(6,9); Wz.generate(zgen);
+  Tensor<dcomplex,2> Vzc = conj_copy(Vz);
+
+  Tensor<dcomplex,2> Bz;
+  contract(zone,Wz,symbols<'i','k'>(),Vz,symbols<'k','j'>(),zzero,Bz,symbols<'i','j'>(),ConjAB);
+
+  Tensor<dcomplex,2> Bzref;
+  contract(zone,conj_copy(Wz),make_array('i','k'),Vzc,make_array('k','j'),zzero,Bzref,make_array('i','j'));
+
+  std::cout << "B(i,j)     : " << max_diff(Bz,Bzref) << std::endl;
+
+  // C(i,j,m) = X(k,i,l) * conj(Y(j,l,k,m)), b is permuted and conjugated at once
+  Tensor<dcomplex,3> Xz(5,4,6); Xz.generate(zgen);
+  Tensor<dcomplex,4> Yz(3,6,5,7); Yz.generate(zgen);
+
+  Tensor<dcomplex,3> Cz;
+  contract(zone,Xz,make_array('k','i','l'),Yz,make_array('j','l','k','m'),zzero,Cz,make_array('i','j','m'),ConjB);
+
+  Tensor<dcomplex,3> Czref;
+  contract(zone,Xz,make_array('k','i','l'),conj_copy(Yz),make_array('j','l','k','m'),zzero,Czref,make_array('i','j','m'));
+
+  ContractPlan<dcomplex,3,4,3> planCz(Xz.extent(),make_array('k','i','l'),Yz.extent(),make_array('j','l','k','m'),make_array('i','j','m'),ConjB);
+
+  std::cout << "C(i,j,m)   : " << max_diff(Cz,Czref) << " " << planCz.kernel() << " " << planCz.layout() << std::endl;
+
+  // D(i,j,k) = conj(X(i,l,j)) * Y(i,l,k), batch index i
+  Tensor<dcomplex,3> Xhz(8,5,6); Xhz.generate(zgen);
+  Tensor<dcomplex,3> Yhz(8,5,7); Yhz.generate(zgen);
+
+  Tensor<dcomplex,3> Dz;
+  contract(zone,Xhz,make_array('i','l','j'),Yhz,make_array('i','l','k'),zzero,Dz,make_array('i','j','k'),ConjA);
+
+  Tensor<dcomplex,3> Dzref;
+  contract(zone,conj_copy(Xhz),make_array('i','l','j'),Yhz,make_array('i','l','k'),zzero,Dzref,make_array('i','j','k'));
+
+  std::cout << "D(i,j,k)   : " << max_diff(Dz,Dzref) << std::endl;
+
+  // overlap, s = conj(X(k,i,l)) * X(k,i,l) of dynamic rank, i.e. DOT w/ a conjugated in workspace
+  Tensor<dcomplex,0> Xdz(std::vector<size_t>{5,4,6});
+  std::copy(Xz.data(),Xz.data()+Xz.size(),Xdz.data());
+
+  Tensor<dcomplex,0> Sz;
+  contract(zone,Xdz,make_array('k','i','l'),Xdz,make_array('k','i','l'),zzero,Sz,std::vector<char>(),ConjA);
+
+  std::cout << "s          : " << std::abs(Sz.data()[0]-dotc(Xz,Xz)) << " imag " << std::abs(Sz.data()[0].imag()) << std::endl;
+
+  return 0;
+}
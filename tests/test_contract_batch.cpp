@@ -0,0 +1,126 @@
+#include <iostream>
+#include <iomanip>
+
+#include <cmath>
+#include <random>
+#include <functional>
+
+#include <btas.h>
+#include <time_stamp.h>
+
+/// max. abs. difference between two lists of tensors
+template<class TensorX, class TensorY>
+double max_diff (const std::vector<TensorX>& x, const std::vector<TensorY>& y)
+{
+  double diff = 0.0;
+  for(size_t k = 0; k < x.size(); ++k)
+    for(size_t i = 0; i < x[k].size(); ++i) diff = std::max(diff,std::fabs(x[k].data()[i]-y[k].data()[i]));
+  return diff;
+}
+
+int main ()
+{
+  using namespace btas;
+
+  std::mt19937 rGen;
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+
+  std::cout.setf(std::ios::scientific,std::ios::floatfield);
+  std::cout.precision(2);
+
+  // block sizes of a block-sparse tensor
+  const size_t dims[] = { 4, 8, 12, 16, 24, 32 };
+  std::uniform_int_distribution<size_t> pick(0,5);
+
+  const size_t nblocks = 2000;
+  const size_t nrep = 10;
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "contract_batch : C(i,k) = A(i,p,j) * B(j,p,k)     " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  {
+    std::vector<Tensor<double,3>> A(nblocks);
+    std::vector<Tensor<double,3>> B(nblocks);
+    std::vector<Tensor<double,2>> C(nblocks);
+    std::vector<Tensor<double,2>> Cref(nblocks);
+
+    for(size_t n = 0; n < nblocks; ++n) {
+      const size_t i = dims[pick(rGen)];
+      const size_t p = dims[pick(rGen)%3]; // physical index is small
+      const size_t j = dims[pick(rGen)];
+      const size_t k = dims[pick(rGen)];
+      A[n].resize(i,p,j); A[n].generate(std::bind(dist,rGen));
+      B[n].resize(j,p,k); B[n].generate(std::bind(dist,rGen));
+      C[n].resize(i,k); C[n].generate(std::bind(dist,rGen));
+      Cref[n] = C[n];
+    }
+
+    // alpha and beta vary over blocks
+    std::vector<contract_batch_item<double,3,3,2>> items;
+    for(size_t n = 0; n < nblocks; ++n) items.push_back(contract_batch_item<double,3,3,2>((n%2 ? 1.0 : 2.0),A[n],B[n],0.5,C[n]));
+
+    contract_batch(items,make_array('i','p','j'),make_array('j','p','k'),make_array('i','k'));
+    for(size_t n = 0; n < nblocks; ++n)
+      contract((n%2 ? 1.0 : 2.0),A[n],make_array('i','p','j'),B[n],make_array('j','p','k'),0.5,Cref[n],make_array('i','k'));
+
+    std::cout << "C(i,k)   : " << max_diff(C,Cref) << std::endl;
+
+    time_stamp ts;
+
+    for(size_t r = 0; r < nrep; ++r)
+      for(size_t n = 0; n < nblocks; ++n)
+        contract(1.0,A[n],make_array('i','p','j'),B[n],make_array('j','p','k'),0.0,Cref[n],make_array('i','k'));
+
+    double t_loop = ts.lap();
+
+    for(size_t r = 0; r < nrep; ++r) {
+      std::vector<contract_batch_item<double,3,3,2>> items_;
+      for(size_t n = 0; n < nblocks; ++n) items_.push_back(contract_batch_item<double,3,3,2>(1.0,A[n],B[n],0.0,C[n]));
+      contract_batch(items_,make_array('i','p','j'),make_array('j','p','k'),make_array('i','k'));
+    }
+
+    double t_batch = ts.lap();
+
+    std::cout << "C(i,k)   : " << max_diff(C,Cref) << std::endl;
+
+    std::cout.setf(std::ios::fixed,std::ios::floatfield);
+    std::cout.precision(6);
+    std::cout << "time     : contract " << t_loop << ", contract_batch " << t_batch << std::endl;
+    std::cout.setf(std::ios::scientific,std::ios::floatfield);
+    std::cout.precision(2);
+  }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "contract_batch : C(j,i) = A(i,p) * B(p,j), col-major" << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  {
+    std::vector<Tensor<double,2,CblasColMajor>> A(nblocks);
+    std::vector<Tensor<double,2,CblasColMajor>> B(nblocks);
+    std::vector<Tensor<double,2,CblasColMajor>> C(nblocks);
+    std::vector<Tensor<double,2,CblasColMajor>> Cref(nblocks);
+
+    std::vector<contract_batch_item<double,2,2,2,CblasColMajor>> items;
+    for(size_t n = 0; n < nblocks; ++n) {
+      const size_t i = dims[pick(rGen)];
+      const size_t p = dims[pick(rGen)];
+      const size_t j = dims[pick(rGen)];
+      A[n].resize(i,p); A[n].generate(std::bind(dist,rGen));
+      B[n].resize(p,j); B[n].generate(std::bind(dist,rGen));
+      // C is initialized by contract_batch
+      items.push_back(contract_batch_item<double,2,2,2,CblasColMajor>(1.0,A[n],B[n],0.0,C[n]));
+      contract(1.0,A[n],make_array('i','p'),B[n],make_array('p','j'),0.0,Cref[n],make_array('j','i'));
+    }
+
+    contract_batch(items,make_array('i','p'),make_array('p','j'),make_array('j','i'));
+
+    std::cout << "C(j,i)   : " << max_diff(C,Cref) << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,201 @@
+#include <iostream>
+#include <iomanip>
+
+#include <cmath>
+#include <random>
+#include <functional>
+#include <limits>
+
+#include <btas.h>
+#include <max_diff.h>
+#include <time_stamp.h>
+
+/// copy static-rank tensor to dynamic-rank tensor
+template<size_t N>
+void to_dynamic (const btas::Tensor<double,N>& x, btas::Tensor<double,0>& y)
+{
+  y.resize(std::vector<size_t>(x.extent().begin(),x.extent().end()));
+  std::copy(x.data(),x.data()+x.size(),y.data());
+}
+
+int main ()
+{
+  using namespace btas;
+
+  std::mt19937 rGen;
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+
+  std::cout.setf(std::ios::scientific,std::ios::floatfield);
+  std::cout.precision(2);
+
+  // ----------------------------------------------------------------------------------------------------
+
+  Tensor<double,4> A(6,5,7,4); A.generate(std::bind(dist,rGen));
+  Tensor<double,3> B(4,3,5); B.generate(std::bind(dist,rGen));
+  Tensor<double,2> F(5,4); F.generate(std::bind(dist,rGen));
+  Tensor<double,4> Z(7,4,6,5); Z.generate(std::bind(dist,rGen));
+  Tensor<double,2> X(6,7); X.generate(std::bind(dist,rGen));
+  Tensor<double,1> Y(3ul); Y.generate(std::bind(dist,rGen));
+
+  Tensor<double,0> Ad; to_dynamic(A,Ad);
+  Tensor<double,0> Bd; to_dynamic(B,Bd);
+  Tensor<double,0> Fd; to_dynamic(F,Fd);
+  Tensor<double,0> Zd; to_dynamic(Z,Zd);
+  Tensor<double,0> Xd; to_dynamic(X,Xd);
+  Tensor<double,0> Yd; to_dynamic(Y,Yd);
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "contract with dynamic rank, Tensor<T,0>           " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  // dot, s = A(i,p,j,q) * Z(j,q,i,p), stored in extent {1}
+  double sref = 0.0;
+  for(size_t i = 0; i < 6; ++i)
+    for(size_t p = 0; p < 5; ++p)
+      for(size_t j = 0; j < 7; ++j)
+        for(size_t q = 0; q < 4; ++q)
+          sref += A(i,p,j,q)*Z(j,q,i,p);
+
+  Tensor<double,0> Sd;
+  ContractPlan<double,0,0,0> planS(Ad.extent(),make_array('i','p','j','q'),Zd.extent(),make_array('j','q','i','p'),std::vector<char>());
+  planS.execute(1.0,Ad,Zd,0.0,Sd);
+
+  std::cout << "s        : " << std::fabs(Sd.data()[0]-sref) << " " << planS.kernel() << " " << planS.layout() << std::endl;
+
+  // GEMV, E(i,j) = A(i,p,j,q) * F(p,q)
+  Tensor<double,2> E;
+  contract(1.0,A,make_array('i','p','j','q'),F,make_array('p','q'),0.0,E,make_array('i','j'));
+
+  Tensor<double,0> Ed;
+  ContractPlan<double,0,0,0> planE(Ad.extent(),make_array('i','p','j','q'),Fd.extent(),make_array('p','q'),make_array('i','j'));
+  planE.execute(1.0,Ad,Fd,0.0,Ed);
+
+  std::cout << "E(i,j)   : " << max_diff(Ed,E) << " " << planE.kernel() << " " << planE.layout() << std::endl;
+
+  // GEMV^T, E(i,j) = F(p,q) * A(i,p,j,q)
+  Tensor<double,0> Et;
+  ContractPlan<double,0,0,0> planEt(Fd.extent(),make_array('p','q'),Ad.extent(),make_array('i','p','j','q'),make_array('i','j'));
+  planEt.execute(1.0,Fd,Ad,0.0,Et);
+
+  std::cout << "E(i,j)   : " << max_diff(Et,E) << " " << planEt.kernel() << " " << planEt.layout() << std::endl;
+
+  // GER, O(k,i,j) = 2 * X(i,j) * Y(k) + 0.5 * O(k,i,j), written as (Y^T * X)^T
+  Tensor<double,3> O(3,6,7); O.generate(std::bind(dist,rGen));
+  Tensor<double,0> Od; to_dynamic(O,Od);
+  contract(2.0,X,make_array('i','j'),Y,make_array('k'),0.5,O,make_array('k','i','j'));
+  contract(2.0,Xd,make_array('i','j'),Yd,make_array('k'),0.5,Od,make_array('k','i','j'));
+
+  ContractPlan<double,0,0,0> planO(Xd.extent(),make_array('i','j'),Yd.extent(),make_array('k'),make_array('k','i','j'));
+
+  std::cout << "O(k,i,j) : " << max_diff(Od,O) << " " << planO.kernel() << " " << planO.layout() << std::endl;
+
+  // GEMM, D(k,i,j) = 2 * A(i,p,j,q) * B(q,k,p) + 0.5 * D(k,i,j)
+  Tensor<double,3> D(3,6,7); D.generate(std::bind(dist,rGen));
+  Tensor<double,0> Dd; to_dynamic(D,Dd);
+  contract(2.0,A,make_array('i','p','j','q'),B,make_array('q','k','p'),0.5,D,make_array('k','i','j'));
+  contract(2.0,Ad,make_array('i','p','j','q'),Bd,make_array('q','k','p'),0.5,Dd,make_array('k','i','j'));
+
+  ContractPlan<double,0,0,0> planD(Ad.extent(),make_array('i','p','j','q'),Bd.extent(),make_array('q','k','p'),make_array('k','i','j'));
+
+  std::cout << "D(k,i,j) : " << max_diff(Dd,D) << " " << planD.kernel() << " " << planD.layout() << std::endl;
+
+  // batched GEMM, G(i,k,j,m) = P(i,k,l,j) * Q(l,m), batch over (i,k)
+  Tensor<double,4> P(20,30,64,48); P.generate(std::bind(dist,rGen));
+  Tensor<double,2> Q(64,56); Q.generate(std::bind(dist,rGen));
+  Tensor<double,0> Pd; to_dynamic(P,Pd);
+  Tensor<double,0> Qd; to_dynamic(Q,Qd);
+
+  Tensor<double,4> G;
+  contract(1.0,P,make_array('i','k','l','j'),Q,make_array('l','m'),0.0,G,make_array('i','k','j','m'));
+  Tensor<double,0> Gd;
+  contract(1.0,Pd,make_array('i','k','l','j'),Qd,make_array('l','m'),0.0,Gd,make_array('i','k','j','m'));
+
+  ContractPlan<double,0,0,0> planG(Pd.extent(),make_array('i','k','l','j'),Qd.extent(),make_array('l','m'),make_array('i','k','j','m'));
+
+  std::cout << "G(i,k,j,m) : " << max_diff(Gd,G) << " " << planG.kernel() << std::endl;
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "contract(alpha,A,idxa,B,idxb,beta,C) with Tensor<T,0>" << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  // C(i,j,k) = A(i,p,j,q) * B(q,k,p)
+  Tensor<double,3> C;
+  contract(1.0,A,shape(1,3),B,shape(2,0),0.0,C);
+  Tensor<double,0> Cd;
+  contract(1.0,Ad,shape(1,3),Bd,shape(2,0),0.0,Cd);
+
+  std::cout << "C(i,j,k) : " << max_diff(Cd,C) << " rank " << Cd.extent().size() << std::endl;
+
+  // s = A(i,p,j,q) * A(i,p,j,q)
+  Tensor<double,0> Nd;
+  contract(1.0,Ad,shape(0,1,2,3),Ad,shape(0,1,2,3),0.0,Nd);
+
+  std::cout << "s        : " << std::fabs(Nd.data()[0]-dot(A,A)) << " extent {" << Nd.extent(0) << "}" << std::endl;
+
+  // blasCall dispatches by ranks at runtime, E(i,j) = A(i,j,p,q) * F(p,q)
+  Tensor<double,0> Ac(std::vector<size_t>{6,7,5,4}); Ac.generate(std::bind(dist,rGen));
+  Tensor<double,0> Ec(std::vector<size_t>{6,7});
+  blasCall(CblasNoTrans,CblasNoTrans,1.0,Ac,Fd,0.0,Ec);
+  Tensor<double,0> Ecref;
+  contract(1.0,Ac,shape(2,3),Fd,shape(0,1),0.0,Ecref);
+
+  std::cout << "E(i,j)   : " << max_diff(Ec,Ecref) << " blasCall" << std::endl;
+
+  // c holding NaN is not read if beta = 0 : G(i,j,k,l) = A(i,j) * B(k,l), outer product (GER)
+  {
+    Tensor<long double,0> Ag(std::vector<size_t>{3,2}); Ag.fill(1.0L);
+    Tensor<long double,0> Bg(std::vector<size_t>{2,5}); Bg.fill(2.0L);
+    Tensor<long double,0> Gg(std::vector<size_t>{3,2,2,5}); Gg.fill(std::numeric_limits<long double>::quiet_NaN());
+    blasCall(CblasNoTrans,CblasNoTrans,1.0L,Ag,Bg,0.0L,Gg);
+    size_t nwrong = 0; for(size_t i = 0; i < Gg.size(); ++i) if(!(Gg.data()[i] == 2.0L)) ++nwrong;
+    std::cout << "G(i,j,k,l) : " << nwrong << " wrong of " << Gg.size() << " blasCall w/ beta = 0 on NaN" << std::endl;
+  }
+
+  // empty c of dynamic rank is rejected, since blasCall cannot resize it
+  try {
+    Tensor<double,0> Sc;
+    blasCall(CblasNoTrans,CblasNoTrans,1.0,Ac,Ac,0.0,Sc);
+    std::cout << "s        : empty c accepted (FAILED)" << std::endl;
+  }
+  catch(std::runtime_error& e) {
+    std::cout << "s        : empty c rejected, " << e.what() << std::endl;
+  }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "static vs dynamic rank, W(i,j,k) = U(i,p,q) * V(q,p,j,k)" << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  const size_t nrep = 10;
+
+  Tensor<double,3> U(200,20,20); U.generate(std::bind(dist,rGen));
+  Tensor<double,4> V(20,20,20,20); V.generate(std::bind(dist,rGen));
+  Tensor<double,0> Ud; to_dynamic(U,Ud);
+  Tensor<double,0> Vd; to_dynamic(V,Vd);
+
+  Tensor<double,3> W;
+  Tensor<double,0> Wd;
+
+  time_stamp ts;
+
+  for(size_t i = 0; i < nrep; ++i)
+    contract(1.0,U,make_array('i','p','q'),V,make_array('q','p','j','k'),0.0,W,make_array('i','j','k'));
+
+  double t_static = ts.lap();
+
+  for(size_t i = 0; i < nrep; ++i)
+    contract(1.0,Ud,make_array('i','p','q'),Vd,make_array('q','p','j','k'),0.0,Wd,make_array('i','j','k'));
+
+  double t_dynamic = ts.lap();
+
+  std::cout << "W(i,j,k) : " << max_diff(Wd,W) << std::endl;
+
+  std::cout.setf(std::ios::fixed,std::ios::floatfield);
+  std::cout.precision(6);
+  std::cout << "time     : static " << t_static << ", dynamic " << t_dynamic << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,201 @@
+#include <iostream>
+#include <iomanip>
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+#include <btas.h>
+#include <time_stamp.h>
+
+/// naive gemm for reference
+template<typename T>
+void naive_gemm (CBLAS_LAYOUT order, CBLAS_TRANSPOSE transA, CBLAS_TRANSPOSE transB, size_t M, size_t N, size_t K,
+                 const T& alpha, const T* A, size_t ldA, const T* B, size_t ldB, const T& beta, T* C, size_t ldC)
+{
+  for(size_t i = 0; i < M; ++i)
+    for(size_t j = 0; j < N; ++j) {
+      T c = static_cast<T>(0);
+      for(size_t p = 0; p < K; ++p) {
+        const bool rowA = (order == CblasRowMajor) ^ (transA != CblasNoTrans);
+        const bool rowB = (order == CblasRowMajor) ^ (transB != CblasNoTrans);
+        T a = rowA ? A[i*ldA+p] : A[p*ldA+i];
+        T b = rowB ? B[p*ldB+j] : B[j*ldB+p];
+        if(transA == CblasConjTrans) a = btas::detail::__generic_conj(a);
+        if(transB == CblasConjTrans) b = btas::detail::__generic_conj(b);
+        c += a*b;
+      }
+      T& cij = (order == CblasRowMajor) ? C[i*ldC+j] : C[j*ldC+i];
+      cij = alpha*c+beta*cij;
+    }
+}
+
+template<typename T>
+void generate (std::vector<T>& x, std::mt19937& rGen)
+{
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+  for(size_t i = 0; i < x.size(); ++i) x[i] = static_cast<T>(dist(rGen));
+}
+
+template<typename T>
+void generate (std::vector<std::complex<T>>& x, std::mt19937& rGen)
+{
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+  for(size_t i = 0; i < x.size(); ++i) x[i] = std::complex<T>(dist(rGen),dist(rGen));
+}
+
+template<typename T>
+double max_diff (const std::vector<T>& x, const std::vector<T>& y)
+{
+  double diff = 0.0;
+  for(size_t i = 0; i < x.size(); ++i) diff = std::max(diff,static_cast<double>(std::abs(x[i]-y[i])));
+  return diff;
+}
+
+/// GEMM of all layouts and trans flags, odd sizes to check edges of blocks
+template<typename T>
+double check_gemm (std::mt19937& rGen)
+{
+  const size_t M = 37, N = 70, K = 301;
+  const CBLAS_LAYOUT orders[] = { CblasRowMajor, CblasColMajor };
+  const CBLAS_TRANSPOSE trans[] = { CblasNoTrans, CblasTrans, CblasConjTrans };
+  const T alpha = static_cast<T>(0.5);
+  const T beta = static_cast<T>(2);
+
+  double diff = 0.0;
+  for(CBLAS_LAYOUT order : orders)
+    for(CBLAS_TRANSPOSE ta : trans)
+      for(CBLAS_TRANSPOSE tb : trans) {
+        const bool rowA = (order == CblasRowMajor) ^ (ta != CblasNoTrans);
+        const bool rowB = (order == CblasRowMajor) ^ (tb != CblasNoTrans);
+        const size_t ldA = (rowA ? K : M)+3;
+        const size_t ldB = (rowB ? N : K)+2;
+        const size_t ldC = ((order == CblasRowMajor) ? N : M)+1;
+        std::vector<T> A(ldA*(rowA ? M : K)); generate(A,rGen);
+        std::vector<T> B(ldB*(rowB ? K : N)); generate(B,rGen);
+        std::vector<T> C(ldC*((order == CblasRowMajor) ? M : N)); generate(C,rGen);
+        std::vector<T> Cref(C);
+        btas::gemm(order,ta,tb,M,N,K,alpha,A.data(),ldA,B.data(),ldB,beta,C.data(),ldC);
+        naive_gemm(order,ta,tb,M,N,K,alpha,A.data(),ldA,B.data(),ldB,beta,Cref.data(),ldC);
+        diff = std::max(diff,max_diff(C,Cref));
+      }
+  return diff;
+}
+
+/// GEMV of all layouts and trans flags
+template<typename T>
+double check_gemv (std::mt19937& rGen)
+{
+  const size_t M = 53, N = 38;
+  const CBLAS_LAYOUT orders[] = { CblasRowMajor, CblasColMajor };
+  const CBLAS_TRANSPOSE trans[] = { CblasNoTrans, CblasTrans, CblasConjTrans };
+  const T alpha = static_cast<T>(-1);
+  const T beta = static_cast<T>(0.5);
+
+  double diff = 0.0;
+  for(CBLAS_LAYOUT order : orders)
+    for(CBLAS_TRANSPOSE ta : trans) {
+      const size_t ldA = ((order == CblasRowMajor) ? N : M)+1;
+      const size_t nx = (ta == CblasNoTrans) ? N : M;
+      const size_t ny = (ta == CblasNoTrans) ? M : N;
+      std::vector<T> A(ldA*((order == CblasRowMajor) ? M : N)); generate(A,rGen);
+      std::vector<T> X(2*nx); generate(X,rGen);
+      std::vector<T> Y(ny); generate(Y,rGen);
+      std::vector<T> Yref(Y);
+      btas::gemv(order,ta,M,N,alpha,A.data(),ldA,X.data(),2,beta,Y.data(),1);
+      // GEMV as GEMM with n = 1, op(A) is M x N
+      std::vector<T> Xc(nx);
+      for(size_t i = 0; i < nx; ++i) Xc[i] = X[2*i];
+      if(order == CblasRowMajor)
+        naive_gemm(order,ta,CblasNoTrans,ny,1,nx,alpha,A.data(),ldA,Xc.data(),1,beta,Yref.data(),1);
+      else
+        naive_gemm(order,ta,CblasNoTrans,ny,1,nx,alpha,A.data(),ldA,Xc.data(),nx,beta,Yref.data(),ny);
+      diff = std::max(diff,max_diff(Y,Yref));
+    }
+  return diff;
+}
+
+int main ()
+{
+  using namespace btas;
+
+  std::mt19937 rGen;
+
+  std::cout.setf(std::ios::scientific,std::ios::floatfield);
+  std::cout.precision(2);
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "generic BLAS for long double and complex          " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  std::cout << "gemm (long double)          : " << check_gemm<long double>(rGen) << std::endl;
+  std::cout << "gemm (complex<long double>) : " << check_gemm<std::complex<long double>>(rGen) << std::endl;
+  std::cout << "gemv (long double)          : " << check_gemv<long double>(rGen) << std::endl;
+  std::cout << "gemv (complex<long double>) : " << check_gemv<std::complex<long double>>(rGen) << std::endl;
+
+  {
+    const size_t n = 100003;
+    std::vector<long double> x(n); generate(x,rGen);
+    std::vector<long double> y(n); generate(y,rGen);
+    long double sref = 0.0L;
+    for(size_t i = 0; i < n; ++i) sref += x[i]*y[i];
+    std::cout << "dot  (long double)          : " << static_cast<double>(std::fabs(dot(n,x.data(),1,y.data(),1)-sref)) << std::endl;
+
+    std::vector<long double> yref(y);
+    for(size_t i = 0; i < n; ++i) yref[i] += 3.0L*x[i];
+    axpy(n,3.0L,x.data(),1,y.data(),1);
+    std::cout << "axpy (long double)          : " << max_diff(y,yref) << std::endl;
+  }
+
+  // contraction of long double tensors goes through generic GEMM
+  {
+    Tensor<long double,3> A(6,5,7); A.fill(0.5L);
+    Tensor<long double,2> B(7,4); B.fill(2.0L);
+    Tensor<long double,3> C;
+    contract(1.0L,A,make_array('i','j','k'),B,make_array('k','l'),0.0L,C,make_array('i','j','l'));
+    double diff = 0.0;
+    for(size_t i = 0; i < C.size(); ++i) diff = std::max(diff,static_cast<double>(std::fabs(C.data()[i]-7.0L)));
+    std::cout << "contract (long double)      : " << diff << std::endl;
+  }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "benchmark : blocked gemm vs naive loops           " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  std::cout.setf(std::ios::fixed,std::ios::floatfield);
+  std::cout.precision(6);
+
+  const size_t sizes[] = { 64, 128, 256, 512, 1024 };
+  for(size_t n : sizes) {
+    std::vector<long double> A(n*n); generate(A,rGen);
+    std::vector<long double> B(n*n); generate(B,rGen);
+    std::vector<long double> C(n*n,0.0L);
+    std::vector<long double> Cref(n*n,0.0L);
+
+    time_stamp ts;
+
+    gemm(CblasRowMajor,CblasNoTrans,CblasNoTrans,n,n,n,1.0L,A.data(),n,B.data(),n,0.0L,C.data(),n);
+
+    double t_blocked = ts.lap();
+
+    // naive i-p-j loops, which is the fastest order of naive loops for row-major
+    for(size_t i = 0; i < n; ++i)
+      for(size_t p = 0; p < n; ++p) {
+        const long double a = A[i*n+p];
+        for(size_t j = 0; j < n; ++j) Cref[i*n+j] += a*B[p*n+j];
+      }
+
+    double t_naive = ts.lap();
+
+    std::cout << "n = " << std::setw(4) << n << " : blocked " << t_blocked << " (" << std::setw(8) << 2.0e-9*n*n*n/t_blocked << " GFlops)"
+              << ", naive " << t_naive << " (" << std::setw(8) << 2.0e-9*n*n*n/t_naive << " GFlops)"
+              << ", diff " << std::scientific << std::setprecision(2) << max_diff(C,Cref) << std::fixed << std::setprecision(6) << std::endl;
+  }
+
+  return 0;
+}
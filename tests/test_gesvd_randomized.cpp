@@ -0,0 +1,147 @@
+#include <iostream>
+#include <iomanip>
+
+#include <cmath>
+#include <random>
+#include <functional>
+#include <algorithm>
+
+#include <btas.h>
+#include <time_stamp.h>
+
+/// max. relative difference of singular values from the reference
+template<class VectorS, class VectorSR>
+double max_rel_diff (const VectorS& s, const VectorSR& sr)
+{
+  if(s.size() > sr.size()) return HUGE_VAL;
+  double diff = 0.0;
+  for(size_t i = 0; i < s.size(); ++i) diff = std::max(diff,std::fabs(s(i)-sr(i))/sr(i));
+  return diff;
+}
+
+/// relative error of low-rank approximation, |a - u * diag(s) * vt| / |a|
+template<size_t M, size_t N>
+double approx_error (const btas::Tensor<double,M+N-2>& a, const btas::Tensor<double,1>& s, const btas::Tensor<double,M>& u, const btas::Tensor<double,N>& vt)
+{
+  using namespace btas;
+  Tensor<double,M> us(u);
+  const size_t k = s.size();
+  for(size_t i = 0; i < us.size(); ++i) us.data()[i] *= s.data()[i%k];
+  Tensor<double,M+N-2> b(a);
+  gemm(CblasNoTrans,CblasNoTrans,-1.0,us,vt,1.0,b);
+  return nrm2(b)/nrm2(a);
+}
+
+/// make factors of a({i,j},{k,l}) = x(i,j,r) * y(r,k,l), where singular values of a decay as exp(-decay*r)
+void make_factors (size_t n0, size_t n1, size_t n2, size_t n3, size_t r, double decay,
+                   btas::Tensor<double,3>& x, btas::Tensor<double,3>& y, std::mt19937& rGen)
+{
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+  x.resize(n0,n1,r); x.generate(std::bind(dist,rGen));
+  y.resize(r,n2,n3); y.generate(std::bind(dist,rGen));
+  for(size_t i = 0; i < r; ++i) {
+    double f = std::exp(-decay*i);
+    for(size_t j = 0; j < n2*n3; ++j) y.data()[i*n2*n3+j] *= f;
+  }
+}
+
+int main ()
+{
+  using namespace btas;
+
+  std::mt19937 rGen;
+
+  std::cout.setf(std::ios::scientific,std::ios::floatfield);
+  std::cout.precision(2);
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "gesvd_randomized vs gesvd_truncated               " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  Tensor<double,3> x;
+  Tensor<double,3> y;
+  make_factors(20,8,8,20,160,0.05,x,y,rGen);
+
+  Tensor<double,4> a;
+  contract(1.0,x,shape(2),y,shape(0),0.0,a);
+
+  Tensor<double,1> sref; Tensor<double,3> uref; Tensor<double,3> vtref;
+  gesvd_truncated(a,sref,uref,vtref,{20,0.0,0.0,false});
+  std::cout << "optimal (rank 20)       : error " << approx_error<3,3>(a,sref,uref,vtref) << std::endl;
+
+  for(size_t q = 0; q < 3; ++q) {
+    Tensor<double,1> s; Tensor<double,3> u; Tensor<double,3> vt;
+    gesvd_randomized(a,s,u,vt,20,10,q);
+    std::cout << "power iterations " << q << "      : error " << approx_error<3,3>(a,s,u,vt)
+              << ", singular values " << max_rel_diff(s,sref) << std::endl;
+  }
+
+  // matrix-free : a is given by x and y, and never formed
+  {
+    // u({i,j},r) = a({i,j},{k,l}) * w(r,{k,l}) = x(i,j,p) * (y(p,k,l) * w(r,k,l))
+    auto mult_a = [&x,&y] (const Tensor<double,3>& w, Tensor<double,3>& u)
+    {
+      Tensor<double,2> t;
+      contract(1.0,y,make_array('p','k','l'),w,make_array('r','k','l'),0.0,t,make_array('p','r'));
+      contract(1.0,x,make_array('i','j','p'),t,make_array('p','r'),0.0,u,make_array('i','j','r'));
+    };
+    // w(r,{k,l}) = u({i,j},r) * a({i,j},{k,l}) = (u(i,j,r) * x(i,j,p)) * y(p,k,l)
+    auto mult_ah = [&x,&y] (const Tensor<double,3>& u, Tensor<double,3>& w)
+    {
+      Tensor<double,2> t;
+      contract(1.0,u,make_array('i','j','r'),x,make_array('i','j','p'),0.0,t,make_array('r','p'));
+      contract(1.0,t,make_array('r','p'),y,make_array('p','k','l'),0.0,w,make_array('r','k','l'));
+    };
+
+    Tensor<double,1> s; Tensor<double,3> u; Tensor<double,3> vt;
+    gesvd_randomized(mult_a,mult_ah,a.extent(),s,u,vt,20);
+    std::cout << "matrix-free             : error " << approx_error<3,3>(a,s,u,vt)
+              << ", singular values " << max_rel_diff(s,sref) << std::endl;
+  }
+
+  // column-major
+  {
+    std::uniform_real_distribution<double> dist(-1.0,1.0);
+    Tensor<double,2,CblasColMajor> b(60,50); b.generate(std::bind(dist,rGen));
+    Tensor<double,1,CblasColMajor> s; Tensor<double,2,CblasColMajor> u; Tensor<double,2,CblasColMajor> vt;
+    Tensor<double,1,CblasColMajor> sr; Tensor<double,2,CblasColMajor> ur; Tensor<double,2,CblasColMajor> vtr;
+    gesvd_truncated(b,sr,ur,vtr,{50,0.0,0.0,false});
+    // full rank w/o truncation is exact
+    gesvd_randomized(b,s,u,vt,50,0,0);
+    std::cout << "column-major (full rank): singular values " << max_rel_diff(s,sr) << std::endl;
+  }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "benchmark : rank 50 of (1600 x 1600)              " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  std::cout.setf(std::ios::fixed,std::ios::floatfield);
+  std::cout.precision(6);
+
+  {
+    make_factors(400,4,4,400,1600,0.1,x,y,rGen);
+    Tensor<double,4> b;
+    contract(1.0,x,shape(2),y,shape(0),0.0,b);
+
+    time_stamp ts;
+
+    Tensor<double,1> sr; Tensor<double,3> ur; Tensor<double,3> vtr;
+    gesvd_truncated(b,sr,ur,vtr,{50,0.0,0.0,false});
+
+    double t_gesdd = ts.lap();
+
+    Tensor<double,1> s; Tensor<double,3> u; Tensor<double,3> vt;
+    gesvd_randomized(b,s,u,vt,50);
+
+    double t_rand = ts.lap();
+
+    std::cout << "gesvd_truncated " << t_gesdd << ", gesvd_randomized " << t_rand
+              << std::scientific << std::setprecision(2) << " (singular values " << max_rel_diff(s,sr) << ")" << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,213 @@
+#include <iostream>
+#include <iomanip>
+
+#include <cmath>
+#include <random>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <btas.h>
+
+/// allocator which counts allocations, to find hidden copies of tensors
+template<typename T>
+class counting_allocator : public std::allocator<T> {
+
+public:
+
+  template<typename U> struct rebind { typedef counting_allocator<U> other; };
+
+  counting_allocator () { }
+
+  template<typename U>
+  counting_allocator (const counting_allocator<U>&) { }
+
+  T* allocate (size_t n)
+  {
+    ++count();
+    return std::allocator<T>::allocate(n);
+  }
+
+  static size_t& count () { static size_t n_ = 0; return n_; }
+
+};
+
+template<size_t N>
+using CTensor = btas::Tensor<double,N,CblasRowMajor,counting_allocator<double>>;
+
+/// print no. of allocations since the last call, and whether it is as expected
+void report (const char* name, size_t expected)
+{
+  static size_t last = 0;
+  size_t counted = counting_allocator<double>::count()-last;
+  last = counting_allocator<double>::count();
+  std::cout << std::setw(44) << std::left << name << " : allocations " << counted << " (expected " << expected << ") "
+            << ((counted == expected) ? "OK" : "FAILED") << std::endl;
+}
+
+/// print max. bytes of Workspace in use and its heap allocations since the last call, where the high-water mark is reset by Workspace::release()
+/// if expected > 0, the call is compared to the last one (an lvalue overload), which takes a copy of a of expected bytes into Workspace,
+/// i.e. one more heap allocation, which is invisible to counting_allocator
+void report_workspace (const char* name, size_t expected)
+{
+  static size_t last_bytes = 0;
+  static size_t last_heap = 0;
+  static size_t heap_total = 0;
+  btas::Workspace& ws = btas::Workspace::local();
+  size_t bytes = ws.high_water();
+  size_t heap = ws.heap_allocations()-heap_total;
+  ws.release();
+  heap_total = ws.heap_allocations();
+  std::cout << std::setw(44) << std::left << name << " : workspace " << std::setw(5) << bytes << " bytes, heap allocations " << heap;
+  if(expected > 0) {
+    const bool ok = (last_bytes-bytes == expected && last_heap == heap+1);
+    std::cout << ", copy of a " << last_bytes-bytes << " bytes (expected " << expected << ") " << (ok ? "OK" : "FAILED");
+  }
+  std::cout << std::endl;
+  last_bytes = bytes;
+  last_heap = heap;
+}
+
+/// return by value from two paths, which prevents NRVO
+CTensor<3> make_tensor (bool flag, std::mt19937& rGen)
+{
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+  CTensor<3> a(10,20,30); a.generate(std::bind(dist,rGen));
+  CTensor<3> b(30,20,10); b.generate(std::bind(dist,rGen));
+  if(flag)
+    return a;
+  else
+    return b;
+}
+
+int main ()
+{
+  using namespace btas;
+
+  std::mt19937 rGen;
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+
+  std::cout.setf(std::ios::scientific,std::ios::floatfield);
+  std::cout.precision(2);
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "move of Tensor<T,N> and Tensor<T,0>               " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  {
+    CTensor<3> a(10,20,30); a.generate(std::bind(dist,rGen));
+    report("construct",1);
+
+    const double* p = a.data();
+    CTensor<3> b(std::move(a));
+    report("move constructor",0);
+    std::cout << "  data taken over " << (b.data() == p ? "yes" : "no ") << ", moved-from size " << a.size() << std::endl;
+
+    CTensor<3> c(5,5,5);
+    report("construct",1);
+    c = std::move(b);
+    report("move assign",0);
+    std::cout << "  data taken over " << (c.data() == p ? "yes" : "no ") << ", moved-from size " << b.size() << std::endl;
+
+    CTensor<3> d = make_tensor(false,rGen);
+    report("return by value (w/o NRVO)",2);
+
+    std::vector<CTensor<3>> v;
+    for(size_t i = 0; i < 8; ++i) v.push_back(CTensor<3>(4,5,6));
+    report("std::vector<Tensor>::push_back (grown)",8);
+  }
+
+  {
+    btas::Tensor<double,0,CblasRowMajor,counting_allocator<double>> a(std::vector<size_t>{10,20,30});
+    report("construct (dynamic rank)",1);
+    btas::Tensor<double,0,CblasRowMajor,counting_allocator<double>> b(std::move(a));
+    report("move constructor (dynamic rank)",0);
+    a = std::move(b);
+    report("move assign (dynamic rank)",0);
+    std::cout << "  rank " << a.rank() << ", moved-from rank " << b.rank() << std::endl;
+  }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "permute x into y, where x is lvalue or rvalue     " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  {
+    CTensor<3> x(10,20,30); x.generate(std::bind(dist,rGen));
+    CTensor<3> xref(x);
+    report("construct and copy",2);
+
+    CTensor<3> y;
+    permute(x,shape(2,0,1),y);
+    report("permute(x,idx,y)",1);
+
+    CTensor<3> z;
+    permute(std::move(x),shape(2,0,1),z);
+    report("permute(std::move(x),idx,y)",1);
+
+    x = xref;
+    report("copy assign",1);
+    permute(std::move(x),shape(2,0,1),z);
+    report("permute(std::move(x),idx,y), y is sized",0);
+
+    double diff = 0.0;
+    for(size_t i = 0; i < y.size(); ++i) diff = std::max(diff,std::fabs(y.data()[i]-z.data()[i]));
+    std::cout << "  diff " << diff << ", moved-from size " << x.size() << std::endl;
+  }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "LAPACK wrappers, where a is lvalue or rvalue      " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  {
+    CTensor<3> a(12,5,4); a.generate(std::bind(dist,rGen));
+    CTensor<3> aref(a);
+    report("construct and copy",2);
+
+    // copy of a into Workspace, which is invisible to counting_allocator
+    const size_t abytes = a.size()*sizeof(double);
+    report_workspace("(reset)",0);
+
+    CTensor<1> s; CTensor<2> u; CTensor<3> vt;
+    gesvd('S','S',a,s,u,vt);
+    report("gesvd(a,s,u,vt)",3);
+    report_workspace("gesvd(a,s,u,vt)",0);
+
+    CTensor<1> s2; CTensor<2> u2; CTensor<3> vt2;
+    gesvd('S','S',std::move(a),s2,u2,vt2);
+    report("gesvd(std::move(a),s,u,vt)",3);
+    report_workspace("gesvd(std::move(a),s,u,vt)",abytes);
+
+    double diff = 0.0;
+    for(size_t i = 0; i < s.size(); ++i) diff = std::max(diff,std::fabs(s.data()[i]-s2.data()[i]));
+    std::cout << "  diff of singular values " << diff << std::endl;
+
+    CTensor<2> q; CTensor<3> r;
+    geqrf(aref,q,r);
+    report("geqrf(a,q,r)",2);
+    report_workspace("geqrf(a,q,r)",0);
+
+    a = aref;
+    report("copy assign",0);
+    geqrf(std::move(a),q,r);
+    report("geqrf(std::move(a),q,r), q and r are sized",0);
+    report_workspace("geqrf(std::move(a),q,r)",abytes);
+
+    CTensor<2> l; CTensor<3> q2;
+    gelqf(aref,l,q2);
+    report("gelqf(a,l,q)",2);
+    report_workspace("gelqf(a,l,q)",0);
+
+    a = aref;
+    gelqf(std::move(a),l,q2);
+    report("gelqf(std::move(a),l,q), l and q are sized",0);
+    report_workspace("gelqf(std::move(a),l,q)",abytes);
+  }
+
+  return 0;
+}
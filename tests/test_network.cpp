@@ -0,0 +1,145 @@
+#include <iostream>
+#include <iomanip>
+
+#include <cmath>
+#include <random>
+#include <functional>
+#include <algorithm>
+
+#include <btas.h>
+#include <max_diff.h>
+#include <time_stamp.h>
+
+int main ()
+{
+  using namespace btas;
+
+  std::mt19937 rGen;
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+
+  std::cout.setf(std::ios::scientific,std::ios::floatfield);
+  std::cout.precision(2);
+
+  // ----------------------------------------------------------------------------------------------------
+
+  const size_t D = 64; // bond dimension
+  const size_t d = 4; // physical dimension
+  const size_t w = 8; // MPO bond dimension
+
+  Tensor<double,3> L(D,w,D); L.generate(std::bind(dist,rGen));
+  Tensor<double,3> P(D,d,D); P.generate(std::bind(dist,rGen));
+  Tensor<double,4> W(w,d,d,w); W.generate(std::bind(dist,rGen));
+  Tensor<double,3> R(D,w,D); R.generate(std::bind(dist,rGen));
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "contract_network : effective Hamiltonian H * psi  " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  // C(a,t,b) = L(a,w,x) * P(x,s,y) * W(w,s,t,v) * R(b,v,y)
+  time_stamp ts;
+
+  Tensor<double,3> C;
+  contract_path path = contract_network(1.0,{L,P,W,R},{{'a','w','x'},{'x','s','y'},{'w','s','t','v'},{'b','v','y'}},0.0,C,make_array('a','t','b'));
+
+  double t_network = ts.elapsed();
+
+  // hand-ordered, contract(contract(contract(L,P),W),R)
+  Tensor<double,4> LP;
+  contract(1.0,L,make_array('a','w','x'),P,make_array('x','s','y'),0.0,LP,make_array('a','w','s','y'));
+  Tensor<double,4> LPW;
+  contract(1.0,LP,make_array('a','w','s','y'),W,make_array('w','s','t','v'),0.0,LPW,make_array('a','y','t','v'));
+  Tensor<double,3> Cref;
+  contract(1.0,LPW,make_array('a','y','t','v'),R,make_array('b','v','y'),0.0,Cref,make_array('a','t','b'));
+
+  double t_hand = ts.elapsed()-t_network;
+
+  std::cout << "C(a,t,b) : " << max_diff(C,Cref) << std::endl;
+  std::cout << "path     : " << path << std::endl;
+
+  // bad order, contract(contract(P,R),contract(L,W)), takes O(D^3 d^2 w) operations
+  contract_path worst;
+  worst.steps = { {0,2}, {0,1}, {0,1} };
+  Tensor<double,3> Cbad;
+  contract_network(1.0,{L,P,W,R},{{'a','w','x'},{'x','s','y'},{'w','s','t','v'},{'b','v','y'}},0.0,Cbad,make_array('a','t','b'),worst);
+
+  double t_worst = ts.elapsed()-t_network-t_hand;
+
+  std::cout << "C(a,t,b) : " << max_diff(Cbad,Cref) << " along (0,2) (0,1) (0,1)" << std::endl;
+
+  // accumulate to C with scaling factors along the same path
+  Tensor<double,3> Cacc(C);
+  contract_network(2.0,{L,P,W,R},{{'a','w','x'},{'x','s','y'},{'w','s','t','v'},{'b','v','y'}},-1.0,Cacc,make_array('a','t','b'),path);
+
+  std::cout << "C(a,t,b) : " << max_diff(Cacc,Cref) << " accumulated" << std::endl;
+
+  // dynamic rank of operands and output
+  {
+    Tensor<double,0> Ld(std::vector<size_t>{D,w,D}); std::copy(L.data(),L.data()+L.size(),Ld.data());
+    Tensor<double,0> Cd;
+    contract_network(1.0,{Ld,P,W,R},{{'a','w','x'},{'x','s','y'},{'w','s','t','v'},{'b','v','y'}},0.0,Cd,std::vector<char>{'a','t','b'});
+
+    std::cout << "C(a,t,b) : " << max_diff(Cd,Cref) << " rank " << Cd.extent().size() << " (dynamic rank)" << std::endl;
+
+    // full contraction is stored in c of extent {1}
+    Tensor<double,0> Sd;
+    contract_network(1.0,{Cd,Cref},{{'a','t','b'},{'a','t','b'}},0.0,Sd,std::vector<char>());
+
+    std::cout << "s        : " << std::fabs(Sd.data()[0]-dot(Cref,Cref))/dot(Cref,Cref) << " extent {" << Sd.extent(0) << "} (dynamic rank)" << std::endl;
+  }
+
+  // memory limit which is just enough for the optimal path
+  contract_path limited = contract_network(1.0,{L,P,W,R},{{'a','w','x'},{'x','s','y'},{'w','s','t','v'},{'b','v','y'}},0.0,C,make_array('a','t','b'),path.peak_size);
+
+  std::cout << "C(a,t,b) : " << max_diff(C,Cref) << " (max_size " << path.peak_size << ")" << std::endl;
+  std::cout << "path     : " << limited << std::endl;
+
+  // every path needs two intermediates of size D^2 d w at least
+  try {
+    make_contract_path(std::vector<std::vector<size_t>>{{D,w,D},{D,d,D},{w,d,d,w},{D,w,D}},
+                       std::vector<std::vector<char>>{{'a','w','x'},{'x','s','y'},{'w','s','t','v'},{'b','v','y'}},make_array('a','t','b'),D*D);
+    std::cout << "memory limit : FAILED" << std::endl;
+  }
+  catch(std::runtime_error& e) {
+    std::cout << "memory limit : " << e.what() << std::endl;
+  }
+
+  std::cout.setf(std::ios::fixed,std::ios::floatfield);
+  std::cout.precision(6);
+  std::cout << "time     : network " << t_network << ", hand-ordered " << t_hand << ", worst " << t_worst << std::endl;
+  std::cout.setf(std::ios::scientific,std::ios::floatfield);
+  std::cout.precision(2);
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "contract_network : greedy search for matrix chain " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  // C(i,p) = M0(i,j) * M1(j,k) * ... * M7(o,p), the chain has a narrow bond in the middle
+  const size_t ext[] = { 40, 60, 30, 2, 50, 70, 20, 80, 10 };
+  const char symb[] = { 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q' };
+
+  std::vector<Tensor<double,2,CblasColMajor>> M(8);
+  for(size_t i = 0; i < 8; ++i) {
+    M[i].resize(ext[i],ext[i+1]);
+    M[i].generate(std::bind(dist,rGen));
+  }
+
+  Tensor<double,2,CblasColMajor> X;
+  contract_path chain = contract_network(1.0,{M[0],M[1],M[2],M[3],M[4],M[5],M[6],M[7]},
+    {{'i','j'},{'j','k'},{'k','l'},{'l','m'},{'m','n'},{'n','o'},{'o','p'},{'p','q'}},0.0,X,make_array('q','i'));
+
+  Tensor<double,2,CblasColMajor> Xref(M[0]);
+  for(size_t i = 1; i < 8; ++i) {
+    Tensor<double,2,CblasColMajor> tmp;
+    contract(1.0,Xref,make_array('i',symb[i]),M[i],make_array(symb[i],symb[i+1]),0.0,tmp,make_array('i',symb[i+1]));
+    Xref = tmp;
+  }
+  Tensor<double,2,CblasColMajor> XrefT;
+  permute(Xref,shape(1,0),XrefT);
+
+  std::cout << "X(q,i)   : " << max_diff(X,XrefT) << std::endl;
+  std::cout << "path     : " << chain << std::endl;
+
+  return 0;
+}
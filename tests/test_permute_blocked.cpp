@@ -0,0 +1,164 @@
+#include <iostream>
+#include <iomanip>
+
+#include <random>
+#include <functional>
+
+#include <btas.h>
+#include <time_stamp.h>
+
+/// check y(i,j,k,l) == x(permuted index) for all elements
+template<class TensorX, class TensorY>
+bool check_permute (const TensorX& x, const std::vector<size_t>& idx, const TensorY& y)
+{
+  typename TensorX::index_type ix(x.index(0));
+  typename TensorY::index_type iy(y.index(0));
+  for(iy[0] = 0; iy[0] < y.extent(0); ++iy[0])
+    for(iy[1] = 0; iy[1] < y.extent(1); ++iy[1])
+      for(iy[2] = 0; iy[2] < y.extent(2); ++iy[2])
+        for(iy[3] = 0; iy[3] < y.extent(3); ++iy[3]) {
+          for(size_t i = 0; i < 4; ++i) ix[idx[i]] = iy[i];
+          if(y(iy) != x(ix)) return false;
+        }
+  return true;
+}
+
+int main ()
+{
+  using namespace btas;
+
+  std::mt19937 rGen;
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+
+  std::vector<std::vector<size_t>> pmuts = { {0,1,2,3}, {1,0,2,3}, {0,1,3,2}, {3,2,1,0}, {2,3,0,1}, {3,0,1,2} };
+
+  // ----------------------------------------------------------------------------------------------------
+
+  Tensor<double,4> A(7,37,45,70); // row-major layout
+  A.generate(std::bind(dist,rGen));
+
+  Tensor<double,4,CblasColMajor> B(70,45,37,7); // col-major layout
+  B.generate(std::bind(dist,rGen));
+
+  Tensor<double,0> C(7,37,45,70); // variable-rank
+  C.generate(std::bind(dist,rGen));
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "make_permute(A,idx) : check elements              " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  for(const auto& idx : pmuts) {
+    Tensor<double,4> At = make_permute(A,idx);
+    Tensor<double,4,CblasColMajor> Bt = make_permute(B,idx);
+    Tensor<double,0> Ct = make_permute(C,idx);
+    std::cout << "{" << idx[0] << "," << idx[1] << "," << idx[2] << "," << idx[3] << "} : "
+              << "row-major " << (check_permute(A,idx,At) ? "OK" : "FAILED") << ", "
+              << "col-major " << (check_permute(B,idx,Bt) ? "OK" : "FAILED") << ", "
+              << "variable-rank " << (check_permute(C,idx,Ct) ? "OK" : "FAILED") << std::endl;
+  }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  Tensor<float,4> F(7,37,45,70);
+  F.generate(std::bind(dist,rGen));
+
+  Tensor<std::complex<double>,4> Z(7,37,45,70);
+  Z.generate([&] () { return std::complex<double>(dist(rGen),dist(rGen)); });
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "make_permute(F,idx) and make_permute(Z,idx)       " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  for(const auto& idx : pmuts) {
+    Tensor<float,4> Ft = make_permute(F,idx);
+    Tensor<std::complex<double>,4> Zt = make_permute(Z,idx);
+    std::cout << "{" << idx[0] << "," << idx[1] << "," << idx[2] << "," << idx[3] << "} : "
+              << "float " << (check_permute(F,idx,Ft) ? "OK" : "FAILED") << ", "
+              << "complex<double> " << (check_permute(Z,idx,Zt) ? "OK" : "FAILED") << std::endl;
+  }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  Tensor<double,4> E(1,37,45,1);
+  E.generate(std::bind(dist,rGen));
+
+  const char* kernel_name[] = { "Copy", "Strided", "Transpose", "Blocked" };
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "PermutePlan : kernel and fused rank               " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  for(const auto& idx : pmuts) {
+    const PermutePlan<double,4>& planA = PermutePlan<double,4>::get(A.extent(),idx);
+    const PermutePlan<double,4>& planE = PermutePlan<double,4>::get(E.extent(),idx);
+    Tensor<double,4> Et = make_permute(E,idx);
+    std::cout << "{" << idx[0] << "," << idx[1] << "," << idx[2] << "," << idx[3] << "} : "
+              << "A(7,37,45,70) " << kernel_name[planA.kernel()] << "[" << planA.fused_rank() << "], "
+              << "E(1,37,45,1) " << kernel_name[planE.kernel()] << "[" << planE.fused_rank() << "] "
+              << (check_permute(E,idx,Et) ? "OK" : "FAILED") << std::endl;
+  }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "PermutePlan : bounded cache                       " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  {
+    PermutePlan<double,2>::clear_cache();
+    const PermutePlan<double,2>& plan0 = PermutePlan<double,2>::get(shape(1ul,1ul),shape(1,0));
+    const size_t kernel0 = plan0.kernel();
+    for(size_t n = 2; n < 2*_BTAS_PERMUTE_PLAN_CACHE_SIZE; ++n) {
+      // plan0 is kept as the most recently used one
+      PermutePlan<double,2>::get(shape(1ul,1ul),shape(1,0));
+      PermutePlan<double,2>::get(shape(n,n+1),shape(1,0));
+    }
+    std::cout << "after " << 2*_BTAS_PERMUTE_PLAN_CACHE_SIZE-1 << " plans : " << PermutePlan<double,2>::cache_size() << " cached, "
+              << "most recently used " << (plan0.kernel() == kernel0 ? "OK" : "FAILED") << std::endl;
+    PermutePlan<double,2>::clear_cache();
+    std::cout << "clear_cache()    : " << PermutePlan<double,2>::cache_size() << " cached" << std::endl;
+  }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  Tensor<double,4> G(16,37,16,37); // {2,3,0,1} becomes a square transpose after fusion
+  G.generate(std::bind(dist,rGen));
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "permute_inplace(x,idx) : check elements           " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  for(const auto& idx : pmuts) {
+    Tensor<double,4> At(A); permute_inplace(At,idx);
+    Tensor<double,4,CblasColMajor> Bt(B); permute_inplace(Bt,idx);
+    Tensor<double,4> Gt(G); permute_inplace(Gt,idx);
+    std::cout << "{" << idx[0] << "," << idx[1] << "," << idx[2] << "," << idx[3] << "} : "
+              << "row-major " << (check_permute(A,idx,At) ? "OK" : "FAILED") << ", "
+              << "col-major " << (check_permute(B,idx,Bt) ? "OK" : "FAILED") << ", "
+              << "G(16,37,16,37) " << (check_permute(G,idx,Gt) ? "OK" : "FAILED") << std::endl;
+  }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  Tensor<double,4> D(64,64,64,64);
+  D.generate(std::bind(dist,rGen));
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "permute(D,idx) : D(64,64,64,64), time in sec.     " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  std::cout.setf(std::ios::fixed,std::ios::floatfield);
+  std::cout.precision(6);
+
+  for(const auto& idx : pmuts) {
+    time_stamp ts;
+    permute(D,idx);
+    double t_outplace = ts.elapsed();
+    permute_inplace(D,idx);
+    double t_inplace = ts.elapsed()-t_outplace;
+    std::cout << "{" << idx[0] << "," << idx[1] << "," << idx[2] << "," << idx[3] << "} : " << std::setw(10) << t_outplace
+              << " (in-place " << std::setw(10) << t_inplace << ")" << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include <iostream>
+#include <iomanip>
+
+#include <cmath>
+#include <random>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <btas.h>
+#include <max_diff.h>
+
+/// print extent
+template<class Extent>
+void print_extent (const char* name, const Extent& ext)
+{
+  std::cout << std::setw(32) << std::left << name << " : [";
+  for(size_t i = 0; i < ext.size(); ++i) std::cout << (i > 0 ? "," : "") << ext[i];
+  std::cout << "]";
+}
+
+int main ()
+{
+  using namespace btas;
+
+  std::mt19937 rGen;
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+
+  std::cout.setf(std::ios::scientific,std::ios::floatfield);
+  std::cout.precision(2);
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "reshape w/ and w/o copy                           " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  Tensor<double,4> x(2,3,4,5); x.generate(std::bind(dist,rGen));
+  const Tensor<double,4>& cx = x;
+
+  {
+    Tensor<double,2> y = reshape(x,shape(6,20));
+    print_extent("reshape(x,shape(6,20))",y.extent());
+    std::cout << " copied " << (y.data() != x.data() ? "yes" : "no ") << ", diff " << max_diff(x,y) << std::endl;
+
+    Tensor<double,3> z = reshape(x,4,5,6);
+    print_extent("reshape(x,4,5,6)",z.extent());
+    std::cout << " copied " << (z.data() != x.data() ? "yes" : "no ") << ", diff " << max_diff(x,z) << std::endl;
+
+    Tensor<double,0> w = reshape(x,std::vector<size_t>{120});
+    print_extent("reshape(x,{120}) (dynamic rank)",w.extent());
+    std::cout << " copied " << (w.data() != x.data() ? "yes" : "no ") << ", diff " << max_diff(x,w) << std::endl;
+
+    Tensor<double,4> t(x);
+    const double* p = t.data();
+    Tensor<double,2> u = reshape(std::move(t),shape(24,5));
+    print_extent("reshape(std::move(x),shape(24,5))",u.extent());
+    std::cout << " copied " << (u.data() != p ? "yes" : "no ") << ", diff " << max_diff(x,u) << ", moved-from size " << t.size() << std::endl;
+
+    u.reshape(5,24);
+    print_extent("x.reshape(5,24)",u.extent());
+    std::cout << " copied " << (u.data() != p ? "yes" : "no ") << ", diff " << max_diff(x,u) << std::endl;
+  }
+
+  {
+    TensorWrapper<double*,2> v = reshape_view(x,shape(6,20));
+    print_extent("reshape_view(x,shape(6,20))",v.extent());
+    std::cout << " copied " << (v.data() != x.data() ? "yes" : "no ") << ", element (1,7) " << ((v(1,7) == x(0,1,1,2)) ? "OK" : "FAILED") << std::endl;
+
+    TensorWrapper<const double*,0> cv = reshape_view(cx,std::vector<size_t>{120});
+    print_extent("reshape_view(x,{120}) (const)",cv.extent());
+    std::cout << " copied " << (cv.data() != x.data() ? "yes" : "no ") << std::endl;
+
+    try {
+      reshape_view(x,shape(7,20));
+      std::cout << "reshape_view(x,shape(7,20))      : not detected" << std::endl;
+    }
+    catch(std::runtime_error& e) {
+      std::cout << "reshape_view(x,shape(7,20))      : " << e.what() << std::endl;
+    }
+  }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "fuse_indices and split_index                      " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  {
+    // matrix multiplication of the fused view is the same as contraction over the original indices
+    TensorWrapper<double*,2> f = fuse_indices(x,{{0,1},{2,3}});
+    print_extent("fuse_indices(x,{{0,1},{2,3}})",f.extent());
+    std::cout << " copied " << (f.data() != x.data() ? "yes" : "no ") << std::endl;
+
+    Tensor<double,4> c4;
+    contract(1.0,x,shape(2,3),x,shape(2,3),0.0,c4);
+    Tensor<double,2> c2(6,6);
+    gemm(CblasNoTrans,CblasTrans,1.0,f,f,0.0,c2);
+    std::cout << "gemm of fused view                : diff " << max_diff(c2,c4) << std::endl;
+
+    TensorWrapper<const double*,3> g = fuse_indices(cx,{{0},{1,2},{3}});
+    print_extent("fuse_indices(x,{{0},{1,2},{3}})",g.extent());
+    std::cout << " element (1,5,3) " << ((g(1,5,3) == x(1,1,1,3)) ? "OK" : "FAILED") << std::endl;
+
+    TensorWrapper<double*,5> s = split_index(x,2,{2,2});
+    print_extent("split_index(x,2,{2,2})",s.extent());
+    std::cout << " element (1,2,1,0,4) " << ((s(1,2,1,0,4) == x(1,2,2,4)) ? "OK" : "FAILED") << std::endl;
+
+    // round trip
+    TensorWrapper<const double*,3> r = split_index(fuse_indices(cx,{{0,1},{2,3}}),1,{4,5});
+    TensorWrapper<const double*,4> q = split_index(r,0,{2,3});
+    print_extent("split of fused x",q.extent());
+    std::cout << " copied " << (q.data() != x.data() ? "yes" : "no ") << ", diff " << max_diff(x,q) << std::endl;
+
+    try {
+      fuse_indices(x,{{0,2},{1,3}});
+      std::cout << "fuse_indices(x,{{0,2},{1,3}})    : not detected" << std::endl;
+    }
+    catch(std::runtime_error& e) {
+      std::cout << "fuse_indices(x,{{0,2},{1,3}})    : " << e.what() << std::endl;
+    }
+  }
+
+  return 0;
+}
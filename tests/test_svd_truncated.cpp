@@ -0,0 +1,149 @@
+#include <iostream>
+#include <iomanip>
+
+#include <cmath>
+#include <random>
+#include <functional>
+#include <algorithm>
+
+#include <btas.h>
+#include <time_stamp.h>
+
+/// max. abs. difference between u * diag(s) * vt and its reference, which are given as matrices
+/// only the leading s.size() singular triplets of the reference are used
+template<class MatrixU, class VectorS, class MatrixVT, class MatrixUR, class VectorSR, class MatrixVTR>
+double max_diff_usv (const MatrixU& u, const VectorS& s, const MatrixVT& vt, const MatrixUR& ur, const VectorSR& sr, const MatrixVTR& vtr)
+{
+  if(u.extent(1) != s.size() || vt.extent(0) != s.size()) return HUGE_VAL;
+  double diff = 0.0;
+  for(size_t i = 0; i < u.extent(0); ++i)
+    for(size_t j = 0; j < vt.extent(1); ++j) {
+      double x = 0.0;
+      double y = 0.0;
+      for(size_t k = 0; k < s.size(); ++k) {
+        x += u(i,k)*s(k)*vt(k,j);
+        y += ur(i,k)*sr(k)*vtr(k,j);
+      }
+      diff = std::max(diff,std::fabs(x-y));
+    }
+  return diff;
+}
+
+/// make a of extent (n0,n1,n2,n3) w/ singular values decaying as exp(-decay*i)
+btas::Tensor<double,4> make_decaying (size_t n0, size_t n1, size_t n2, size_t n3, double decay, std::mt19937& rGen)
+{
+  using namespace btas;
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+  const size_t r = std::min(n0*n1,n2*n3);
+  Tensor<double,3> x(n0,n1,r); x.generate(std::bind(dist,rGen));
+  Tensor<double,3> y(r,n2,n3); y.generate(std::bind(dist,rGen));
+  for(size_t i = 0; i < r; ++i) {
+    double f = std::exp(-decay*i);
+    for(size_t j = 0; j < n2*n3; ++j) y.data()[i*n2*n3+j] *= f;
+  }
+  Tensor<double,4> a;
+  contract(1.0,x,shape(2),y,shape(0),0.0,a);
+  return a;
+}
+
+int main ()
+{
+  using namespace btas;
+
+  std::mt19937 rGen;
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+
+  std::cout.setf(std::ios::scientific,std::ios::floatfield);
+  std::cout.precision(2);
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "gesvd_truncated vs gesvd + truncation by hand     " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  Tensor<double,4> a = make_decaying(10,8,12,10,0.05,rGen);
+
+  Tensor<double,1> sref; Tensor<double,3> uref; Tensor<double,3> vtref;
+  gesvd('S','S',a,sref,uref,vtref);
+
+  const SVDTruncation truncs[] = { {20,0.0,0.0,false}, {0,1.0e-1,0.0,false}, {0,0.0,1.0e-2,false}, {30,0.0,1.0e-2,true}, {0,1.0e+8,0.0,false} };
+  const char* names[] = { "{20,0,0,false}", "{0,1e-1,0,false}", "{0,0,1e-2,false}", "{30,0,1e-2,true}", "{0,1e+8,0,false}" };
+
+  for(size_t t = 0; t < 5; ++t) {
+    Tensor<double,1> s; Tensor<double,3> u; Tensor<double,3> vt;
+    double discarded = gesvd_truncated(a,s,u,vt,truncs[t]);
+    const size_t k = s.size();
+
+    // reference : truncation by hand
+    double kept = 0.0;
+    double dref = 0.0;
+    for(size_t i = 0; i < sref.size(); ++i) (i < k ? kept : dref) += sref(i)*sref(i);
+    Tensor<double,1> sk(k);
+    for(size_t i = 0; i < k; ++i) sk(i) = truncs[t].renormalize ? sref(i)*std::sqrt((kept+dref)/kept) : sref(i);
+
+    auto um = fuse_indices(u,{{0,1},{2}});
+    auto vtm = fuse_indices(vt,{{0},{1,2}});
+    auto urm = fuse_indices(uref,{{0,1},{2}});
+    auto vtrm = fuse_indices(vtref,{{0},{1,2}});
+
+    double snorm = 0.0; for(size_t i = 0; i < k; ++i) snorm += s(i)*s(i);
+
+    std::cout << std::setw(18) << std::left << names[t] << " : rank " << std::setw(3) << k
+              << " [" << u.extent(2) << "," << vt.extent(0) << "], discarded " << discarded << " (" << dref << ")"
+              << ", diff " << max_diff_usv(um,s,vtm,urm,sk,vtrm) << ", norm^2 " << snorm << std::endl;
+  }
+
+  // column-major
+  {
+    Tensor<double,2,CblasColMajor> b(30,20); b.generate(std::bind(dist,rGen));
+    Tensor<double,1,CblasColMajor> s; Tensor<double,2,CblasColMajor> u; Tensor<double,2,CblasColMajor> vt;
+    Tensor<double,1,CblasColMajor> sr; Tensor<double,2,CblasColMajor> ur; Tensor<double,2,CblasColMajor> vtr;
+    gesvd('S','S',b,sr,ur,vtr);
+    double discarded = gesvd_truncated(b,s,u,vt,{8,0.0,0.0,false});
+    double dref = 0.0; for(size_t i = 8; i < sr.size(); ++i) dref += sr(i)*sr(i);
+    std::cout << std::setw(18) << std::left << "column-major" << " : rank " << std::setw(3) << s.size()
+              << " [" << u.extent(1) << "," << vt.extent(0) << "], discarded " << discarded << " (" << dref << ")"
+              << ", diff " << max_diff_usv(u,s,vt,ur,sr,vtr) << std::endl;
+  }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "benchmark : truncation to rank 100                " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  std::cout.setf(std::ios::fixed,std::ios::floatfield);
+  std::cout.precision(6);
+
+  {
+    // two-site wavefunction of bond dimension 200 and local dimension 4
+    Tensor<double,4> x(200,4,4,200); x.generate(std::bind(dist,rGen));
+    const size_t nrep = 3;
+
+    time_stamp ts;
+
+    for(size_t r = 0; r < nrep; ++r) {
+      Tensor<double,1> s; Tensor<double,3> u; Tensor<double,3> vt;
+      gesvd('S','S',x,s,u,vt);
+      // truncation by hand
+      Tensor<double,1> sk(shape(100)); Tensor<double,3> uk(200,4,100); Tensor<double,3> vtk(100,4,200);
+      for(size_t i = 0; i < 100; ++i) sk(i) = s(i);
+      for(size_t i = 0; i < 800; ++i) std::copy(u.data()+i*800,u.data()+i*800+100,uk.data()+i*100);
+      std::copy(vt.data(),vt.data()+vtk.size(),vtk.data());
+    }
+
+    double t_gesvd = ts.lap()/nrep;
+
+    for(size_t r = 0; r < nrep; ++r) {
+      Tensor<double,1> s; Tensor<double,3> u; Tensor<double,3> vt;
+      gesvd_truncated(x,s,u,vt,{100,0.0,0.0,false});
+    }
+
+    double t_trunc = ts.lap()/nrep;
+
+    std::cout << "(800 x 800) : gesvd + truncation " << t_gesvd << ", gesvd_truncated " << t_trunc << std::endl;
+  }
+
+  return 0;
+}
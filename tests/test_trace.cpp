@@ -0,0 +1,147 @@
+#include <iostream>
+#include <iomanip>
+
+#include <cmath>
+#include <random>
+#include <functional>
+#include <algorithm>
+
+#include <btas.h>
+#include <max_diff.h>
+#include <time_stamp.h>
+
+int main ()
+{
+  using namespace btas;
+
+  std::mt19937 rGen;
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+
+  std::cout.setf(std::ios::scientific,std::ios::floatfield);
+  std::cout.precision(2);
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "partial_trace(X,pairs,Y)                          " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  Tensor<double,4> A(6,5,6,7); A.generate(std::bind(dist,rGen));
+
+  // B(j,l) = A(i,j,i,l)
+  Tensor<double,2> B;
+  partial_trace(A,{{0,2}},B);
+
+  Tensor<double,2> Bref(5,7); Bref.fill(0.0);
+  for(size_t i = 0; i < 6; ++i)
+    for(size_t j = 0; j < 5; ++j)
+      for(size_t l = 0; l < 7; ++l) Bref(j,l) += A(i,j,i,l);
+
+  std::cout << "B(j,l)   : " << max_diff(B,Bref) << std::endl;
+
+  // same as tie + sum
+  Tensor<double,3> Atie;
+  tie(A,shape(0,1,0,2),Atie);
+  Tensor<double,2> Btie(5,7); Btie.fill(0.0);
+  for(size_t i = 0; i < 6; ++i)
+    for(size_t j = 0; j < 5; ++j)
+      for(size_t l = 0; l < 7; ++l) Btie(j,l) += Atie(i,j,l);
+
+  std::cout << "B(j,l)   : " << max_diff(B,Btie) << " (tie)" << std::endl;
+
+  // C = 2 * A(i,j,i,l) + 0.5 * C, col-major
+  Tensor<double,4,CblasColMajor> Ac(6,5,6,7); Ac.generate(std::bind(dist,rGen));
+  Tensor<double,2,CblasColMajor> C(5,7); C.generate(std::bind(dist,rGen));
+  Tensor<double,2,CblasColMajor> Cref(5,7);
+  for(size_t j = 0; j < 5; ++j)
+    for(size_t l = 0; l < 7; ++l) {
+      Cref(j,l) = 0.5*C(j,l);
+      for(size_t i = 0; i < 6; ++i) Cref(j,l) += 2.0*Ac(i,j,i,l);
+    }
+  partial_trace(2.0,Ac,{{0,2}},0.5,C);
+
+  std::cout << "C(j,l)   : " << max_diff(C,Cref) << std::endl;
+
+  // full trace, s = A(i,j,i,j) of a square tensor
+  Tensor<double,4> S(6,5,6,5); S.generate(std::bind(dist,rGen));
+  double sref = 0.0;
+  for(size_t i = 0; i < 6; ++i)
+    for(size_t j = 0; j < 5; ++j) sref += S(i,j,i,j);
+
+  std::cout << "s        : " << std::fabs(trace(S,{{0,2},{1,3}})-sref) << std::endl;
+
+  Tensor<double,0> Sd;
+  partial_trace(S,{{2,0},{1,3}},Sd);
+
+  std::cout << "s        : " << std::fabs(Sd.data()[0]-sref) << " extent {" << Sd.extent(0) << "}" << std::endl;
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "partial_trace of TensorView                       " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  // D(j) = A(1:4,j,2:5,3), i.e. trace of a slice
+  TensorView<const double*,4> Av(A.data()+A.ordinal(shape(1,0,2,3)),shape(4,5,4,1),A.stride());
+
+  Tensor<double,2> D;
+  partial_trace(Av,{{0,2}},D);
+
+  Tensor<double,2> Dref(5,1); Dref.fill(0.0);
+  for(size_t i = 0; i < 4; ++i)
+    for(size_t j = 0; j < 5; ++j) Dref(j,0) += A(1+i,j,2+i,3);
+
+  std::cout << "D(j)     : " << max_diff(D,Dref) << std::endl;
+
+  double tref = 0.0;
+  for(size_t i = 0; i < 4; ++i)
+    for(size_t j = 0; j < 4; ++j) tref += S(1+i,j,1+i,j);
+
+  TensorView<const double*,4> Sv(S.data()+S.ordinal(shape(1,0,1,0)),shape(4,4,4,4),S.stride());
+
+  std::cout << "t        : " << std::fabs(trace(Sv,{{0,2},{1,3}})-tref) << std::endl;
+
+  // same of dynamic rank
+  Tensor<double,0> S0(std::vector<size_t>{6,5,6,5});
+  std::copy(S.data(),S.data()+S.size(),S0.data());
+  TensorView<const double*,0> Sv0(S0.data()+S0.ordinal(std::vector<size_t>{1,0,1,0}),std::vector<size_t>{4,4,4,4},S0.stride());
+
+  std::cout << "t        : " << std::fabs(trace(Sv0,{{0,2},{1,3}})-tref) << " (dynamic rank)" << std::endl;
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "reduced density matrix, rho(i,k) = Psi(i,j,k,j)   " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  const size_t nrep = 10;
+
+  Tensor<double,4> Psi(64,64,64,64); Psi.generate(std::bind(dist,rGen));
+
+  time_stamp ts;
+
+  Tensor<double,2> rho;
+  for(size_t r = 0; r < nrep; ++r) partial_trace(Psi,{{1,3}},rho);
+
+  double t_trace = ts.lap();
+
+  Tensor<double,2> rhoref;
+  for(size_t r = 0; r < nrep; ++r) {
+    Tensor<double,3> Ptie;
+    tie(Psi,shape(0,1,2,1),Ptie);
+    rhoref.resize(64,64); rhoref.fill(0.0);
+    for(size_t i = 0; i < 64; ++i)
+      for(size_t j = 0; j < 64; ++j)
+        for(size_t k = 0; k < 64; ++k) rhoref(i,k) += Ptie(i,j,k);
+  }
+
+  double t_tie = ts.lap();
+
+  std::cout << "rho(i,k) : " << max_diff(rho,rhoref) << std::endl;
+
+  std::cout.setf(std::ios::fixed,std::ios::floatfield);
+  std::cout.precision(6);
+  std::cout << "time     : partial_trace " << t_trace << ", tie + sum " << t_tie << std::endl;
+
+  return 0;
+}
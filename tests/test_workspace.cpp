@@ -0,0 +1,130 @@
+#include <iostream>
+#include <iomanip>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <functional>
+
+#include <btas.h>
+#include <time_stamp.h>
+
+/// contractions and decompositions of a sweep, all of which take temporaries from Workspace
+void sweep (
+  const btas::Tensor<double,3>& a, const btas::Tensor<double,3>& b, const btas::Tensor<double,0>& x,
+  btas::Tensor<double,4>& c, btas::Tensor<double,2>& d, btas::Tensor<double,0>& y,
+  btas::Tensor<double,1>& s, btas::Tensor<double,2>& u, btas::Tensor<double,3>& vt)
+{
+  using namespace btas;
+  // c(i,k,l,m) = a(j,i,k) * b(l,j,m), a and b are permuted (contract_helper)
+  contract(1.0,a,shape(0),b,shape(1),0.0,c);
+  // d(m,i) = a(j,i,k) * b(k,j,m), a*b is permuted into d (ContractPlan)
+  contract(1.0,a,make_array('j','i','k'),b,make_array('k','j','m'),0.0,d,make_array('m','i'));
+  // y(j,i) = x(i,k,j) * x(i,k,j) w/ batch indices i and j (ContractPlan of dynamic rank)
+  contract(1.0,x,make_array(0,1,2),x,make_array(0,1,2),0.0,y,make_array(2,0));
+  // SVD copies a into workspace
+  gesvd('S','S',a,s,u,vt);
+}
+
+int main ()
+{
+  using namespace btas;
+
+  std::mt19937 rGen;
+  std::uniform_real_distribution<double> dist(-1.0,1.0);
+
+  std::cout.setf(std::ios::fixed,std::ios::floatfield);
+  std::cout.precision(6);
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "Workspace : scopes, high-water mark and regrowth  " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  {
+    Workspace ws;
+    for(size_t r = 0; r < 2; ++r) {
+      Workspace::Scope outer(ws);
+      double* p = outer.allocate<double>(1000);
+      {
+        Workspace::Scope inner(ws);
+        double* q = inner.allocate<double>(512);
+        std::cout << "round " << r << " : aligned " << ((reinterpret_cast<std::uintptr_t>(p)%Workspace::alignment == 0 &&
+                                                         reinterpret_cast<std::uintptr_t>(q)%Workspace::alignment == 0) ? "yes" : "no ")
+                  << ", used " << ws.used() << " (12096), high-water " << ws.high_water() << " (12096)";
+      }
+      std::cout << ", used after inner scope " << ws.used() << " (8000)" << std::endl;
+    }
+    // heap allocations: 2 temporaries overflowed and the buffer regrown in round 0, none in round 1
+    std::cout << "capacity " << ws.capacity() << " (12096), heap allocations " << ws.heap_allocations() << " (3)" << std::endl;
+  }
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "sweep w/ thread-local Workspace                   " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  Tensor<double,3> a(40,30,20); a.generate(std::bind(dist,rGen));
+  Tensor<double,3> b(20,40,10); b.generate(std::bind(dist,rGen));
+  Tensor<double,0> x(std::vector<size_t>{10,20,30}); x.generate(std::bind(dist,rGen));
+  Tensor<double,4> c;
+  Tensor<double,2> d;
+  Tensor<double,0> y;
+  Tensor<double,1> s; Tensor<double,2> u; Tensor<double,3> vt;
+
+  Workspace& ws = Workspace::local();
+
+  // dry run to measure the high-water mark
+  sweep(a,b,x,c,d,y,s,u,vt);
+  const size_t bytes = ws.high_water();
+  std::cout << "dry run             : high-water " << bytes << " bytes, heap allocations " << ws.heap_allocations() << std::endl;
+
+  Tensor<double,4> cref(c);
+  Tensor<double,2> dref(d);
+  Tensor<double,0> yref(y);
+
+  const size_t nsweep = 20;
+  size_t nalloc = ws.heap_allocations();
+
+  for(size_t r = 0; r < nsweep; ++r) sweep(a,b,x,c,d,y,s,u,vt);
+
+  std::cout << "repeated sweeps     : heap allocations " << ws.heap_allocations()-nalloc << " (0)" << std::endl;
+
+  // pre-size a fresh workspace from the dry run
+  ws.release();
+  nalloc = ws.heap_allocations();
+  ws.reserve(bytes);
+
+  for(size_t r = 0; r < nsweep; ++r) sweep(a,b,x,c,d,y,s,u,vt);
+
+  std::cout << "pre-sized workspace : heap allocations " << ws.heap_allocations()-nalloc << " (1, by reserve)" << std::endl;
+
+  double diff = 0.0;
+  for(size_t i = 0; i < c.size(); ++i) diff = std::max(diff,std::fabs(c.data()[i]-cref.data()[i]));
+  for(size_t i = 0; i < d.size(); ++i) diff = std::max(diff,std::fabs(d.data()[i]-dref.data()[i]));
+  for(size_t i = 0; i < y.size(); ++i) diff = std::max(diff,std::fabs(y.data()[i]-yref.data()[i]));
+  std::cout << "diff from dry run   : " << std::scientific << std::setprecision(2) << diff << std::fixed << std::setprecision(6) << std::endl;
+
+  // ----------------------------------------------------------------------------------------------------
+
+  std::cout << "--------------------------------------------------" << std::endl;
+  std::cout << "benchmark : reused vs released workspace          " << std::endl;
+  std::cout << "--------------------------------------------------" << std::endl;
+
+  time_stamp ts;
+
+  for(size_t r = 0; r < nsweep; ++r) sweep(a,b,x,c,d,y,s,u,vt);
+
+  double t_reused = ts.lap()/nsweep;
+
+  // releasing the buffer before each sweep emulates allocation of temporaries per call
+  for(size_t r = 0; r < nsweep; ++r) { ws.release(); sweep(a,b,x,c,d,y,s,u,vt); }
+
+  double t_released = ts.lap()/nsweep;
+
+  std::cout << "sweep : reused " << t_reused << ", released " << t_released << std::endl;
+
+  return 0;
+}